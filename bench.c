@@ -0,0 +1,665 @@
+/*-------------------------------------------------------------------
+*  bench.c:        throughput benchmark of the cip operations
+*
+*  Description:    Runs what cip does for -ef, -df, -tf, -be, -bd
+*                  and -u over synthetic files of fixed sizes and
+*                  prints, per operation, size and cache state, the
+*                  MB/s, cycles per byte, peak RSS and read/write
+*                  syscall counts as JSON. Every run is made in a
+*                  child process, so the RSS and the counts are its
+*                  own and a die() inside cip ends only that run.
+*
+*                  The files are made from a fixed seed and kept in
+*                  the -dir directory, so two runs of the same build
+*                  see the same bytes and their output can be diffed.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+	#define BENCH_HAS_TSC
+#endif
+
+#include "include/cip.h"
+#include "include/hash.h"
+#include "include/nutsbox.h"
+#include "include/uuid4.h"
+#include "include/base64.h"
+#include "include/cipher.h"
+#include "include/hpar.h"
+
+
+#define BENCH_DEFAULT_SIZES "1K,64K,1M,64M"
+#define BENCH_DEFAULT_DIR "/tmp/cipbench"
+#define BENCH_DEFAULT_REPS 3
+#define BENCH_MAX_SIZES 16
+#define BENCH_MAX_REPS 64
+#define BENCH_KEY "cipbench"
+#define BENCH_UUIDS_PER_KB 16          /* uuid4 calls per KB of "size" */
+#define BENCH_MAX_UUIDS (256 * 1024)
+#define BENCH_SEED 0x9e3779b97f4a7c15ULL
+
+
+/* what an operation reads */
+enum { IN_PLAIN, IN_GCM, IN_CTR, IN_B64, IN_NONE };
+
+/* one operation, run through the same entry point as cip */
+typedef struct {
+	const char *name;
+	int input;
+	const char *arg;               /* cipher format or hash name */
+} bench_op;
+
+static const bench_op ops[] = {
+	{ "encrypt-gcm",  IN_PLAIN, "gcm"         },
+	{ "encrypt-ctr",  IN_PLAIN, "ctr"         },
+	{ "decrypt-gcm",  IN_GCM,   "gcm"         },
+	{ "decrypt-ctr",  IN_CTR,   "ctr"         },
+	{ "hash-sha3-256",IN_PLAIN, "sha3-256"    },
+	{ "hash-sha256",  IN_PLAIN, "sha256"      },
+	{ "hash-blake3",  IN_PLAIN, "blake3"      },
+	{ "b64-encode",   IN_PLAIN, NULL          },
+	{ "b64-decode",   IN_B64,   NULL          },
+	{ "uuid4",        IN_NONE,  NULL          },
+};
+
+/* what a child reports back about a run */
+typedef struct {
+	int ok;
+	double seconds;
+	unsigned long long cycles;
+	unsigned long long syscr, syscw;
+} bench_sample;
+
+/* a run as seen by the parent */
+typedef struct {
+	bench_sample s;
+	long maxrss_kb;
+	long majflt;
+} bench_run;
+
+static char dir[512] = BENCH_DEFAULT_DIR;
+static int reps = BENCH_DEFAULT_REPS;
+static int threads = 1;
+
+
+/*----------------------------------------------------------
+*  Function:    static void usage(int status)
+*
+*  Description: Prints the options and exits
+*
+*---------------------------------------------------------*/
+static void usage(int status)
+{
+	fprintf(status ? stderr : stdout,
+		"usage: cipbench [-sizes list] [-ops list] [-reps n] [-j n] [-dir path] [-hot | -cold]\n"
+		"  -sizes  comma separated sizes with K, M or G (default " BENCH_DEFAULT_SIZES ")\n"
+		"  -ops    comma separated operations (default all):\n"
+		"          encrypt-gcm encrypt-ctr decrypt-gcm decrypt-ctr hash-sha3-256\n"
+		"          hash-sha256 hash-blake3 b64-encode b64-decode uuid4\n"
+		"  -reps   runs per result, the median is reported (default %d)\n"
+		"  -j      threads for encryption, decryption and blake3 (default 1)\n"
+		"  -dir    where the input files are made and kept (default " BENCH_DEFAULT_DIR ")\n"
+		"  -hot    only measure with the input in the page cache\n"
+		"  -cold   only measure with the input dropped from the page cache\n",
+		BENCH_DEFAULT_REPS);
+	exit(status);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static double now(void)
+*
+*  Returns:     seconds on the monotonic clock
+*
+*---------------------------------------------------------*/
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static unsigned long long cycles(void)
+*
+*  Returns:     the time stamp counter, 0 where there is none
+*
+*---------------------------------------------------------*/
+static unsigned long long cycles(void)
+{
+#ifdef BENCH_HAS_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static void syscalls(unsigned long long *r,
+*                                    unsigned long long *w)
+*
+*  Description: Reads the read and write syscall counts of
+*               this process from /proc/self/io. They count
+*               the read and write families (pread, readv,
+*               sendfile and the like), not mmap or the page
+*               faults a mapped file is read through.
+*
+*  On Entry:    r, w = where the counts go, 0 if unknown
+*
+*---------------------------------------------------------*/
+static void syscalls(unsigned long long *r, unsigned long long *w)
+{
+	char line[128];
+	FILE *f = fopen("/proc/self/io", "r");
+
+	*r = *w = 0;
+	if (!f) return;
+	while (fgets(line, sizeof(line), f)) {
+		sscanf(line, "syscr: %llu", r);
+		sscanf(line, "syscw: %llu", w);
+	}
+	fclose(f);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static void path(char *buf, size_t len,
+*                                unsigned long long size,
+*                                int input)
+*
+*  Description: Names the input file of the given size and kind
+*
+*---------------------------------------------------------*/
+static void path(char *buf, size_t len, unsigned long long size, int input)
+{
+	static const char *ext[] = { "bin", "gcm", "ctr", "b64" };
+	snprintf(buf, len, "%s/corpus-%llu.%s", dir, size, ext[input]);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static void scratch(char *buf, size_t len)
+*
+*  Description: Names the file the output of a run goes to.
+*               Not /dev/null: a failed decryption removes it.
+*
+*---------------------------------------------------------*/
+static void scratch(char *buf, size_t len)
+{
+	snprintf(buf, len, "%s/out.%d", dir, (int) getpid());
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static unsigned long long uuids(
+*                                  unsigned long long size)
+*
+*  Returns:     how many uuid4 calls stand for the size
+*
+*---------------------------------------------------------*/
+static unsigned long long uuids(unsigned long long size)
+{
+	unsigned long long n = size / 1024 * BENCH_UUIDS_PER_KB;
+	if (n > BENCH_MAX_UUIDS) n = BENCH_MAX_UUIDS;
+	return n ? n : 1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static void run_op(const bench_op *op,
+*                                  unsigned long long size)
+*
+*  Description: Does the operation once, the way main.c does
+*               it for the matching option
+*
+*---------------------------------------------------------*/
+static void run_op(const bench_op *op, unsigned long long size)
+{
+	char in[600], out[600];
+	krypt_opts kopts = { 0, 1, KRYPT_AUTO, 0, -1 };
+	unsigned long long i, n;
+	char uuid[UUID4_LEN];
+
+	kopts.threads = threads;
+	path(in, sizeof(in), size, op->input == IN_NONE ? IN_PLAIN : op->input);
+	scratch(out, sizeof(out));
+
+	switch (op->input) {
+	case IN_PLAIN:
+		if (strncmp(op->name, "encrypt", 7) == 0) {
+			kopts.aead = strcmp(op->arg, "gcm") == 0 ? KSEAL_GCM : KRYPT_CTR;
+			krypt(true, true, in, out, DEFAULT_CIPHER, BENCH_KEY, DEFAULT_HASH, &kopts);
+		}
+		else if (op->arg && strcmp(op->arg, "blake3") == 0) {
+			unsigned char digest[HPAR_OUTLEN];
+			hpar_file(in, threads, digest);
+		}
+		else if (op->arg) hash(in, (char *) op->arg, true, NULL);
+		else base64(true, true, (unsigned char *) in, out);
+		break;
+	case IN_GCM:
+	case IN_CTR:
+		krypt(true, false, in, out, DEFAULT_CIPHER, BENCH_KEY, DEFAULT_HASH, &kopts);
+		break;
+	case IN_B64:
+		base64(true, false, (unsigned char *) in, out);
+		break;
+	case IN_NONE:
+		/* -u seeds once per call, so this is one cip -u per uuid */
+		n = uuids(size);
+		for (i = 0; i < n; i++) {
+			uuid4_init();
+			uuid4_generate(uuid);
+		}
+		break;
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static int measure(const bench_op *op,
+*                                  unsigned long long size,
+*                                  bench_run *run)
+*
+*  Description: Runs the operation once in a child process,
+*               which times itself and sends the sample over a
+*               pipe; the RSS and fault counts come from wait4
+*
+*  Returns:     0 if the run finished, -1 otherwise
+*
+*---------------------------------------------------------*/
+static int measure(const bench_op *op, unsigned long long size, bench_run *run)
+{
+	int fd[2], status;
+	struct rusage ru;
+	char out[600];
+	pid_t pid;
+	ssize_t got;
+
+	memset(run, 0, sizeof(*run));
+	if (pipe(fd) != 0) return -1;
+	fflush(stdout);
+
+	pid = fork();
+	if (pid < 0) {
+		close(fd[0]);
+		close(fd[1]);
+		return -1;
+	}
+	if (pid == 0) {
+		bench_sample s;
+		unsigned long long r0, w0, c0;
+		double t0;
+
+		close(fd[0]);
+		/* cip prints its results to stdout, keep them out of the JSON */
+		if (freopen("/dev/null", "w", stdout) == NULL) _exit(1);
+
+		syscalls(&r0, &w0);
+		c0 = cycles();
+		t0 = now();
+		run_op(op, size);
+		s.seconds = now() - t0;
+		s.cycles = cycles() - c0;
+		syscalls(&s.syscr, &s.syscw);
+		s.syscr -= r0;
+		s.syscw -= w0;
+		s.ok = 1;
+
+		got = write(fd[1], &s, sizeof(s));
+		_exit(got == (ssize_t) sizeof(s) ? 0 : 1);
+	}
+
+	close(fd[1]);
+	got = read(fd[0], &run->s, sizeof(run->s));
+	close(fd[0]);
+	while (wait4(pid, &status, 0, &ru) < 0 && errno == EINTR) ;
+
+	/* the scratch file is the child's, named after its pid */
+	snprintf(out, sizeof(out), "%s/out.%d", dir, (int) pid);
+	unlink(out);
+
+	if (got != (ssize_t) sizeof(run->s) || !run->s.ok) return -1;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+
+#if defined(__APPLE__)
+	run->maxrss_kb = ru.ru_maxrss / 1024;      /* bytes there */
+#else
+	run->maxrss_kb = ru.ru_maxrss;
+#endif
+	run->majflt = ru.ru_majflt;
+	return 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static void drop_cache(const char *name)
+*
+*  Description: Writes back and drops the file's pages from
+*               the page cache, so the next read of it goes to
+*               the disk
+*
+*---------------------------------------------------------*/
+static void drop_cache(const char *name)
+{
+	int fd = open(name, O_RDONLY);
+
+	if (fd < 0) return;
+	fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+	close(fd);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static long long file_size(const char *name)
+*
+*  Returns:     the size of the file, -1 if it is not there
+*
+*---------------------------------------------------------*/
+static long long file_size(const char *name)
+{
+	struct stat st;
+	return stat(name, &st) == 0 ? (long long) st.st_size : -1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static int make_plain(unsigned long long size)
+*
+*  Description: Writes the plain input of the given size from
+*               a xorshift64 stream with a fixed seed, unless
+*               a file of that size is already there
+*
+*  Returns:     0 on success, -1 otherwise
+*
+*---------------------------------------------------------*/
+static int make_plain(unsigned long long size)
+{
+	char name[600];
+	static uint64_t buf[128 * 1024];
+	uint64_t x = BENCH_SEED;
+	unsigned long long left = size;
+	FILE *f;
+	size_t i, n;
+
+	path(name, sizeof(name), size, IN_PLAIN);
+	if (file_size(name) == (long long) size) return 0;
+
+	if ((f = fopen(name, "wb")) == NULL) return -1;
+	while (left) {
+		for (i = 0; i < sizeof(buf) / sizeof(buf[0]); i++) {
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+			buf[i] = x;
+		}
+		n = left < sizeof(buf) ? (size_t) left : sizeof(buf);
+		if (fwrite(buf, 1, n, f) != n) {
+			fclose(f);
+			return -1;
+		}
+		left -= n;
+	}
+	return fclose(f) == 0 ? 0 : -1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static int make_derived(unsigned long long size,
+*                                       int input)
+*
+*  Description: Makes the input a decryption or decoding run
+*               reads, by encrypting or encoding the plain file
+*               in a child process. It is made again every time,
+*               the IV and salt being random.
+*
+*  Returns:     0 on success, -1 otherwise
+*
+*---------------------------------------------------------*/
+static int make_derived(unsigned long long size, int input)
+{
+	char in[600], out[600];
+	krypt_opts kopts = { 0, 1, KRYPT_AUTO, 0, -1 };
+	int status;
+	pid_t pid;
+
+	path(in, sizeof(in), size, IN_PLAIN);
+	path(out, sizeof(out), size, input);
+
+	fflush(stdout);
+	if ((pid = fork()) < 0) return -1;
+	if (pid == 0) {
+		if (freopen("/dev/null", "w", stdout) == NULL) _exit(1);
+		kopts.threads = threads;
+		if (input == IN_B64) base64(true, true, (unsigned char *) in, out);
+		else {
+			kopts.aead = input == IN_GCM ? KSEAL_GCM : KRYPT_CTR;
+			krypt(true, true, in, out, DEFAULT_CIPHER, BENCH_KEY, DEFAULT_HASH, &kopts);
+		}
+		_exit(0);
+	}
+	while (waitpid(pid, &status, 0) < 0 && errno == EINTR) ;
+	return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static int by_seconds(const void *a,
+*                                     const void *b)
+*
+*  Description: qsort() comparison of runs by their time
+*
+*---------------------------------------------------------*/
+static int by_seconds(const void *a, const void *b)
+{
+	double x = ((const bench_run *) a)->s.seconds;
+	double y = ((const bench_run *) b)->s.seconds;
+	return (x > y) - (x < y);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static void report(const bench_op *op,
+*                                  unsigned long long size,
+*                                  const char *cache,
+*                                  bench_run *runs, int n,
+*                                  bool *first)
+*
+*  Description: Prints one result as a JSON object. The time,
+*               cycles and syscalls are those of the median
+*               run, the RSS the largest of all runs. The rate
+*               of uuid4 is in bytes of uuid text made.
+*
+*---------------------------------------------------------*/
+static void report(const bench_op *op, unsigned long long size, const char *cache, bench_run *runs, int n, bool *first)
+{
+	unsigned long long bytes = size;
+	bench_run *m;
+	long rss = 0;
+	double mbs;
+	int i;
+
+	qsort(runs, n, sizeof(runs[0]), by_seconds);
+	m = &runs[n / 2];
+	for (i = 0; i < n; i++) if (runs[i].maxrss_kb > rss) rss = runs[i].maxrss_kb;
+	if (op->input == IN_NONE) bytes = uuids(size) * (UUID4_LEN - 1);
+	mbs = m->s.seconds > 0 ? bytes / m->s.seconds / 1e6 : 0;
+
+	printf("%s\n    { \"op\": \"%s\", \"size\": %llu, \"cache\": \"%s\", \"reps\": %d,",
+		*first ? "" : ",", op->name, size, cache, n);
+	printf(" \"seconds\": %.6f, \"seconds_min\": %.6f, \"mb_s\": %.2f,",
+		m->s.seconds, runs[0].s.seconds, mbs);
+	if (m->s.cycles) printf(" \"cycles_per_byte\": %.3f,", (double) m->s.cycles / bytes);
+	else printf(" \"cycles_per_byte\": null,");
+	printf(" \"peak_rss_kb\": %ld, \"major_faults\": %ld, \"syscalls_read\": %llu, \"syscalls_write\": %llu }",
+		rss, m->majflt, m->s.syscr, m->s.syscw);
+	*first = false;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static int bench(const bench_op *op,
+*                                unsigned long long size,
+*                                bool cold, bool *first)
+*
+*  Description: Measures one operation on one size, either
+*               after a warm-up run or with its input dropped
+*               from the page cache before every run
+*
+*  Returns:     0 on success, -1 if a run failed
+*
+*---------------------------------------------------------*/
+static int bench(const bench_op *op, unsigned long long size, bool cold, bool *first)
+{
+	bench_run runs[BENCH_MAX_REPS], warm;
+	char in[600];
+	int i;
+
+	path(in, sizeof(in), size, op->input == IN_NONE ? IN_PLAIN : op->input);
+
+	if (!cold && measure(op, size, &warm) != 0) return -1;
+	for (i = 0; i < reps; i++) {
+		if (cold) drop_cache(in);
+		if (measure(op, size, &runs[i]) != 0) return -1;
+	}
+	report(op, size, cold ? "cold" : "hot", runs, reps, first);
+	return 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    static bool listed(const char *list,
+*                                  const char *name)
+*
+*  Returns:     true if name is an item of the comma separated
+*               list, or the list is NULL
+*
+*---------------------------------------------------------*/
+static bool listed(const char *list, const char *name)
+{
+	size_t n = strlen(name);
+	const char *p = list;
+
+	if (!list) return true;
+	while (p && *p) {
+		if (strncmp(p, name, n) == 0 && (p[n] == ',' || p[n] == '\0')) return true;
+		p = strchr(p, ',');
+		if (p) p++;
+	}
+	return false;
+}
+
+
+int main(int argc, char *argv[])
+{
+	unsigned long long sizes[BENCH_MAX_SIZES];
+	const char *sizelist = BENCH_DEFAULT_SIZES, *oplist = NULL;
+	bool hot = true, cold = true, first = true;
+	int nsizes = 0, i, j, k, rc = 0;
+	struct stat st;
+	char buf[600];
+
+	for (i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+		if (strcmp(argv[i], "-sizes") == 0 && more) sizelist = argv[++i];
+		else if (strcmp(argv[i], "-ops") == 0 && more) oplist = argv[++i];
+		else if (strcmp(argv[i], "-reps") == 0 && more) reps = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-j") == 0 && more) threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-dir") == 0 && more) snprintf(dir, sizeof(dir), "%s", argv[++i]);
+		else if (strcmp(argv[i], "-hot") == 0) cold = false;
+		else if (strcmp(argv[i], "-cold") == 0) hot = false;
+		else if (strcmp(argv[i], "-h") == 0) usage(EXIT_SUCCESS);
+		else usage(EXIT_FAILURE);
+	}
+	if (reps < 1 || reps > BENCH_MAX_REPS || threads < 1 || (!hot && !cold)) usage(EXIT_FAILURE);
+
+	/* sizes take the suffixes -chunk does */
+	{
+		const char *p = sizelist;
+		while (*p) {
+			size_t n = strcspn(p, ",");
+			snprintf(buf, sizeof(buf), "%.*s", (int) n, p);
+			if (nsizes == BENCH_MAX_SIZES || (sizes[nsizes] = strtosize(buf)) == 0) usage(EXIT_FAILURE);
+			nsizes++;
+			p += n;
+			if (*p) p++;
+		}
+	}
+	for (k = 0; k < (int) acount(ops) && !listed(oplist, ops[k].name); k++) ;
+	if (k == (int) acount(ops)) usage(EXIT_FAILURE);
+
+	if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+		fprintf(stderr, "cipbench: cannot make %s: %s\n", dir, strerror(errno));
+		return EXIT_FAILURE;
+	}
+	if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+		fprintf(stderr, "cipbench: %s is not a directory\n", dir);
+		return EXIT_FAILURE;
+	}
+
+	printf("{\n  \"cip\": \"%s\", \"platform\": \"%s\", \"cpus\": %d, \"threads\": %d,",
+		APP_VERSION, get_platform_name(), numcpus(), threads);
+	printf(" \"cycles\": \"%s\",\n  \"results\": [", cycles() ? "tsc" : "none");
+
+	for (j = 0; j < nsizes; j++) {
+		int made[IN_NONE] = { 0 };
+
+		if (make_plain(sizes[j]) != 0) {
+			fprintf(stderr, "cipbench: cannot make the %llu byte input\n", sizes[j]);
+			rc = EXIT_FAILURE;
+			continue;
+		}
+		for (k = 0; k < (int) acount(ops); k++) {
+			const bench_op *op = &ops[k];
+
+			if (!listed(oplist, op->name)) continue;
+			if (op->input != IN_NONE && op->input != IN_PLAIN && !made[op->input]) {
+				if (make_derived(sizes[j], op->input) != 0) {
+					fprintf(stderr, "cipbench: cannot make the input of %s\n", op->name);
+					rc = EXIT_FAILURE;
+					continue;
+				}
+				made[op->input] = 1;
+			}
+			if (hot && bench(op, sizes[j], false, &first) != 0) {
+				fprintf(stderr, "cipbench: %s failed on %llu bytes\n", op->name, sizes[j]);
+				rc = EXIT_FAILURE;
+			}
+			/* uuid4 reads no input, a cold run would be the same */
+			if (cold && op->input != IN_NONE && bench(op, sizes[j], true, &first) != 0) {
+				fprintf(stderr, "cipbench: %s failed on %llu bytes\n", op->name, sizes[j]);
+				rc = EXIT_FAILURE;
+			}
+		}
+		for (k = IN_GCM; k < IN_NONE; k++) {
+			path(buf, sizeof(buf), sizes[j], k);
+			unlink(buf);
+		}
+	}
+	printf("\n  ]\n}\n");
+	return rc;
+}
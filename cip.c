@@ -179,7 +179,11 @@ void help(void)
 	fprintf(stdout, " encrypts, decrypts and hashes key for a given string or file\n");
 	fprintf(stdout, "\n");
 	fprintf(stdout, " -s   <string>\t\tthe string to encrypt, decrypt or to hash\n");
-	fprintf(stdout, " -f   <filename>\tthe file to encrypt, decrypt or to hash\n");
+	fprintf(stdout, " -f   <filename>\tthe file to encrypt, decrypt or to hash. -tf takes\n");
+	fprintf(stdout, "\t\t\tmore than one, e.g., -f a.txt b.txt c.txt\n");
+	fprintf(stdout, " --files-from <list>\tfiles to hash (-tf) listed one per line in <list>,\n");
+	fprintf(stdout, "\t\t\t'-' reads the list from stdin\n");
+	fprintf(stdout, " -0\t\t\tthe --files-from list is NUL separated (find -print0)\n");
 	fprintf(stdout, "\n");
 	fprintf(stdout, " -t*  [algorithm]\twhere '*' should be replaced by 's' or 'f'\n");
 	fprintf(stdout, "\t\t\tperforms hash on given string (-ts) or filename (-tf)\n");
@@ -189,7 +193,25 @@ void help(void)
 	fprintf(stdout, "\t\t\tblake2b-256 blake2b-384 blake2b-512 whirlpool tiger\n");
 	fprintf(stderr, "\t\t\tblake2s-128 blake2s-160 blake2s-224 blake2s-256 rmd128\n");
 	fprintf(stdout, "\t\t\trmd160 rmd256 rmd320 chc_hash siphash crc32 adler32\n");
-	fprintf(stdout, "\t\t\tshake3-128 shake3-256\n");
+	fprintf(stdout, "\t\t\tshake3-128 shake3-256 blake3\n");
+	fprintf(stdout, "\t\t\tmore than one file gives a sha256sum style line per file\n");
+	fprintf(stdout, "\t\t\tseveral algorithms, e.g., -tf md5,sha256,sha3-256, are\n");
+	fprintf(stdout, "\t\t\tcomputed from a single read of each file and printed as\n");
+	fprintf(stdout, "\t\t\ttagged lines (sha256sum --tag), also for -td\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, " -td  <directory>\thashes every regular file under <directory> with the\n");
+	fprintf(stdout, "\t\t\talgorithm given by -a (default: sha3-256), a sha256sum\n");
+	fprintf(stdout, "\t\t\tstyle line per file sorted by path. symbolic links\n");
+	fprintf(stdout, "\t\t\tare not followed\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, " --check <manifest>\tverifies the files listed in <manifest> (as made by\n");
+	fprintf(stdout, "\t\t\t-tf with more than one file, -td or sha256sum) with\n");
+	fprintf(stdout, "\t\t\tthe algorithm given by -a (default: sha3-256). of the\n");
+	fprintf(stdout, "\t\t\ttagged lines (-tf a,b,c or sha256sum --tag) those of\n");
+	fprintf(stdout, "\t\t\tthat algorithm are checked. '-' reads it from stdin\n");
+	fprintf(stdout, " --cache <file>\t\tdigests of the files --check saw, files unchanged\n");
+	fprintf(stdout, "\t\t\tsince (same device, inode, size and modification\n");
+	fprintf(stdout, "\t\t\ttime) are not read again\n");
 	fprintf(stdout, "\n");
 	fprintf(stdout, " -len <length>\t\tcustom hash length (in bytes) for shake3-128/256.\n");
 	fprintf(stdout, "\t\t\tdefaults: shake3-128 (16 bytes), shake3-256 (32 bytes)\n");
@@ -209,11 +231,31 @@ void help(void)
 	fprintf(stdout, "\t\t\tgenerates uuid4 randomly (-u) or from given string (-us)\n");
 	fprintf(stderr, "\t\t\tor filename (-uf)\n");
 	fprintf(stdout, "\n");
+	fprintf(stdout, " -r*  <count>\t\twhere '*' may be replaced by 'u' or 'k'\n");
+	fprintf(stdout, "\t\t\tgenerates <count> random bytes (-r), uuid4s (-ru) or\n");
+	fprintf(stdout, "\t\t\thex keys of -len bytes (-rk, default: 32), one per line,\n");
+	fprintf(stdout, "\t\t\te.g., -r 10G -o file. made from a ChaCha20 keystream\n");
+	fprintf(stdout, "\t\t\ton the threads given by -j (default: one per cpu)\n");
+	fprintf(stdout, " -o   <outfile>\t\twhere -r* writes to (default: the screen)\n");
+	fprintf(stdout, " --seed <string>\t-r* makes the same output for the same <string>,\n");
+	fprintf(stdout, "\t\t\totherwise it is keyed from the system RNG\n");
+	fprintf(stdout, "\n");
 	fprintf(stdout, " -e*  [outfile]\t\twhere '*' should be replaced by 's' or 'f'\n");
 	fprintf(stdout, " -d*  [outfile]\t\tencrypts or decrypts a string (-es|-ds)\n");
 	fprintf(stdout, "\t\t\tgiven through '-s' or file (-ef|-df) given through '-f'\n");
 	fprintf(stdout, "\t\t\tand outputs to screen or to [outfile]. if '-c' is not\n");
 	fprintf(stdout, "\t\t\tspecified, aes is the cipher used by default.\n");
+	fprintf(stdout, "\t\t\t-d* reads both the sealed format and the ctr files\n");
+	fprintf(stdout, "\t\t\tof cip v0.53, a sealed file needs no '-c'\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, " -m   <mode>\t\tformat -e* encrypts to:\n");
+	fprintf(stdout, "\t\t\t- gcm: 64K records, each sealed with the cipher in\n");
+	fprintf(stdout, "\t\t\tGCM mode, so damage is detected (default for -ef\n");
+	fprintf(stdout, "\t\t\twith ciphers of 128-bit blocks)\n");
+	fprintf(stdout, "\t\t\t- chacha20poly1305: the same with ChaCha20-Poly1305\n");
+	fprintf(stdout, "\t\t\tinstead of the cipher\n");
+	fprintf(stdout, "\t\t\t- ctr: IV and CTR mode with no authentication, as cip\n");
+	fprintf(stdout, "\t\t\tv0.53 (default for -es and for 64-bit block ciphers)\n");
 	fprintf(stdout, "\n");
 	fprintf(stdout, " -c   <cipher>\t\tcipher to use for encryption/decryption.\n");
 	fprintf(stdout, "\t\t\tciphers: aes (default) blowfish xtea rc2 rc5 rc6 twofish\n");
@@ -224,6 +266,19 @@ void help(void)
 	fprintf(stdout, " -a   <algorithm>\tset hashing algorithm to be used for.\n");
 	fprintf(stdout, "\t\t\tencryption/decryption (see above -t* option for list)\n");
 	fprintf(stdout, "\n");
+	fprintf(stdout, " -chunk <size>\t\tsize of the chunks read, encrypted and written at a\n");
+	fprintf(stdout, "\t\t\ttime by -e*/-d*, e.g., 512K, 16M (default: 4M)\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, " -j   <threads>\t\tnumber of threads -e*/-d* encrypt or decrypt with\n");
+	fprintf(stdout, "\t\t\tor -tf/-td/--check hash files with. 0 uses one thread\n");
+	fprintf(stdout, "\t\t\tper cpu (default: 1, one per cpu for more than one file)\n");
+	fprintf(stdout, "\t\t\ta single file is hashed by several threads with blake3\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, " --offset <size>\t-d* decrypts only the plaintext from byte <size> on,\n");
+	fprintf(stdout, " --length <size>\tand only <size> bytes of it (default: up to the\n");
+	fprintf(stdout, "\t\t\tend), e.g., --offset 10G --length 1M. only the part\n");
+	fprintf(stdout, "\t\t\tof the file holding them is read\n");
+	fprintf(stdout, "\n");
 	fprintf(stdout, " -v\t\t\tversion info\n");
 	fprintf(stdout, " -h\t\t\thelp (this page)\n");
 }
@@ -280,7 +335,14 @@ bool isOptionValid(int argc, char *argv[])
 			 strcmp(ls, "-bd")==0 || strcmp(ls, "-es")==0  || 
 			 strcmp(ls, "-ef")==0 || strcmp(ls, "-ds")==0  ||
 			 strcmp(ls, "-df")==0 || strcmp(ls, "-c")==0   ||
-			 strcmp(ls, "-a")==0) {
+			 strcmp(ls, "-a")==0  || strcmp(ls, "-chunk")==0 ||
+			 strcmp(ls, "-j")==0  || strcmp(ls, "--files-from")==0 ||
+			 strcmp(ls, "-td")==0 || strcmp(ls, "--check")==0 ||
+			 strcmp(ls, "--cache")==0 || strcmp(ls, "-m")==0 ||
+			 strcmp(ls, "--offset")==0 || strcmp(ls, "--length")==0 ||
+			 strcmp(ls, "-r")==0  || strcmp(ls, "-ru")==0  ||
+			 strcmp(ls, "-rk")==0 || strcmp(ls, "-o")==0   ||
+			 strcmp(ls, "--seed")==0) {
 			sp = getSubParam(argv, i);
 			if ( strcmp(ls, "-ts") != 0 && strcmp(ls, "-tf") != 0 &&
 				 strcmp(ls, "-u") != 0  && strcmp(ls, "-us") != 0 &&
@@ -295,11 +357,14 @@ bool isOptionValid(int argc, char *argv[])
 				   && strcmp(ls, "-tf") != 0 && strcmp(ls, "-es") != 0
 				   && strcmp(ls, "-ef") != 0 && strcmp(ls, "-ds") != 0
 				   && strcmp(ls, "-df") != 0) {
-				if (strcmp(left(sp,1),"-") == 0) die(113, sp);
+				/* --files-from - and --check - read from stdin */
+				if (strcmp(left(sp,1),"-") == 0 && (strcmp(sp, "-") != 0 ||
+					(strcmp(ls, "--files-from") != 0 && strcmp(ls, "--check") != 0))) die(113, sp);
 				i++;
 			}
 		}
-		else if ( strcmp(ls, "-v") != 0 && strcmp(ls, "-h") != 0 && strcmp(left(sp,1),"-") == 0 ) {
+		else if ( strcmp(ls, "-v") != 0 && strcmp(ls, "-h") != 0 && strcmp(ls, "-0") != 0 &&
+				  strcmp(left(ls,1),"-") == 0 ) {
 			die(101, ls);
 		}
 	}
@@ -17,6 +17,103 @@
 #include "include/cipher.h"
 
 
+/*----------------------------------------------------------
+*  Function:    ctr_stage()
+*
+*  Description: The cipher stage of the kpipe pipeline. CTR
+*               decryption is the same as encryption.
+*
+*---------------------------------------------------------*/
+static int ctr_stage(const unsigned char *in, unsigned char *out, unsigned long len, void *ctx)
+{
+	return ctr_encrypt(in, out, len, (symmetric_CTR *) ctx);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    ctr_run()
+*
+*  Description: Runs the input through CTR mode into fo, the
+*               input starting at byte pos of the stream. With
+*               more than one thread the chunks are split among
+*               the workers of pctr.c, which gives the same
+*               output as the serial ctr_encrypt().
+*
+*  Returns:     the kpipe_run() status. err holds the cipher
+*               error if the status is KPIPE_ECIPHER.
+*
+*---------------------------------------------------------*/
+static int ctr_run(int cipher_idx, unsigned char *IV, unsigned char *key, int key_size, ulong64 pos,
+				   finput *fi, FILE *fo, size_t chunk, int threads, int *err)
+{
+	symmetric_CTR ctr;
+	pctr_state pc;
+	int status;
+
+	if (threads > 1) {
+		if ((*err = pctr_start(&pc, cipher_idx, IV, key, key_size, threads)) != CRYPT_OK) {
+			die(140, (char *) error_to_string(*err));
+		}
+		pc.pos = pos;
+		status = kpipe_run(fi, fo, chunk, pctr_crypt, &pc, err);
+		pctr_done(&pc);
+	}
+	else {
+		if ((*err = ctr_start(cipher_idx, IV, key, key_size, 0, CTR_COUNTER_LITTLE_ENDIAN, &ctr)) != CRYPT_OK) {
+			die(140, (char *) error_to_string(*err));
+		}
+		if (pos && (*err = pctr_seek(&ctr, IV, pos)) != CRYPT_OK) die(140, (char *) error_to_string(*err));
+		status = kpipe_run(fi, fo, chunk, ctr_stage, &ctr, err);
+		ctr_done(&ctr);
+	}
+
+	return status;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    seal_run()
+*
+*  Description: Runs the input through the sealed record format
+*               of kseal.c into fo, the header having been
+*               written (or read) already. When opening, only
+*               the records holding the plaintext range given
+*               by offset and length (-1 up to the end) are
+*               read.
+*
+*  Returns:     the kpipe_run_sized() status. err holds the
+*               error if the status is KPIPE_ECIPHER.
+*
+*---------------------------------------------------------*/
+static int seal_run(bool is_encrypt, const unsigned char *header, unsigned char *key, unsigned long keylen,
+					long long offset, long long length, finput *fi, FILE *fo, size_t chunk, int threads, int *err)
+{
+	kseal_state ks;
+	ulong64 from, len;
+	long long size;
+	int status;
+
+	if ((*err = kseal_start(&ks, is_encrypt, header, key, keylen, threads)) != CRYPT_OK) {
+		die(154, (char *) error_to_string(*err));
+	}
+
+	if (! is_encrypt && (offset > 0 || length >= 0)) {
+		size = finput_size(fi);
+		kseal_range(&ks, (size < 0) ? -1 : size - KSEAL_HEADER, (ulong64) offset,
+					(length < 0) ? ~(ulong64) 0 : (ulong64) length, &from, &len);
+		if (finput_range(fi, (size_t) (KSEAL_HEADER + from), (size_t) len) != 0) {
+			kseal_done(&ks);
+			return KPIPE_EREAD;
+		}
+	}
+
+	status = kpipe_run_sized(fi, fo, chunk, kseal_outmax(&ks, chunk), kseal_crypt, &ks, err);
+	kseal_done(&ks);
+
+	return status;
+}
+
+
 /*----------------------------------------------------------
 *  Function:    krypt()
 *
@@ -31,22 +128,36 @@
 *               char *cipher = cipher algorithm to use
 *               char *inkey = the key to use for cipher
 *               char *algo = the hashing algorithm to use
+*               krypt_opts *opts = tuning (see -chunk, -j), the
+*                                  format (-m) and the range
+*                                  to decrypt (--offset,
+*                                  --length), NULL for the
+*                                  defaults
 *
 *  Returns:     (char *) the checksum
 *
 *---------------------------------------------------------*/
-char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher, char *inkey, char *algo)
+char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher, char *inkey, char *algo, krypt_opts *opts)
 {
 	unsigned char key[MAXBLOCKSIZE], IV[MAXBLOCKSIZE];
-	unsigned char inbuf[512], plaintext[512], ciphertext[512];
-	FILE *fi = NULL, *fo = NULL;
+	unsigned char header[KSEAL_HEADER], salt[KSEAL_SALTLEN];
+	const unsigned char *inbuf = NULL;
+	finput fi;
+	FILE *fo = NULL;
 	char *rtns = NULL;
-	int cipher_idx, key_size, err;
-	unsigned long ivsize, outlen, x, y;
+	int cipher_idx, key_size, err, status;
+	unsigned long ivsize, outlen, x;
+	size_t chunk = (opts && opts->chunk) ? opts->chunk : KPIPE_CHUNK;
+	int threads = (opts && opts->threads > 1) ? opts->threads : 1;
+	int aead = opts ? opts->aead : KRYPT_AUTO;
+	long long offset = opts ? opts->offset : 0;
+	long long length = opts ? opts->length : -1;
 	bool f2f = false;
-	
-	prng_state prng;
-	symmetric_CTR ctr;
+
+	/* unless told otherwise, give every thread a decent segment */
+	if (threads > 1 && !(opts && opts->chunk) && chunk < (size_t) threads * PCTR_SEGMENT) {
+		chunk = (size_t) threads * PCTR_SEGMENT;
+	}
 
 /*
 	printf("   is_file: %d\n", is_file);
@@ -58,20 +169,12 @@ char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher,
 	printf("      algo: %s\n", algo);
 */
 
-	/* register ciphers, hashes, and psuedo random generators */
-	register_all_ciphers();
-	register_all_prngs();
-
-	/* if is_file, 'in' is interpreted as filename */
-	if (is_file) fi = fopen(in, "rb");
-	else fi = tmpfile();
-	if (fi == NULL) die(133, in);
-
-	/* put 'in' to fi */
-	if (!is_file) {
-		for (int i=0; i < strlen(in); i++) fputc(in[i], fi);
-		rewind(fi);
+	/* if is_file, 'in' is interpreted as filename, otherwise */
+	/* the string itself is the input                          */
+	if (is_file) {
+		if (finput_open(&fi, in, MAXBLOCKSIZE) != 0) die(133, in);
 	}
+	else finput_mem(&fi, (const unsigned char *) in, strlen(in));
 
 	/* determine if out is a file or to be returned */
 	if (out) {
@@ -81,8 +184,8 @@ char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher,
 	else fo = stdout;
 	if (fo == NULL) die(133, in);
 
-	/* get cipher index */
-	cipher_idx = find_cipher(cipher);
+	/* get cipher index, the cipher is registered on first use */
+	cipher_idx = find_cipher_builtin(cipher);
 	if (cipher_idx == -1) die(134, cipher);
 
 	/* get ivsize--should be equal to the block_length of cipher */
@@ -110,57 +213,87 @@ char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher,
 	/* encrypt */
 	if (is_encrypt) {
 
-		/* Setup fortuna for random bytes for IV */
-		if ((err = rng_make_prng(128, find_prng("fortuna"), &prng, NULL)) != CRYPT_OK) {
-           die(137, (char *) error_to_string(err));
-        }
+        /* sealed records for files, unless the blocks of the cipher are  */
+        /* too small for GCM. strings stay ctr: the sealed header has NUL */
+        /* bytes and could not be given back to -ds through argv          */
+        if (aead == KRYPT_AUTO) aead = (is_file && ivsize == 16) ? KSEAL_GCM : KRYPT_CTR;
 
-        x = fortuna_read(IV,ivsize,&prng); /* get random number */
-        if (x != ivsize) die(138, NULL);
+        /* the sealed format: header, then the records */
+        if (aead != KRYPT_CTR) {
+            /* random bytes from the generator of this thread, */
+            /* keyed once from the system and taking no lock   */
+            x = fke_thread_read(salt, KSEAL_SALTLEN);
+            if (x != KSEAL_SALTLEN) die(138, NULL);
 
-        /* first data to write is the IV */
-        if (fwrite(IV, 1, ivsize, fo) != ivsize) die(139, NULL);
+            if (kseal_header(header, aead, cipher, salt) != CRYPT_OK) die(156, cipher);
+            if (fwrite(header, 1, KSEAL_HEADER, fo) != KSEAL_HEADER) die(142, out);
 
-        if ((err = ctr_start(cipher_idx, IV, key, key_size, 0, CTR_COUNTER_LITTLE_ENDIAN,&ctr)) != CRYPT_OK) {
-            die(140, (char *) error_to_string(err));
+            status = seal_run(true, header, key, outlen, 0, -1, &fi, fo, chunk, threads, &err);
         }
+        else {
+            x = fke_thread_read(IV, ivsize); /* get random number */
+            if (x != ivsize) die(138, NULL);
 
-        do {
-        	y = fread(inbuf, 1, sizeof(inbuf), fi);
-
-        	if ((err = ctr_encrypt(inbuf, ciphertext, y, &ctr)) != CRYPT_OK) {
-               die(141, (char *) error_to_string(err));
-            }
-
-            if (fwrite(ciphertext, 1, y, fo) != y) die(142, out);
+            /* first data to write is the IV */
+            if (fwrite(IV, 1, ivsize, fo) != ivsize) die(139, NULL);
 
-        } while (y == sizeof(inbuf));
+            status = ctr_run(cipher_idx, IV, key, key_size, 0, &fi, fo, chunk, threads, &err);
+        }
+        if (status == KPIPE_ECIPHER) die(141, (char *) error_to_string(err));
+        if (status == KPIPE_EWRITE) die(142, out);
+        if (status == KPIPE_ETHREAD) die(163, NULL);
+        if (status != KPIPE_OK) die(133, in);
         
         if (f2f) rtns = concat(concat(in, " encrypted -> "), out);
 
 	} else { /* decrypt */
 		
-		if (fread(IV, 1, ivsize, fi) != ivsize) die(141, in);  /* need to read in IV */
-
-		if ((err = ctr_start(cipher_idx, IV, key, key_size, 0, CTR_COUNTER_LITTLE_ENDIAN, &ctr)) != CRYPT_OK) {
-			die(140, (char *) error_to_string(err));
+		/* a sealed file starts with its magic, one of the legacy */
+		/* format with the IV, which is at least as long          */
+		if (finput_next(&fi, &inbuf, KSEAL_MAGICLEN) != KSEAL_MAGICLEN) die(143, in);
+		memcpy(header, inbuf, KSEAL_MAGICLEN);
+
+		if (kseal_is_sealed(header)) {
+			x = KSEAL_HEADER - KSEAL_MAGICLEN;
+			if (finput_next(&fi, &inbuf, x) != (long) x) die(143, in);
+			memcpy(header + KSEAL_MAGICLEN, inbuf, x);
+
+			status = seal_run(false, header, key, outlen, offset, length, &fi, fo, chunk, threads, &err);
+
+			/* nothing that does not authenticate is left behind */
+			if (status == KPIPE_ECIPHER) {
+				if (out) {
+					fclose(fo);
+					remove(out);
+				}
+				die(153, is_file ? in : "input");
+			}
 		}
-
-		do {
-			y = fread(inbuf, 1, sizeof(inbuf), fi);
-
-			if ((err = ctr_decrypt(inbuf, plaintext, y, &ctr)) != CRYPT_OK) {
-				die(144, (char *) error_to_string(err));
-         	}
-
-         	if (fwrite(plaintext, 1, y, fo) != y) die(142, out);
-
-		} while (y == sizeof(inbuf));
+		else {
+			memcpy(IV, header, KSEAL_MAGICLEN);
+			if (ivsize > KSEAL_MAGICLEN) {
+				x = ivsize - KSEAL_MAGICLEN;
+				if (finput_next(&fi, &inbuf, x) != (long) x) die(143, in);
+				memcpy(IV + KSEAL_MAGICLEN, inbuf, x);
+			}
+
+			/* the keystream at any offset follows from the IV, */
+			/* only the bytes of the range are read             */
+			if (offset > 0 || length >= 0) {
+				if (finput_range(&fi, (size_t) (ivsize + offset), (length < 0) ? SIZE_MAX : (size_t) length) != 0) die(133, in);
+			}
+
+			status = ctr_run(cipher_idx, IV, key, key_size, (ulong64) offset, &fi, fo, chunk, threads, &err);
+		}
+		if (status == KPIPE_ECIPHER) die(144, (char *) error_to_string(err));
+		if (status == KPIPE_EWRITE) die(142, out);
+		if (status == KPIPE_ETHREAD) die(163, NULL);
+		if (status != KPIPE_OK) die(133, in);
 		
 		if (f2f) rtns = concat(concat(in, " decrypted -> "), out);
 	}
 
-	fclose(fi);
+	finput_close(&fi);
 	fclose(fo);
 
 	return rtns;
@@ -30,6 +30,9 @@
 */
 
 #include <stdint.h>
+#include <string.h>
+
+#include "include/hash.h"
 
 #if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
 	__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
@@ -113,3 +116,75 @@ uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]) {
 	DOUBLE_ROUND(v0,v1,v2,v3);
 	return (v0 ^ v1) ^ (v2 ^ v3);
 }
+
+
+/* Incremental interface, for inputs that do not fit in memory. The
+   result is identical to siphash24() over the concatenated input. */
+
+void siphash24_init(siphash24_state *st, const char key[16]) {
+	uint64_t k[2];
+	memcpy(k, key, sizeof(k));
+	uint64_t k0 = _le64toh(k[0]);
+	uint64_t k1 = _le64toh(k[1]);
+
+	st->v0 = k0 ^ 0x736f6d6570736575ULL;
+	st->v1 = k1 ^ 0x646f72616e646f6dULL;
+	st->v2 = k0 ^ 0x6c7967656e657261ULL;
+	st->v3 = k1 ^ 0x7465646279746573ULL;
+	st->total = 0;
+	st->buflen = 0;
+}
+
+
+void siphash24_update(siphash24_state *st, const void *src, unsigned long src_sz) {
+	const uint8_t *m = (const uint8_t *)src;
+	uint64_t v0 = st->v0, v1 = st->v1, v2 = st->v2, v3 = st->v3;
+	uint64_t mi;
+
+	st->total += src_sz;
+
+	/* top up a partial word left over from the previous call */
+	if (st->buflen) {
+		while (st->buflen < 8 && src_sz) {
+			st->buf[st->buflen++] = *m++;
+			src_sz--;
+		}
+		if (st->buflen < 8) return;
+		memcpy(&mi, st->buf, 8);
+		mi = _le64toh(mi);
+		v3 ^= mi;
+		DOUBLE_ROUND(v0,v1,v2,v3);
+		v0 ^= mi;
+		st->buflen = 0;
+	}
+
+	while (src_sz >= 8) {
+		memcpy(&mi, m, 8);
+		mi = _le64toh(mi);
+		m += 8; src_sz -= 8;
+		v3 ^= mi;
+		DOUBLE_ROUND(v0,v1,v2,v3);
+		v0 ^= mi;
+	}
+
+	memcpy(st->buf, m, src_sz);
+	st->buflen = (int)src_sz;
+	st->v0 = v0; st->v1 = v1; st->v2 = v2; st->v3 = v3;
+}
+
+
+uint64_t siphash24_final(siphash24_state *st) {
+	uint64_t v0 = st->v0, v1 = st->v1, v2 = st->v2, v3 = st->v3;
+	uint64_t b = st->total << 56;
+	uint64_t t = 0;
+
+	memcpy(&t, st->buf, st->buflen);
+	b |= _le64toh(t);
+
+	v3 ^= b;
+	DOUBLE_ROUND(v0,v1,v2,v3);
+	v0 ^= b; v2 ^= 0xff;
+	DOUBLE_ROUND(v0,v1,v2,v3);
+	DOUBLE_ROUND(v0,v1,v2,v3);
+	return (v0 ^ v1) ^ (v2 ^ v3);
+}
@@ -0,0 +1,322 @@
+/*-------------------------------------------------------------------
+*  finput.c:       input source implementation file
+*
+*  Description:    Hands out the contents of a file or string in
+*                  chunks. Regular files are memory-mapped so the
+*                  bytes reach the hash or cipher without being
+*                  copied through stdio first.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+	#include <io.h>
+	#define FINPUT_NO_MMAP
+#else
+	#include <unistd.h>
+	#include <sys/mman.h>
+#endif
+
+#ifndef O_BINARY
+	#define O_BINARY 0
+#endif
+
+#include "include/finput.h"
+
+
+/*----------------------------------------------------------
+*  Function:    finput_release()
+*
+*  Description: Gives back the mapped pages already consumed
+*               (less fi->keep bytes) so a mapped file does not
+*               pile up in the resident set while it is read
+*
+*---------------------------------------------------------*/
+static void finput_release(finput *fi)
+{
+#if !defined(FINPUT_NO_MMAP) && defined(MADV_DONTNEED)
+	size_t page, upto;
+
+	if (! fi->mapped || fi->pos < fi->keep) return;
+
+	page = (size_t) sysconf(_SC_PAGESIZE);
+	upto = (fi->pos - fi->keep) / page * page;
+	if (upto >= fi->released + FINPUT_MAP_WINDOW) {
+		madvise((void *) (fi->data + fi->released), upto - fi->released, MADV_DONTNEED);
+		fi->released = upto;
+	}
+#endif
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_fill()
+*
+*  Description: Reads up to max bytes into dst, retrying short
+*               reads so only the last chunk can come up short
+*
+*---------------------------------------------------------*/
+static long finput_fill(finput *fi, unsigned char *dst, size_t max)
+{
+	size_t n = 0;
+
+	if (max > fi->end - fi->pos) max = fi->end - fi->pos;
+
+	while (n < max && ! fi->eof) {
+		long r = (long) read(fi->fd, dst + n, max - n);
+		if (r < 0) {
+			if (errno == EINTR) continue;
+			return -1;
+		}
+		if (r == 0) fi->eof = true;
+		n += (size_t) r;
+	}
+
+	fi->pos += n;
+	return (long) n;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_open()
+*
+*  Description: Opens a file for reading. Regular files of at
+*               least FINPUT_MAP_MIN bytes are memory-mapped,
+*               everything else is read through a buffer of
+*               bufsize bytes
+*
+*  On Entry:    fi = the input source to set up
+*               fname = path and filename
+*               bufsize = read() buffer size if not mapped
+*
+*  Returns:     0 if successful, otherwise -1
+*
+*---------------------------------------------------------*/
+int finput_open(finput *fi, char *fname, size_t bufsize)
+{
+	struct stat st;
+
+	memset(fi, 0, sizeof(finput));
+
+	fi->fd = open(fname, O_RDONLY | O_BINARY);
+	if (fi->fd < 0) return -1;
+	if (fstat(fi->fd, &st) != 0) {
+		close(fi->fd);
+		return -1;
+	}
+
+#ifndef FINPUT_NO_MMAP
+	if (S_ISREG(st.st_mode) && st.st_size >= FINPUT_MAP_MIN &&
+		(unsigned long long) st.st_size <= SIZE_MAX) {
+		void *p = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fi->fd, 0);
+
+		if (p != MAP_FAILED) {
+			#ifdef MADV_SEQUENTIAL
+			madvise(p, (size_t) st.st_size, MADV_SEQUENTIAL);
+			#endif
+			#ifdef MADV_HUGEPAGE
+			madvise(p, (size_t) st.st_size, MADV_HUGEPAGE);
+			#endif
+			fi->data = (const unsigned char *) p;
+			fi->size = (size_t) st.st_size;
+			fi->end = fi->size;
+			fi->mapped = true;
+			return 0;
+		}
+	}
+#endif
+
+	/* pipe, special or small file: fall back to read() */
+#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(fi->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+	fi->end = SIZE_MAX;
+	fi->bufsize = bufsize;
+	if ((fi->buf = (unsigned char *) malloc(bufsize)) == NULL) {
+		close(fi->fd);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_mem()
+*
+*  Description: Wraps a buffer already in memory (e.g., the
+*               string given through -s) as an input source
+*
+*---------------------------------------------------------*/
+void finput_mem(finput *fi, const unsigned char *data, size_t size)
+{
+	memset(fi, 0, sizeof(finput));
+	fi->fd = -1;
+	fi->data = data;
+	fi->size = size;
+	fi->end = size;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_next()
+*
+*  Description: Gets the next chunk of input. Mapped and
+*               in-memory sources are handed out in place,
+*               otherwise the chunk is read into fi->buf. A
+*               short chunk only happens at the end of input.
+*
+*  On Entry:    fi = the input source
+*               data = where to put the address of the chunk,
+*                      valid until the next call
+*               max = largest chunk wanted
+*
+*  Returns:     the size of the chunk, 0 at the end of input,
+*               -1 on read error
+*
+*---------------------------------------------------------*/
+long finput_next(finput *fi, const unsigned char **data, size_t max)
+{
+	size_t n;
+
+	if (finput_inplace(fi)) {
+		n = fi->end - fi->pos;
+		if (n > max) n = max;
+		if (fi->mapped && n > FINPUT_MAP_WINDOW) n = FINPUT_MAP_WINDOW;
+
+		finput_release(fi);
+		*data = fi->data + fi->pos;
+		fi->pos += n;
+		return (long) n;
+	}
+
+	if (max > fi->bufsize) max = fi->bufsize;
+
+	*data = fi->buf;
+	return finput_fill(fi, fi->buf, max);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_read()
+*
+*  Description: Like finput_next() but the chunk is placed in
+*               dst, which lets a caller that keeps several
+*               chunks in flight read straight into its own
+*               buffers. Sources that are handed out in place
+*               (see finput_inplace()) are copied.
+*
+*  Returns:     the size of the chunk, 0 at the end of input,
+*               -1 on read error
+*
+*---------------------------------------------------------*/
+long finput_read(finput *fi, unsigned char *dst, size_t max)
+{
+	const unsigned char *p;
+	long n;
+
+	if (finput_inplace(fi)) {
+		if ((n = finput_next(fi, &p, max)) > 0) memcpy(dst, p, (size_t) n);
+		return n;
+	}
+
+	return finput_fill(fi, dst, max);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_size()
+*
+*  Description: The size of the whole source, whatever has been
+*               handed out of it already
+*
+*  Returns:     the size in bytes, -1 if it cannot be known
+*               beforehand (pipes, special files)
+*
+*---------------------------------------------------------*/
+long long finput_size(finput *fi)
+{
+	struct stat st;
+
+	if (finput_inplace(fi)) return (long long) fi->size;
+	if (fstat(fi->fd, &st) != 0 || ! S_ISREG(st.st_mode)) return -1;
+
+	return (long long) st.st_size;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_range()
+*
+*  Description: Narrows what is left of the input to len bytes
+*               starting at offset off of the source (both cut
+*               at its end). Mapped and in-memory sources just
+*               move their position, files are lseek()ed, so
+*               only the bytes of the range are read. A pipe
+*               cannot seek and is read up to off instead.
+*
+*  On Entry:    fi = the input source
+*               off = offset from the start of the source, not
+*                     before what was handed out already
+*               len = most bytes to hand out from there
+*
+*  Returns:     0 if successful, -1 on read error or if off is
+*               behind the current position
+*
+*---------------------------------------------------------*/
+int finput_range(finput *fi, size_t off, size_t len)
+{
+	if (off < fi->pos) return -1;
+
+	if (finput_inplace(fi)) {
+		if (off > fi->size) off = fi->size;
+		fi->pos = off;
+#ifndef FINPUT_NO_MMAP
+		/* the pages before were never touched, nothing to give back */
+		if (fi->mapped) fi->released = off - off % (size_t) sysconf(_SC_PAGESIZE);
+#endif
+	}
+	else if (lseek(fi->fd, (off_t) off, SEEK_SET) == (off_t) off) fi->pos = off;
+	else {
+		/* not seekable, skip what comes before the range */
+		while (fi->pos < off && ! fi->eof) {
+			size_t n = off - fi->pos;
+			if (finput_fill(fi, fi->buf, n < fi->bufsize ? n : fi->bufsize) < 0) return -1;
+		}
+	}
+
+	fi->end = (len > SIZE_MAX - fi->pos) ? SIZE_MAX : fi->pos + len;
+	if (finput_inplace(fi) && fi->end > fi->size) fi->end = fi->size;
+
+	return 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    finput_close()
+*
+*  Description: Unmaps or frees whatever finput_open() set up
+*
+*---------------------------------------------------------*/
+void finput_close(finput *fi)
+{
+#ifndef FINPUT_NO_MMAP
+	if (fi->mapped) munmap((void *) fi->data, fi->size);
+#endif
+	if (fi->fd >= 0) close(fi->fd);
+	free(fi->buf);
+
+	fi->fd = -1;
+	fi->data = NULL;
+	fi->buf = NULL;
+}
@@ -5,9 +5,16 @@
 *
 *  Date Created:   17 October 2019
 *
-*  Last Modified:  17 October 2019
+*  Last Modified:  17 October 2026
 *
-*  History:        - 23 Nov 2019 (some cleanup in the comments)
+*  History:        - 17 Oct 2026 (hash_ctx for hashing with several
+*                                 algorithms from a single read)
+*                  - 17 Oct 2026 (hash_algo_file() and hash_algo_buf() for
+*                                 hashing batches of files)
+*                  - 17 Oct 2026 (files are hashed in chunks instead of
+*                                 being read whole into memory, regular
+*                                 files are hashed in place via mmap)
+*                  - 23 Nov 2019 (some cleanup in the comments)
 *                  - 17 Oct 2019 (Initial version)
 *
 *  By Nestor A. Jaba-an. Copyright (c) 2019.
@@ -17,6 +24,343 @@
 #include "include/hash.h"
 #include "include/nutsbox.h"
 #include "include/cip.h"
+#include "include/finput.h"
+
+
+/*
+*  Adapters giving each algorithm's update step the
+*  hash_update_fn signature expected by hash_stream()
+*/
+static int crc32_cb(void *ctx, const unsigned char *in, unsigned long len)
+{
+	crc32_update((crc32_state *) ctx, in, len);
+	return CRYPT_OK;
+}
+
+static int adler32_cb(void *ctx, const unsigned char *in, unsigned long len)
+{
+	adler32_update((adler32_state *) ctx, in, len);
+	return CRYPT_OK;
+}
+
+static int siphash_cb(void *ctx, const unsigned char *in, unsigned long len)
+{
+	siphash24_update((siphash24_state *) ctx, in, len);
+	return CRYPT_OK;
+}
+
+static int shake_cb(void *ctx, const unsigned char *in, unsigned long len)
+{
+	return sha3_shake_process((hash_state *) ctx, in, len);
+}
+
+typedef struct {
+	int idx;            /* index into hash_descriptor[] */
+	hash_state md;
+} descriptor_ctx;
+
+static int descriptor_cb(void *ctx, const unsigned char *in, unsigned long len)
+{
+	descriptor_ctx *dc = (descriptor_ctx *) ctx;
+	return hash_descriptor[dc->idx].process(&dc->md, in, len);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    feed()
+*
+*  Description: Hands an input source to a hashing algorithm
+*               chunk by chunk
+*
+*  Returns:     CRYPT_OK, CRYPT_ERROR if the input cannot be
+*               read, otherwise the error from update
+*
+*---------------------------------------------------------*/
+static int feed(finput *fi, hash_update_fn update, void *ctx)
+{
+	const unsigned char *p;
+	long n;
+	int err;
+
+	while ((n = finput_next(fi, &p, FINPUT_MAP_WINDOW)) > 0) {
+		if ((err = update(ctx, p, (unsigned long) n)) != CRYPT_OK) return err;
+	}
+
+	return (n < 0) ? CRYPT_ERROR : CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_stream()
+*
+*  Description: Feeds a file to a hashing algorithm chunk by
+*               chunk, so memory use does not depend on the
+*               size of the file. Regular files are mapped and
+*               hashed in place (see finput.c), anything else
+*               is read in HASH_READ_BUFSIZE chunks.
+*
+*  On Entry:    fname = the file to hash
+*               update = the update step of the algorithm
+*               ctx = the state of the algorithm
+*
+*  Returns:     CRYPT_OK, otherwise the error from update.
+*               Dies if the file cannot be opened or read.
+*
+*---------------------------------------------------------*/
+int hash_stream(char *fname, hash_update_fn update, void *ctx)
+{
+	finput fi;
+	int err;
+
+	if (finput_open(&fi, fname, HASH_READ_BUFSIZE) != 0) die(116, fname);
+
+	err = feed(&fi, update, ctx);
+	if (err == CRYPT_ERROR) die(133, fname);
+
+	finput_close(&fi);
+
+	return err;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_algo_init()
+*
+*  Description: Resolves a hashing algorithm for hash_algo_file()
+*               and hash_algo_buf()
+*
+*  On Entry:    ha = the algorithm to set up
+*               algo = its name, one of HASH_ALGORITHMS
+*               key = as required by siphash
+*               len = digest size in bytes for shake3-128/256,
+*                     0 for the default
+*
+*  Returns:     nothing, dies if algo, key or len is invalid
+*
+*---------------------------------------------------------*/
+void hash_algo_init(hash_algo *ha, char *algo, char *key, int len)
+{
+	memset(ha, 0, sizeof(hash_algo));
+	ha->name = algo;
+
+	if ( !isHashAlgoValid(algo) ) die(108, algo);
+
+	if (strcmp(algo, "siphash") == 0) {
+		if (! key) die(114, algo);
+		if (strlen(key) != 16) die(115, "16");
+		ha->kind = HASH_SIPHASH;
+		ha->key = key;
+		ha->outlen = 8;
+	}
+	else if (strcmp(algo, "crc32") == 0) {
+		ha->kind = HASH_CRC32;
+		ha->outlen = 4;
+	}
+	else if (strcmp(algo, "adler32") == 0) {
+		ha->kind = HASH_ADLER32;
+		ha->outlen = 4;
+	}
+	else if (strncmp(algo, "shake3", 6) == 0) {
+		ha->kind = HASH_SHAKE;
+		ha->bits = (strcmp(algo, "shake3-128") == 0) ? 128 : 256;
+		ha->outlen = (len > 0) ? (unsigned long) len : (unsigned long) ha->bits / 8;
+	}
+	else {
+		ha->kind = HASH_DESC;
+		if ((ha->idx = find_hash_builtin(algo)) == -1) die(108, algo);
+		ha->outlen = hash_descriptor[ha->idx].hashsize;
+	}
+
+	if (ha->outlen > HASH_MAX_DIGEST) die(147, "128");
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_algo_list()
+*
+*  Description: Resolves a comma separated list of algorithms,
+*               e.g., "md5,sha256,sha3-256"
+*
+*  On Entry:    ha = room for HASH_MAX_ALGOS algorithms
+*               list = the names
+*               key, len = see hash_algo_init()
+*
+*  Returns:     the number of algorithms, dies if one is invalid
+*               or there are too many
+*
+*---------------------------------------------------------*/
+int hash_algo_list(hash_algo *ha, char *list, char *key, int len)
+{
+	char *names = (char *) malloc(strlen(list) + 1);
+	char *p, *comma;
+	int n = 0;
+
+	/* names is kept, each ha[].name points into it */
+	if (names == NULL) die(109, (char *) error_to_string(CRYPT_MEM));
+	strcpy(names, list);
+
+	for (p = names; p; p = comma ? comma + 1 : NULL) {
+		if ((comma = strchr(p, ',')) != NULL) *comma = '\0';
+		if (n == HASH_MAX_ALGOS) die(152, "8");
+		hash_algo_init(&ha[n++], p, key, len);
+	}
+
+	return n;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_algo_outlen()
+*
+*  Returns:     the size of the digests of nha algorithms
+*               put back to back
+*
+*---------------------------------------------------------*/
+unsigned long hash_algo_outlen(hash_algo *ha, int nha)
+{
+	unsigned long n = 0;
+	int i;
+
+	for (i = 0; i < nha; i++) n += ha[i].outlen;
+	return n;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_ctx_init()
+*
+*  Description: Starts hashing an input with an algorithm set
+*               up by hash_algo_init(). The input is then given
+*               to hash_ctx_update() in as many pieces as needed.
+*
+*  Returns:     CRYPT_OK, otherwise the error from the algorithm
+*
+*---------------------------------------------------------*/
+int hash_ctx_init(hash_ctx *c, hash_algo *ha)
+{
+	c->ha = ha;
+
+	switch (ha->kind) {
+		case HASH_CRC32:   crc32_init(&c->st.crc); return CRYPT_OK;
+		case HASH_ADLER32: adler32_init(&c->st.adler); return CRYPT_OK;
+		case HASH_SIPHASH: siphash24_init(&c->st.sip, ha->key); return CRYPT_OK;
+		case HASH_SHAKE:   return sha3_shake_init(&c->st.md, ha->bits);
+		default:           return hash_descriptor[ha->idx].init(&c->st.md);
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_ctx_update()
+*
+*  Description: Hashes the next piece of the input. Has the
+*               hash_update_fn signature, ctx being a hash_ctx.
+*
+*  Returns:     CRYPT_OK, otherwise the error from the algorithm
+*
+*---------------------------------------------------------*/
+int hash_ctx_update(void *ctx, const unsigned char *in, unsigned long len)
+{
+	hash_ctx *c = (hash_ctx *) ctx;
+
+	switch (c->ha->kind) {
+		case HASH_CRC32:   return crc32_cb(&c->st.crc, in, len);
+		case HASH_ADLER32: return adler32_cb(&c->st.adler, in, len);
+		case HASH_SIPHASH: return siphash_cb(&c->st.sip, in, len);
+		case HASH_SHAKE:   return shake_cb(&c->st.md, in, len);
+		default:           return hash_descriptor[c->ha->idx].process(&c->st.md, in, len);
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_ctx_done()
+*
+*  Description: Finishes hashing, out gets ha->outlen bytes
+*
+*  Returns:     CRYPT_OK, otherwise the error from the algorithm
+*
+*---------------------------------------------------------*/
+int hash_ctx_done(hash_ctx *c, unsigned char *out)
+{
+	switch (c->ha->kind) {
+		case HASH_CRC32:   crc32_finish(&c->st.crc, out, 4); return CRYPT_OK;
+		case HASH_ADLER32: adler32_finish(&c->st.adler, out, 4); return CRYPT_OK;
+		case HASH_SIPHASH: STORE64H(siphash24_final(&c->st.sip), out); return CRYPT_OK;
+		case HASH_SHAKE:   return sha3_shake_done(&c->st.md, out, c->ha->outlen);
+		default:           return hash_descriptor[c->ha->idx].done(&c->st.md, out);
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_input()
+*
+*  Description: Hashes an input source with an algorithm set
+*               up by hash_algo_init()
+*
+*  Returns:     CRYPT_OK, CRYPT_ERROR if the input cannot be
+*               read, otherwise the error from the algorithm
+*
+*---------------------------------------------------------*/
+static int hash_input(hash_algo *ha, finput *fi, unsigned char *out)
+{
+	hash_ctx c;
+	int err;
+
+	if ((err = hash_ctx_init(&c, ha)) != CRYPT_OK) return err;
+	if ((err = feed(fi, hash_ctx_update, &c)) != CRYPT_OK) return err;
+	return hash_ctx_done(&c, out);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_algo_file()
+*
+*  Description: Hashes a file without dying when it cannot be
+*               opened or read, so a batch of files can go on
+*               with the next one. Safe to call from several
+*               threads at once.
+*
+*  On Entry:    ha = the algorithm, see hash_algo_init()
+*               fname = the file to hash
+*               out = where to put the ha->outlen byte digest
+*
+*  Returns:     CRYPT_OK, CRYPT_FILE_NOTFOUND if the file cannot
+*               be opened, CRYPT_ERROR if it cannot be read
+*               (errno tells why), otherwise the error from
+*               the algorithm
+*
+*---------------------------------------------------------*/
+int hash_algo_file(hash_algo *ha, char *fname, unsigned char *out)
+{
+	finput fi;
+	int err;
+
+	if (finput_open(&fi, fname, HASH_READ_BUFSIZE) != 0) return CRYPT_FILE_NOTFOUND;
+
+	err = hash_input(ha, &fi, out);
+	finput_close(&fi);
+
+	return err;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hash_algo_buf()
+*
+*  Description: Hashes a buffer, see hash_algo_file()
+*
+*  Returns:     CRYPT_OK, otherwise the error from the algorithm
+*
+*---------------------------------------------------------*/
+int hash_algo_buf(hash_algo *ha, const unsigned char *in, unsigned long len, unsigned char *out)
+{
+	finput fi;
+
+	finput_mem(&fi, in, len);
+	return hash_input(ha, &fi, out);
+}
 
 
 /*----------------------------------------------------------
@@ -34,14 +378,11 @@
 char * crc32(bool is_file, char *in) {
 	#define SIZE 4
 	unsigned char * out = (unsigned char *) malloc(SIZE * sizeof(unsigned char));
-	long len;
-
-	if (is_file) in = readfile(in, &len);
-	else len = strlen(in);
 
 	crc32_state ctx;
 	crc32_init(&ctx);                                      /* initialize */
-	crc32_update(&ctx, (const unsigned char*) in, len);    /* update     */
+	if (is_file) hash_stream(in, crc32_cb, &ctx);          /* update     */
+	else crc32_update(&ctx, (const unsigned char*) in, strlen(in));
 	crc32_finish(&ctx, out, SIZE);                         /* finish     */
 
 	return bytox(out, SIZE);
@@ -63,14 +404,11 @@ char * crc32(bool is_file, char *in) {
 char * adler32(bool is_file, char *in) {
 	#define SIZE 4
 	unsigned char * out = (unsigned char *) malloc(SIZE * sizeof(unsigned char));
-	long len;
-
-	if (is_file) in = readfile(in, &len);
-	else len = strlen(in);
 
 	adler32_state ctx;
 	adler32_init(&ctx);                                    /* initialize */
-	adler32_update(&ctx, (const unsigned char*)in, len);   /* update     */
+	if (is_file) hash_stream(in, adler32_cb, &ctx);        /* update     */
+	else adler32_update(&ctx, (const unsigned char*)in, strlen(in));
 	adler32_finish(&ctx, out, SIZE);                       /* finish     */
 
 	return bytox(out, SIZE);
@@ -102,43 +440,40 @@ char * hash(char *in, char *algo, bool is_file, char *key)
 		if (! key) die(114, algo);
 		if (strlen(key) != 16) die(115, "16");
 
-		char *input = NULL;
 		uint64_t keyhash = 0;
-		long ilen = 0;
 
 		if (! is_file) {
-			ilen = strlen(in);
-
 			/* validated against https://duzun.me/playground/hash#siphash= */
-			keyhash = siphash24(in, ilen, key);
+			keyhash = siphash24(in, strlen(in), key);
 		}
 		else { /* siphash a file */
-			input = readfile( in, &ilen );
-			/* printf("-->size of %s - %ld\n", in, ilen); */
-			keyhash = siphash24(input, ilen, key);
+			siphash24_state st;
+			siphash24_init(&st, key);
+			hash_stream(in, siphash_cb, &st);
+			keyhash = siphash24_final(&st);
 		}
 		sprintf((char *)hash_ptr, "%" PRIx64, keyhash);
 		return (char *) hash_ptr;
 	}
 
-	/* Register algorithms before using them */
-	register_all_ciphers();
-	register_all_hashes();
-
-	/* get the index of the hash */
-	idx = find_hash(algo);
+	/* get the index of the hash, registered on first use */
+	idx = find_hash_builtin(algo);
 	if (idx == -1) die(108, algo);
 
 	/* call appropriate hash */
 	len = sizeof(out);
-	in_len = strlen(in);
 	if (! is_file) {
+		in_len = strlen(in);
 		if ((err = hash_memory(idx, (const unsigned char*) in, in_len, out, &len)) != CRYPT_OK) {
 			die(109, (char *) error_to_string(err));
 		}
 	}
 	else {
-		if ((err = hash_file(idx, (const char *)in, out, &len)) != CRYPT_OK) {
+		descriptor_ctx dc;
+		dc.idx = idx;
+		if ((err = hash_descriptor[idx].init(&dc.md)) != CRYPT_OK ||
+			(err = hash_stream(in, descriptor_cb, &dc)) != CRYPT_OK ||
+			(err = hash_descriptor[idx].done(&dc.md, out)) != CRYPT_OK) {
 			die(109, (char *) error_to_string(err));
 		}
 	}
@@ -208,9 +543,20 @@ unsigned char * getshake(bool is_file, int bits, char *in, int outlen)
 	unsigned char * out = NULL;
 
 	if (is_file) { /* if it's a file, *in contains file name */
-		long fsize;
-		char * fdata = readfile(in, &fsize);
-		out = shakehash(bits, fdata, fsize);
+		int err;
+		hash_state state;
+		static unsigned char fout[MAXBLOCKSIZE];
+
+		if ((err = sha3_shake_init(&state, bits)) != CRYPT_OK) {
+			die(118, (char *) error_to_string(err));
+		}
+		if ((err = hash_stream(in, shake_cb, &state)) != CRYPT_OK) {
+			die(119, (char *) error_to_string(err));
+		}
+		if ((err = sha3_shake_done(&state, fout, sizeof(fout))) != CRYPT_OK) {
+			die(120, (char *) error_to_string(err));
+		}
+		out = fout;
 	}
 	else out = shakehash(bits, in, strlen(in));
 
@@ -0,0 +1,441 @@
+/*-------------------------------------------------------------------
+*  hbatch.c:       batch hashing implementation file
+*
+*  Description:    Hashes many files in one run of cip, on a pool
+*                  of threads, and prints one sha256sum style line
+*                  per file. A file that cannot be read is reported
+*                  and skipped instead of ending the run.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (several algorithms at once, printed
+*                                 as BSD style tagged lines)
+*                  - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "include/hbatch.h"
+#include "include/cip.h"
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_list()
+*
+*  Description: Reads a list of files, one per line or, for
+*               lists made by e.g. "find -print0", separated by
+*               NUL characters. Empty entries are skipped.
+*
+*  On Entry:    listname = the list, "-" for stdin
+*               nul = true if NUL separated
+*               paths = list to append to (may be NULL)
+*               n = number of entries in paths, updated
+*
+*  Returns:     (char **) the list, dies if it cannot be read
+*
+*---------------------------------------------------------*/
+char ** hbatch_list(char *listname, bool nul, char **paths, size_t *n)
+{
+	FILE *f = (strcmp(listname, "-") == 0) ? stdin : fopen(listname, "rb");
+	char *buf = NULL, *p, *e, *end;
+	size_t size = 0, cap = 0, count = 0, r;
+	char sep = nul ? '\0' : '\n';
+
+	if (f == NULL) die(116, listname);
+
+	do {
+		if (cap - size < 65536) {
+			cap = cap ? cap * 2 : 65536;
+			if ((buf = (char *) realloc(buf, cap + 1)) == NULL) die(109, (char *) error_to_string(CRYPT_MEM));
+		}
+		r = fread(buf + size, 1, cap - size, f);
+		size += r;
+	} while (r > 0);
+
+	if (ferror(f)) die(133, listname);
+	if (f != stdin) fclose(f);
+
+	/* a separator after the last entry saves checking for the end */
+	buf[size] = sep;
+	end = buf + size;
+
+	for (p = buf; p < end; p++) if (*p == sep) count++;
+	if ((paths = (char **) realloc(paths, (*n + count + 1) * sizeof(char *))) == NULL) {
+		die(109, (char *) error_to_string(CRYPT_MEM));
+	}
+
+	for (p = buf; p < end; p = e + 1) {
+		e = (char *) memchr(p, sep, (size_t) (end - p) + 1);
+		*e = '\0';
+		if (e > p) paths[(*n)++] = p;
+	}
+
+	return paths;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_name()
+*
+*  Description: Prints a file name as sha256sum does, with a
+*               backslash or newline in it escaped. The caller
+*               flags such a line with a leading backslash (see
+*               hbatch_escaped()).
+*
+*---------------------------------------------------------*/
+void hbatch_name(FILE *out, char *path)
+{
+	char *p;
+
+	for (p = path; *p; p++) {
+		if (*p == '\\') fputs("\\\\", out);
+		else if (*p == '\n') fputs("\\n", out);
+		else fputc(*p, out);
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_print()
+*
+*  Description: Prints a digest as sha256sum does, so the output
+*               can be checked with "sha256sum -c" or --check.
+*               With several algorithms each digest gets a line
+*               in the tagged format of "sha256sum --tag", e.g.,
+*               "SHA256 (file) = <hex>".
+*
+*  On Entry:    ha, nha = the algorithms
+*               digest = their digests, back to back
+*               path = the file
+*
+*---------------------------------------------------------*/
+void hbatch_print(FILE *out, hash_algo *ha, int nha, const unsigned char *digest, char *path)
+{
+	static const char hexd[] = "0123456789abcdef";
+	char hex[2 * HASH_MAX_DIGEST + 1];
+	unsigned long i;
+	char *p;
+	int a;
+
+	for (a = 0; a < nha; digest += ha[a++].outlen) {
+		for (i = 0; i < ha[a].outlen; i++) {
+			hex[2 * i] = hexd[digest[i] >> 4];
+			hex[2 * i + 1] = hexd[digest[i] & 15];
+		}
+		hex[2 * i] = '\0';
+
+		if (hbatch_escaped(path)) fputc('\\', out);
+		if (nha == 1) {
+			fprintf(out, "%s  ", hex);
+			hbatch_name(out, path);
+			fputc('\n', out);
+			continue;
+		}
+
+		for (p = ha[a].name; *p; p++) fputc(toupper((unsigned char) *p), out);
+		fputs(" (", out);
+		hbatch_name(out, path);
+		fprintf(out, ") = %s\n", hex);
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_slurp()
+*
+*  Description: Reads a regular file smaller than HBATCH_SMALL
+*               whole into dst
+*
+*  Returns:     the size of the file, -1 if it is not a small
+*               regular file or cannot be read (hash_algo_file()
+*               then deals with it)
+*
+*---------------------------------------------------------*/
+static long hbatch_slurp(char *path, unsigned char *dst)
+{
+	struct stat st;
+	FILE *f;
+	size_t n;
+
+	if (stat(path, &st) != 0 || ! S_ISREG(st.st_mode) || st.st_size >= HBATCH_SMALL) return -1;
+	if ((f = fopen(path, "rb")) == NULL) return -1;
+
+	/* a file that grew past HBATCH_SMALL since stat() is streamed */
+	n = fread(dst, 1, HBATCH_SMALL, f);
+	if (ferror(f) || n == HBATCH_SMALL) n = (size_t) -1;
+	fclose(f);
+
+	return (long) n;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_report()
+*
+*  Description: Prints the line of a hashed file, or why it
+*               could not be hashed on stderr
+*
+*  Returns:     0 if hashed, otherwise 1
+*
+*---------------------------------------------------------*/
+int hbatch_report(FILE *out, hash_algo *ha, int nha, hbatch_item *it)
+{
+	if (it->err == CRYPT_OK) {
+		hbatch_print(out, ha, nha, it->digest, it->path);
+		return 0;
+	}
+
+	fflush(out);
+	if (it->err == CRYPT_FILE_NOTFOUND || it->err == CRYPT_ERROR) {
+		fprintf(stderr, "cip: %s: %s\n", it->path, strerror(it->errnum));
+	}
+	else fprintf(stderr, "cip: %s: %s\n", it->path, error_to_string(it->err));
+
+	return 1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_group()
+*
+*  Description: Hashes a group of files. The small ones are
+*               read into buf and hashed side by side, the others
+*               are streamed one at a time.
+*
+*  On Entry:    ha, nha = the algorithms, see hash_algo_list()
+*               item = the files, at most HBATCH_GROUP. Those
+*                      already done are skipped
+*               count = number of files
+*               buf = HBATCH_GROUP * HBATCH_SMALL bytes, or NULL
+*                     to stream every file
+*               fanout = true to give each algorithm of a
+*                        streamed file its own thread
+*
+*---------------------------------------------------------*/
+void hbatch_group(hash_algo *ha, int nha, hbatch_item *item, size_t count, unsigned char *buf, bool fanout)
+{
+	const unsigned char *in[HBATCH_GROUP];
+	unsigned long inlen[HBATCH_GROUP];
+	unsigned char *out[HBATCH_GROUP];
+	size_t small[HBATCH_GROUP], i;
+	unsigned long k = 0, j, off = 0;
+	int a, err;
+
+	for (i = 0; i < count; i++) {
+		hbatch_item *it = &item[i];
+		long n = -1;
+
+		if (it->done) continue;
+		if (buf && (nha > 1 || ha->kind == HASH_DESC)) n = hbatch_slurp(it->path, buf + k * HBATCH_SMALL);
+		if (n >= 0) {
+			in[k] = buf + k * HBATCH_SMALL;
+			inlen[k] = (unsigned long) n;
+			small[k++] = i;
+			continue;
+		}
+
+		if (nha == 1) it->err = hash_algo_file(ha, it->path, it->digest);
+		else it->err = hmulti_file(ha, nha, it->path, it->digest, fanout);
+		if (it->err != CRYPT_OK) it->errnum = errno;
+	}
+
+	if (k == 0) return;
+
+	for (j = 0; j < k; j++) item[small[j]].err = CRYPT_OK;
+
+	/* each algorithm over all the small files, its digests at off */
+	for (a = 0; a < nha; off += ha[a++].outlen) {
+		for (j = 0; j < k; j++) out[j] = item[small[j]].digest + off;
+
+		if (ha[a].kind == HASH_DESC) {
+			err = hash_memory_batch(ha[a].idx, in, inlen, out, k);
+			for (j = 0; j < k; j++) if (err != CRYPT_OK) item[small[j]].err = err;
+			continue;
+		}
+		for (j = 0; j < k; j++) {
+			err = hash_algo_buf(&ha[a], in[j], inlen[j], out[j]);
+			if (err != CRYPT_OK) item[small[j]].err = err;
+		}
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_thread()
+*
+*  Description: Worker loop: takes groups of files until there
+*               are none left
+*
+*---------------------------------------------------------*/
+static void *hbatch_thread(void *arg)
+{
+	hbatch_state *hb = (hbatch_state *) arg;
+	unsigned char *buf = (unsigned char *) malloc(HBATCH_GROUP * HBATCH_SMALL);
+	size_t first, count, i;
+
+	for (;;) {
+		pthread_mutex_lock(&hb->lock);
+		first = hb->next;
+		count = (hb->n - first < hb->group) ? hb->n - first : hb->group;
+		hb->next += count;
+		pthread_mutex_unlock(&hb->lock);
+
+		if (count == 0) break;
+
+		hbatch_group(hb->ha, hb->nha, &hb->item[first], count, buf, hb->fanout);
+
+		pthread_mutex_lock(&hb->lock);
+		for (i = first; i < first + count; i++) hb->item[i].done = true;
+		pthread_cond_broadcast(&hb->cond);
+		pthread_mutex_unlock(&hb->lock);
+	}
+
+	free(buf);
+	return NULL;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_hash()
+*
+*  Description: Hashes a batch of files on a pool of threads and
+*               hands each file to report, in the order given, as
+*               soon as it is ready
+*
+*  On Entry:    ha, nha = the algorithms, see hash_algo_list()
+*               item = the files, with digest set. Those already
+*                      done (e.g., found in a cache) are not hashed
+*                      again, just reported
+*               n = number of files
+*               threads = number of workers
+*               report = called on the calling thread for each file
+*               ctx = passed on to report
+*
+*  Returns:     the sum of what report returned
+*
+*---------------------------------------------------------*/
+int hbatch_hash(hash_algo *ha, int nha, hbatch_item *item, size_t n, int threads, hbatch_report_fn report, void *ctx)
+{
+	hbatch_state hb;
+	pthread_t *tid;
+	size_t i;
+	int t, sum = 0;
+
+	if (threads < 1) threads = 1;
+
+	memset(&hb, 0, sizeof(hbatch_state));
+	hb.fanout = nha > 1 && (size_t) threads > n;
+	if ((size_t) threads > n) threads = (n > 0) ? (int) n : 1;
+
+	hb.ha = ha;
+	hb.nha = nha;
+	hb.item = item;
+	hb.n = n;
+
+	/* small groups while there are few files, so every worker gets some */
+	hb.group = n / ((size_t) threads * 4);
+	if (hb.group < 1) hb.group = 1;
+	if (hb.group > HBATCH_GROUP) hb.group = HBATCH_GROUP;
+
+	if ((tid = (pthread_t *) calloc(threads, sizeof(pthread_t))) == NULL) {
+		die(109, (char *) error_to_string(CRYPT_MEM));
+	}
+
+	pthread_mutex_init(&hb.lock, NULL);
+	pthread_cond_init(&hb.cond, NULL);
+
+	for (t = 0; t < threads; t++) {
+		if (pthread_create(&tid[t], NULL, hbatch_thread, &hb) != 0) break;
+	}
+	threads = t;
+
+	/* no worker could be started, the files are hashed right here */
+	if (threads == 0) hbatch_thread(&hb);
+
+	for (i = 0; i < n; i++) {
+		pthread_mutex_lock(&hb.lock);
+		while (! item[i].done) pthread_cond_wait(&hb.cond, &hb.lock);
+		pthread_mutex_unlock(&hb.lock);
+
+		sum += report(&item[i], ctx);
+	}
+
+	for (t = 0; t < threads; t++) pthread_join(tid[t], NULL);
+
+	pthread_cond_destroy(&hb.cond);
+	pthread_mutex_destroy(&hb.lock);
+	free(tid);
+
+	return sum;
+}
+
+
+/* where hbatch_run() prints its lines */
+typedef struct {
+	FILE *out;
+	hash_algo *ha;
+	int nha;
+} hbatch_out;
+
+/*----------------------------------------------------------
+*  Function:    hbatch_run_report()
+*
+*  Description: The hbatch_report_fn of hbatch_run()
+*
+*---------------------------------------------------------*/
+static int hbatch_run_report(hbatch_item *it, void *ctx)
+{
+	hbatch_out *o = (hbatch_out *) ctx;
+	return hbatch_report(o->out, o->ha, o->nha, it);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hbatch_run()
+*
+*  Description: Hashes a batch of files and prints a line per
+*               file, in the order given, as each becomes ready
+*
+*  On Entry:    ha, nha = the algorithms, see hash_algo_list()
+*               paths = the files
+*               n = number of files
+*               threads = number of workers
+*               out = where the lines go
+*
+*  Returns:     the number of files that could not be hashed,
+*               those are reported on stderr
+*
+*---------------------------------------------------------*/
+int hbatch_run(hash_algo *ha, int nha, char **paths, size_t n, int threads, FILE *out)
+{
+	hbatch_item *item;
+	unsigned char *digest;
+	unsigned long outlen = hash_algo_outlen(ha, nha);
+	hbatch_out o;
+	size_t i;
+	int failed;
+
+	item = (hbatch_item *) calloc(n + 1, sizeof(hbatch_item));
+	digest = (unsigned char *) malloc((n + 1) * outlen);
+	if (! item || ! digest) die(109, (char *) error_to_string(CRYPT_MEM));
+
+	for (i = 0; i < n; i++) {
+		item[i].path = paths[i];
+		item[i].digest = digest + i * outlen;
+	}
+
+	o.out = out;
+	o.ha = ha;
+	o.nha = nha;
+	failed = hbatch_hash(ha, nha, item, n, threads, hbatch_run_report, &o);
+
+	free(digest);
+	free(item);
+
+	return failed;
+}
@@ -0,0 +1,310 @@
+/*-------------------------------------------------------------------
+*  hcache.c:       digest cache implementation file
+*
+*  Description:    Remembers the digests of the files checked by
+*                  --check, keyed on the device, inode, size and
+*                  modification time of each file, so a file that
+*                  did not change since the last check is not read
+*                  again. The cache file is mapped and searched in
+*                  place, so opening it costs nothing however big
+*                  it gets.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+	#include <io.h>
+	#define HCACHE_NO_MMAP
+#else
+	#include <unistd.h>
+	#include <sys/mman.h>
+#endif
+
+#ifndef O_BINARY
+	#define O_BINARY 0
+#endif
+
+#if defined(__APPLE__)
+	#define ST_MTIME_NS(st) ((uint64_t) (st).st_mtimespec.tv_sec * 1000000000ULL + (st).st_mtimespec.tv_nsec)
+#elif defined(_WIN32) || defined(_WIN64)
+	#define ST_MTIME_NS(st) ((uint64_t) (st).st_mtime * 1000000000ULL)
+#else
+	#define ST_MTIME_NS(st) ((uint64_t) (st).st_mtim.tv_sec * 1000000000ULL + (st).st_mtim.tv_nsec)
+#endif
+
+#include "include/hcache.h"
+#include "include/cip.h"
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_cmp()
+*
+*  Description: Orders records (or keys) by dev, then ino
+*
+*---------------------------------------------------------*/
+static int hcache_cmp(const void *a, const void *b)
+{
+	const hcache_key *x = (const hcache_key *) a, *y = (const hcache_key *) b;
+
+	if (x->dev != y->dev) return (x->dev < y->dev) ? -1 : 1;
+	if (x->ino != y->ino) return (x->ino < y->ino) ? -1 : 1;
+	return 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_keyfp()
+*
+*  Description: Fingerprints the key of a keyed algorithm, so
+*               digests made with one key are not taken for those
+*               of another. All zero if there is no key
+*
+*---------------------------------------------------------*/
+static void hcache_keyfp(hash_algo *ha, unsigned char *fp)
+{
+	unsigned long len = 32;
+	int err;
+
+	memset(fp, 0, 32);
+	if (ha->key == NULL) return;
+
+	if ((err = hash_memory(find_hash_builtin("sha256"), (const unsigned char *) ha->key,
+		strlen(ha->key), fp, &len)) != CRYPT_OK) {
+		die(109, (char *) error_to_string(err));
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_open()
+*
+*  Description: Opens a cache file. A missing file, or one made
+*               with another algorithm, digest length or key, or
+*               by another version of cip, gives an empty cache.
+*
+*  On Entry:    hc = the cache to set up
+*               fname = path and filename of the cache
+*               ha = the algorithm the digests are made with
+*
+*---------------------------------------------------------*/
+void hcache_open(hcache *hc, char *fname, hash_algo *ha)
+{
+	hcache_header h;
+	struct stat st;
+	int fd;
+
+	memset(hc, 0, sizeof(hcache));
+	hc->fname = fname;
+	hc->ha = ha;
+	hc->reclen = (sizeof(hcache_key) + ha->outlen + 7) / 8 * 8;
+	hcache_keyfp(ha, hc->keyfp);
+
+	if ((fd = open(fname, O_RDONLY | O_BINARY)) < 0) return;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(hcache_header)) {
+		close(fd);
+		return;
+	}
+	hc->mapsize = (size_t) st.st_size;
+
+#ifndef HCACHE_NO_MMAP
+	hc->map = mmap(NULL, hc->mapsize, PROT_READ, MAP_SHARED, fd, 0);
+	if (hc->map == MAP_FAILED) hc->map = NULL;
+	else hc->mapped = true;
+#endif
+	if (hc->map == NULL && (hc->map = malloc(hc->mapsize)) != NULL) {
+		if (read(fd, hc->map, hc->mapsize) != (long) hc->mapsize) {
+			free(hc->map);
+			hc->map = NULL;
+		}
+	}
+	close(fd);
+	if (hc->map == NULL) return;
+
+	memcpy(&h, hc->map, sizeof(hcache_header));
+	if (memcmp(h.magic, HCACHE_MAGIC, 8) != 0 || h.version != HCACHE_VERSION ||
+		h.reclen != hc->reclen || strncmp(h.algo, ha->name, sizeof(h.algo)) != 0 ||
+		h.outlen != ha->outlen || memcmp(h.keyfp, hc->keyfp, sizeof(h.keyfp)) != 0 ||
+		h.count > (hc->mapsize - sizeof(hcache_header)) / hc->reclen) {
+		return;
+	}
+
+	hc->rec = (const unsigned char *) hc->map + sizeof(hcache_header);
+	hc->count = (size_t) h.count;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_stat()
+*
+*  Description: Gets the key of a file
+*
+*  Returns:     true if successful, false if stat() failed
+*
+*---------------------------------------------------------*/
+bool hcache_stat(char *path, hcache_key *k)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0) return false;
+
+	k->dev = (uint64_t) st.st_dev;
+	k->ino = (uint64_t) st.st_ino;
+	k->size = (uint64_t) st.st_size;
+	k->mtime_ns = ST_MTIME_NS(st);
+
+	return true;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_find()
+*
+*  Description: Looks a file up, by binary search of the records
+*
+*  Returns:     its cached digest, NULL if it is not cached or
+*               its size or modification time changed
+*
+*---------------------------------------------------------*/
+const unsigned char * hcache_find(hcache *hc, const hcache_key *k)
+{
+	size_t lo = 0, hi = hc->count;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const unsigned char *r = hc->rec + mid * hc->reclen;
+		hcache_key rk;
+		int c;
+
+		memcpy(&rk, r, sizeof(hcache_key));
+		c = hcache_cmp(k, &rk);
+		if (c == 0) {
+			if (rk.size != k->size || rk.mtime_ns != k->mtime_ns) return NULL;
+			return r + sizeof(hcache_key);
+		}
+		if (c < 0) hi = mid;
+		else lo = mid + 1;
+	}
+
+	return NULL;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_add()
+*
+*  Description: Notes the digest of a file for hcache_save()
+*
+*---------------------------------------------------------*/
+void hcache_add(hcache *hc, const hcache_key *k, const unsigned char *digest)
+{
+	unsigned char *r;
+
+	if (hc->nadd == hc->capadd) {
+		hc->capadd = hc->capadd ? hc->capadd * 2 : 1024;
+		if ((hc->add = (unsigned char *) realloc(hc->add, hc->capadd * hc->reclen)) == NULL) {
+			die(109, (char *) error_to_string(CRYPT_MEM));
+		}
+	}
+
+	r = hc->add + hc->nadd++ * hc->reclen;
+	memset(r, 0, hc->reclen);
+	memcpy(r, k, sizeof(hcache_key));
+	memcpy(r + sizeof(hcache_key), digest, hc->ha->outlen);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_save()
+*
+*  Description: Replaces the cache file with the digests noted
+*               by hcache_add(). Files modified after since_ns
+*               less HCACHE_RACY_NS are left out: they may change
+*               again without their modification time doing so.
+*               The file is written aside and renamed over the
+*               old one, which may still be mapped.
+*
+*  On Entry:    hc = the cache
+*               since_ns = when the check started
+*
+*  Returns:     0 if successful, otherwise -1
+*
+*---------------------------------------------------------*/
+int hcache_save(hcache *hc, uint64_t since_ns)
+{
+	hcache_header h;
+	char *tmp;
+	FILE *f;
+	size_t i, n = 0;
+	int err = 0;
+
+	qsort(hc->add, hc->nadd, hc->reclen, hcache_cmp);
+
+	/* drop racy records, and files listed more than once */
+	for (i = 0; i < hc->nadd; i++) {
+		unsigned char *r = hc->add + i * hc->reclen;
+		hcache_key k;
+
+		memcpy(&k, r, sizeof(hcache_key));
+		if (k.mtime_ns + HCACHE_RACY_NS >= since_ns) continue;
+		if (n > 0 && hcache_cmp(r, hc->add + (n - 1) * hc->reclen) == 0) continue;
+		memmove(hc->add + n++ * hc->reclen, r, hc->reclen);
+	}
+
+	memset(&h, 0, sizeof(hcache_header));
+	memcpy(h.magic, HCACHE_MAGIC, 8);
+	h.version = HCACHE_VERSION;
+	h.reclen = (uint32_t) hc->reclen;
+	strncpy(h.algo, hc->ha->name, sizeof(h.algo) - 1);
+	h.outlen = (uint32_t) hc->ha->outlen;
+	memcpy(h.keyfp, hc->keyfp, sizeof(h.keyfp));
+	h.count = n;
+
+	if ((tmp = (char *) malloc(strlen(hc->fname) + 5)) == NULL) return -1;
+	sprintf(tmp, "%s.tmp", hc->fname);
+
+	if ((f = fopen(tmp, "wb")) == NULL) {
+		free(tmp);
+		return -1;
+	}
+	if (fwrite(&h, sizeof(hcache_header), 1, f) != 1) err = -1;
+	if (n > 0 && fwrite(hc->add, hc->reclen, n, f) != n) err = -1;
+	if (fclose(f) != 0) err = -1;
+
+#if defined(_WIN32) || defined(_WIN64)
+	if (err == 0) remove(hc->fname);
+#endif
+	if (err == 0 && rename(tmp, hc->fname) != 0) err = -1;
+	if (err != 0) remove(tmp);
+
+	free(tmp);
+	return err;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcache_close()
+*
+*  Description: Unmaps the cache file and frees the records
+*
+*---------------------------------------------------------*/
+void hcache_close(hcache *hc)
+{
+#ifndef HCACHE_NO_MMAP
+	if (hc->mapped) munmap(hc->map, hc->mapsize);
+	else
+#endif
+	free(hc->map);
+	free(hc->add);
+
+	hc->map = NULL;
+	hc->rec = NULL;
+	hc->add = NULL;
+}
@@ -0,0 +1,243 @@
+/*-------------------------------------------------------------------
+*  hcheck.c:       manifest check implementation file
+*
+*  Description:    Verifies files against a list of digests in the
+*                  formats cip -tf/-td and sha256sum print, plain
+*                  or tagged, the way "sha256sum -c" does. With a cache, files whose
+*                  device, inode, size and modification time are
+*                  the same as at the last check are not read again.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include "include/hcheck.h"
+#include "include/cip.h"
+
+
+/*----------------------------------------------------------
+*  Function:    hcheck_hex()
+*
+*  Description: Reads a digest of outlen bytes from hex
+*
+*  Returns:     true if hex starts with 2 * outlen hex digits
+*
+*---------------------------------------------------------*/
+static bool hcheck_hex(const char *hex, unsigned long outlen, unsigned char *digest)
+{
+	unsigned long i;
+
+	for (i = 0; i < 2 * outlen; i++) {
+		if (! isxdigit((unsigned char) hex[i])) return false;
+	}
+	for (i = 0; i < outlen; i++) {
+		digest[i] = (unsigned char) ((HEXOF(hex[2 * i]) << 4) | HEXOF(hex[2 * i + 1]));
+	}
+
+	return true;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcheck_parse()
+*
+*  Description: Splits a manifest line into the digest and the
+*               file name, undoing the escapes of a line that
+*               starts with a backslash. The line is changed in
+*               place.
+*
+*  On Entry:    line = "<hex>  <name>", "<hex> *<name>" or the
+*                      tagged "<ALGO> (<name>) = <hex>" of
+*                      -tf a,b,c and "sha256sum --tag"
+*               ha = the algorithm being checked
+*               digest = where to put the digest
+*               path = where to put the file name
+*
+*  Returns:     1 if the line is well formed, -1 if it is a
+*               tagged line of another algorithm, 0 otherwise
+*
+*---------------------------------------------------------*/
+static int hcheck_parse(char *line, hash_algo *ha, unsigned char *digest, char **path)
+{
+	unsigned long outlen = ha->outlen;
+	bool esc = (line[0] == '\\');
+	size_t len;
+	char *p, *q, *tag;
+
+	if (esc) line++;
+
+	len = strlen(line);
+	if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+
+	if (len >= 2 * outlen + 3 && hcheck_hex(line, outlen, digest) &&
+		line[2 * outlen] == ' ' && (line[2 * outlen + 1] == ' ' || line[2 * outlen + 1] == '*')) {
+		*path = line + 2 * outlen + 2;
+	}
+	else {
+		/* the name runs from the first " (" to the last ") = " */
+		if ((p = strstr(line, " (")) == NULL) return 0;
+		for (q = NULL, tag = p; (tag = strstr(tag + 1, ") = ")) != NULL; q = tag);
+		if (q == NULL) return 0;
+
+		*p = '\0';
+		for (tag = line, p += 2; *tag || ha->name[tag - line]; tag++) {
+			if (tolower((unsigned char) *tag) != ha->name[tag - line]) return -1;
+		}
+
+		if (strlen(q + 4) != 2 * outlen || ! hcheck_hex(q + 4, outlen, digest)) return 0;
+		*q = '\0';
+		*path = p;
+	}
+	if (! esc) return 1;
+
+	for (p = q = *path; *p; p++) {
+		if (*p == '\\') {
+			p++;
+			if (*p == '\\') *q++ = '\\';
+			else if (*p == 'n') *q++ = '\n';
+			else return 0;
+		}
+		else *q++ = *p;
+	}
+	*q = '\0';
+
+	return 1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcheck_report()
+*
+*  Description: Prints "<name>: OK" or "<name>: FAILED" for a
+*               file once it is hashed (or found in the cache),
+*               and notes its digest for the cache
+*
+*  Returns:     1 if the file did not pass, otherwise 0
+*
+*---------------------------------------------------------*/
+static int hcheck_report(hbatch_item *it, void *ctx)
+{
+	hcheck_state *hs = (hcheck_state *) ctx;
+	size_t i = (size_t) (it - hs->item);
+	unsigned long outlen = hs->ha->outlen;
+	const char *verdict = "OK";
+
+	if (it->err != CRYPT_OK) {
+		fflush(hs->out);
+		if (it->err == CRYPT_FILE_NOTFOUND || it->err == CRYPT_ERROR) {
+			fprintf(stderr, "cip: %s: %s\n", it->path, strerror(it->errnum));
+		}
+		else fprintf(stderr, "cip: %s: %s\n", it->path, error_to_string(it->err));
+		verdict = "FAILED open or read";
+		hs->unreadable++;
+	}
+	else {
+		if (hs->cache && hs->has_key[i]) hcache_add(hs->cache, &hs->key[i], it->digest);
+		if (memcmp(it->digest, hs->expect + i * outlen, outlen) != 0) {
+			verdict = "FAILED";
+			hs->mismatch++;
+		}
+	}
+
+	if (hbatch_escaped(it->path)) fputc('\\', hs->out);
+	hbatch_name(hs->out, it->path);
+	fprintf(hs->out, ": %s\n", verdict);
+
+	return (it->err != CRYPT_OK || verdict[0] != 'O') ? 1 : 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hcheck_run()
+*
+*  Description: Checks the files listed in a manifest
+*
+*  On Entry:    ha = the algorithm the manifest was made with
+*               manifest = the list of digests, "-" for stdin
+*               cachefile = the digest cache, NULL for none
+*               threads = number of workers hashing the files
+*               out = where the verdicts go
+*
+*  Returns:     the number of files that failed the check or
+*               could not be read. Dies if the manifest has no
+*               well formed line.
+*
+*---------------------------------------------------------*/
+int hcheck_run(hash_algo *ha, char *manifest, char *cachefile, int threads, FILE *out)
+{
+	hcheck_state hs;
+	hcache cache;
+	char **lines;
+	unsigned char *digest;
+	size_t nlines = 0, n = 0, bad = 0, i;
+	uint64_t start = gettime_ns();
+	int failed, r;
+
+	lines = hbatch_list(manifest, false, NULL, &nlines);
+
+	memset(&hs, 0, sizeof(hcheck_state));
+	hs.ha = ha;
+	hs.out = out;
+	hs.item = (hbatch_item *) calloc(nlines + 1, sizeof(hbatch_item));
+	hs.expect = (unsigned char *) malloc((nlines + 1) * ha->outlen);
+	hs.key = (hcache_key *) calloc(nlines + 1, sizeof(hcache_key));
+	hs.has_key = (bool *) calloc(nlines + 1, sizeof(bool));
+	digest = (unsigned char *) malloc((nlines + 1) * ha->outlen);
+	if (! hs.item || ! hs.expect || ! hs.key || ! hs.has_key || ! digest) {
+		die(109, (char *) error_to_string(CRYPT_MEM));
+	}
+
+	/* tagged lines of the other algorithms are left alone */
+	for (i = 0; i < nlines; i++) {
+		if ((r = hcheck_parse(lines[i], ha, hs.expect + n * ha->outlen, &hs.item[n].path)) <= 0) {
+			if (r == 0) bad++;
+			continue;
+		}
+		hs.item[n].digest = digest + n * ha->outlen;
+		n++;
+	}
+	if (n == 0) die(151, manifest);
+
+	/* files unchanged since the last check take their digest from the cache */
+	if (cachefile) {
+		hs.cache = &cache;
+		hcache_open(&cache, cachefile, ha);
+		for (i = 0; i < n; i++) {
+			const unsigned char *d;
+
+			if (! (hs.has_key[i] = hcache_stat(hs.item[i].path, &hs.key[i]))) continue;
+			if ((d = hcache_find(&cache, &hs.key[i])) != NULL) {
+				memcpy(hs.item[i].digest, d, ha->outlen);
+				hs.item[i].done = true;
+			}
+		}
+	}
+
+	failed = hbatch_hash(ha, 1, hs.item, n, threads, hcheck_report, &hs);
+
+	if (cachefile) {
+		fflush(out);
+		if (hcache_save(&cache, start) != 0) fprintf(stderr, "cip: %s: unable to save the cache\n", cachefile);
+		hcache_close(&cache);
+	}
+
+	fflush(out);
+	if (bad) fprintf(stderr, "cip: WARNING: %lu line(s) improperly formatted\n", (unsigned long) bad);
+	if (hs.unreadable) fprintf(stderr, "cip: WARNING: %lu listed file(s) could not be read\n", (unsigned long) hs.unreadable);
+	if (hs.mismatch) fprintf(stderr, "cip: WARNING: %lu computed checksum(s) did NOT match\n", (unsigned long) hs.mismatch);
+
+	free(digest);
+	free(hs.has_key);
+	free(hs.key);
+	free(hs.expect);
+	free(hs.item);
+	free(lines);
+
+	return failed;
+}
@@ -0,0 +1,122 @@
+/*-------------------------------------------------------------------
+*  hmulti.c:       multi-digest hashing implementation file
+*
+*  Description:    Hashes a file with several algorithms at once,
+*                  e.g., for -tf md5,sha256,sha3-256. The file is
+*                  read (or mapped) a single time and every chunk
+*                  goes to each algorithm in turn, or to a thread
+*                  per algorithm so the digests are computed side
+*                  by side on separate cores.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "include/hmulti.h"
+
+
+/*----------------------------------------------------------
+*  Function:    hmulti_part()
+*
+*  Description: Runs algorithm i over the chunk, as a part of
+*               a tpool job
+*
+*---------------------------------------------------------*/
+static void hmulti_part(void *ctx, int i)
+{
+	hmulti_state *hm = (hmulti_state *) ctx;
+	hmulti_worker *w = &hm->worker[i];
+
+	if (w->err == CRYPT_OK) w->err = hash_ctx_update(&w->ctx, hm->data, hm->len);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hmulti_chunk()
+*
+*  Description: Runs every algorithm over a chunk, returning
+*               once all of them are done with it
+*
+*---------------------------------------------------------*/
+static void hmulti_chunk(hmulti_state *hm, const unsigned char *data, unsigned long len)
+{
+	int i;
+
+	hm->data = data;
+	hm->len = len;
+
+	/* the calling thread takes algorithms as well */
+	if (hm->threaded) tpool_run(&hm->pool, hm->nha, hmulti_part, hm);
+	else for (i = 0; i < hm->nha; i++) hmulti_part(hm, i);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hmulti_file()
+*
+*  Description: Hashes a file with several algorithms, reading
+*               it only once
+*
+*  On Entry:    ha = the algorithms, see hash_algo_list()
+*               nha = number of algorithms
+*               fname = the file to hash
+*               out = the digests, back to back in the order of
+*                     ha (hash_algo_outlen() bytes)
+*               threaded = true to run each algorithm on its own
+*                          thread
+*
+*  Returns:     CRYPT_OK, CRYPT_FILE_NOTFOUND if the file cannot
+*               be opened or CRYPT_ERROR if it cannot be read
+*               (errno tells why), otherwise the error from an
+*               algorithm
+*
+*---------------------------------------------------------*/
+int hmulti_file(hash_algo *ha, int nha, char *fname, unsigned char *out, bool threaded)
+{
+	hmulti_state hm;
+	finput fi;
+	const unsigned char *p;
+	long n;
+	int i, err = CRYPT_OK, errnum = 0;
+
+	if (finput_open(&fi, fname, HMULTI_READ_BUFSIZE) != 0) return CRYPT_FILE_NOTFOUND;
+
+	memset(&hm, 0, sizeof(hmulti_state));
+	hm.nha = nha;
+	hm.threaded = threaded && nha > 1;
+
+	for (i = 0; i < nha; i++) hm.worker[i].err = hash_ctx_init(&hm.worker[i].ctx, &ha[i]);
+
+	/* one algorithm at a time if no thread can be started */
+	if (hm.threaded) {
+		if (tpool_start(&hm.pool, nha - 1) != CRYPT_OK) hm.threaded = false;
+		else if (hm.pool.threads == 0) {
+			tpool_done(&hm.pool);
+			hm.threaded = false;
+		}
+	}
+
+	while ((n = finput_next(&fi, &p, FINPUT_MAP_WINDOW)) > 0) hmulti_chunk(&hm, p, (unsigned long) n);
+	if (n < 0) {
+		err = CRYPT_ERROR;
+		errnum = errno;
+	}
+
+	if (hm.threaded) tpool_done(&hm.pool);
+
+	finput_close(&fi);
+
+	for (i = 0; i < nha; i++) {
+		if (err == CRYPT_OK) err = hm.worker[i].err;
+		if (err == CRYPT_OK) err = hash_ctx_done(&hm.worker[i].ctx, out);
+		out += ha[i].outlen;
+	}
+
+	errno = errnum;
+	return err;
+}
@@ -0,0 +1,205 @@
+/*-------------------------------------------------------------------
+*  hpar.c:         parallel BLAKE3 implementation file
+*
+*  Description:    BLAKE3 hashes 1 KiB chunks independently and
+*                  combines them in a binary tree, so an aligned
+*                  run of 2^k chunks is a subtree whose chaining
+*                  value can be computed on its own. Each window
+*                  of a mapped file is cut into such subtrees,
+*                  hashed by several threads at once, and the
+*                  results are added to the hash state in order.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/hpar.h"
+#include "include/hash.h"
+
+
+/*----------------------------------------------------------
+*  Function:    hpar_part()
+*
+*  Description: Hashes the subtree of worker i, as a part of a
+*               tpool job
+*
+*---------------------------------------------------------*/
+static void hpar_part(void *ctx, int i)
+{
+	hpar_state *hp = (hpar_state *) ctx;
+	hpar_worker *w = &hp->worker[i];
+
+	if (w->len) w->err = blake3_subtree(&hp->md, w->in, w->len, w->chunk, w->cv);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hpar_start()
+*
+*  Description: Starts a BLAKE3 hash and its workers
+*
+*  On Entry:    hp = the state to set up
+*               threads = number of workers, the calling
+*                         thread being one of them. Fewer are
+*                         used if not all threads can be
+*                         started.
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+int hpar_start(hpar_state *hp, int threads)
+{
+	int err;
+
+	if (threads < 1) threads = 1;
+
+	memset(hp, 0, sizeof(hpar_state));
+
+	if ((err = blake3_init(&hp->md)) != CRYPT_OK) return err;
+
+	/* worker 0 is the calling thread */
+	if ((err = tpool_start(&hp->pool, threads - 1)) != CRYPT_OK) return err;
+	hp->threads = hp->pool.threads + 1;
+
+	if ((hp->worker = (hpar_worker *) calloc(hp->threads, sizeof(hpar_worker))) == NULL) {
+		tpool_done(&hp->pool);
+		return CRYPT_MEM;
+	}
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hpar_subtrees()
+*
+*  Description: Hashes the whole chunks at the start of in (all
+*               but the last byte of it may be used) as up to one
+*               subtree per worker
+*
+*  Returns:     the number of bytes used, or a negative error
+*
+*---------------------------------------------------------*/
+static long hpar_subtrees(hpar_state *hp, const unsigned char *in, unsigned long len)
+{
+	unsigned long avail = (len - 1) / HPAR_CHUNK, n, used = 0;
+	ulong64 chunk;
+	int i, busy = 0, err;
+
+	if ((err = blake3_chunk(&hp->md, &chunk)) != CRYPT_OK) return -err;
+
+	/* the biggest power of 2 that gives every worker a share, and
+	*  that the subtrees starting at chunk are aligned to */
+	for (n = 1; n * 2 * hp->threads <= avail; n *= 2);
+	while ((chunk & (n - 1)) != 0) n /= 2;
+	if (n * HPAR_CHUNK < HPAR_MIN_SUBTREE) return 0;
+
+	for (i = 0; i < hp->threads; i++) {
+		hpar_worker *w = &hp->worker[i];
+
+		w->in = in + used;
+		w->len = (avail - used / HPAR_CHUNK >= n) ? n * HPAR_CHUNK : 0;
+		w->chunk = chunk + used / HPAR_CHUNK;
+		w->err = CRYPT_OK;
+		used += w->len;
+		if (i > 0 && w->len > 0) busy++;
+	}
+
+	/* the subtrees in use come first */
+	if (busy) tpool_run(&hp->pool, busy + 1, hpar_part, hp);
+	else hpar_part(hp, 0);
+
+	/* in order, as the tree is built left to right */
+	for (i = 0; i < hp->threads && hp->worker[i].len; i++) {
+		if ((err = hp->worker[i].err) != CRYPT_OK) return -err;
+		if ((err = blake3_push_subtree(&hp->md, hp->worker[i].cv, hp->worker[i].len)) != CRYPT_OK) return -err;
+	}
+
+	return (long) used;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hpar_process()
+*
+*  Description: Hashes the next len bytes. Has the hash_update_fn
+*               signature so it can be given to hash_stream().
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+int hpar_process(void *ctx, const unsigned char *in, unsigned long len)
+{
+	hpar_state *hp = (hpar_state *) ctx;
+	struct blake3_state *s = &hp->md.blake3;
+	unsigned long n;
+	long used;
+	int err;
+
+	/* up to the next chunk boundary the plain way */
+	n = (HPAR_CHUNK - (s->blocks * 64 + s->curlen) % HPAR_CHUNK) % HPAR_CHUNK;
+	if (n > len) n = len;
+	if ((err = blake3_process(&hp->md, in, n)) != CRYPT_OK) return err;
+	in += n;
+	len -= n;
+
+	while (hp->threads > 1 && len > HPAR_CHUNK) {
+		if ((used = hpar_subtrees(hp, in, len)) < 0) return (int) -used;
+		if (used == 0) break;
+		in += used;
+		len -= (unsigned long) used;
+	}
+
+	return blake3_process(&hp->md, in, len);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hpar_done()
+*
+*  Description: Stops the workers and finishes the hash
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+int hpar_done(hpar_state *hp, unsigned char *out)
+{
+	tpool_done(&hp->pool);
+	free(hp->worker);
+
+	return blake3_done(&hp->md, out);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    hpar_file()
+*
+*  Description: Hashes a file with BLAKE3 on several threads
+*
+*  On Entry:    fname = the file to hash
+*               threads = number of threads
+*               out = where to put the HPAR_OUTLEN byte digest
+*
+*  Returns:     CRYPT_OK, otherwise the error from BLAKE3.
+*               Dies if the file cannot be opened or read.
+*
+*---------------------------------------------------------*/
+int hpar_file(char *fname, int threads, unsigned char *out)
+{
+	hpar_state hp;
+	unsigned char tmp[HPAR_OUTLEN];
+	int err;
+
+	if ((err = hpar_start(&hp, threads)) != CRYPT_OK) return err;
+
+	if ((err = hash_stream(fname, hpar_process, &hp)) != CRYPT_OK) {
+		hpar_done(&hp, tmp);
+		return err;
+	}
+
+	return hpar_done(&hp, out);
+}
@@ -0,0 +1,370 @@
+/*-------------------------------------------------------------------
+*  htree.c:        directory tree hashing implementation file
+*
+*  Description:    Walks a directory tree and hashes every regular
+*                  file in it on a pool of threads. Each worker
+*                  queues what it finds on its own deque and takes
+*                  work from the others once its deque runs dry, so
+*                  a few huge files do not hold up the rest of the
+*                  tree. The lines are printed sorted by path once
+*                  the whole tree is done.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (several algorithms at once)
+*                  - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "include/htree.h"
+#include "include/cip.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+	#define lstat stat
+#endif
+
+
+/*----------------------------------------------------------
+*  Function:    htree_newtask()
+*
+*  Description: Allocates a task with room for n files and
+*               their digests
+*
+*---------------------------------------------------------*/
+static htree_task * htree_newtask(htree_state *ht, char *dir, size_t n)
+{
+	htree_task *t;
+	size_t i;
+
+	t = (htree_task *) calloc(1, sizeof(htree_task) + n * (sizeof(hbatch_item) + ht->outlen));
+	if (t == NULL) die(109, (char *) error_to_string(CRYPT_MEM));
+
+	t->dir = dir;
+	t->item = (hbatch_item *) (t + 1);
+	for (i = 0; i < n; i++) t->item[i].digest = (unsigned char *) (t->item + n) + i * ht->outlen;
+
+	return t;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_fail()
+*
+*  Description: Records a path that could not be read, to be
+*               reported in its place in the sorted output
+*
+*---------------------------------------------------------*/
+static void htree_fail(htree_worker *w, char *path, int errnum)
+{
+	htree_task *t = htree_newtask(w->ht, NULL, 1);
+
+	t->n = 1;
+	t->item[0].path = path;
+	t->item[0].err = CRYPT_FILE_NOTFOUND;
+	t->item[0].errnum = errnum;
+	t->next = w->done;
+	w->done = t;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_push()
+*
+*  Description: Queues a task at the back of the deque of w.
+*               It is counted as pending before it can be seen,
+*               so no worker can take the count to 0 early.
+*
+*---------------------------------------------------------*/
+static void htree_push(htree_worker *w, htree_task *t)
+{
+	htree_state *ht = w->ht;
+	htree_deque *dq = &w->dq;
+
+	pthread_mutex_lock(&ht->lock);
+	ht->pending++;
+	pthread_mutex_unlock(&ht->lock);
+
+	pthread_mutex_lock(&dq->lock);
+	if (dq->tail == dq->cap) {
+		if (dq->head > 0) {
+			memmove(dq->task, dq->task + dq->head, (dq->tail - dq->head) * sizeof(htree_task *));
+			dq->tail -= dq->head;
+			dq->head = 0;
+		}
+		else {
+			dq->cap = dq->cap ? dq->cap * 2 : 64;
+			dq->task = (htree_task **) realloc(dq->task, dq->cap * sizeof(htree_task *));
+			if (dq->task == NULL) die(109, (char *) error_to_string(CRYPT_MEM));
+		}
+	}
+	dq->task[dq->tail++] = t;
+	pthread_mutex_unlock(&dq->lock);
+
+	pthread_mutex_lock(&ht->lock);
+	ht->gen++;
+	pthread_cond_signal(&ht->cond);
+	pthread_mutex_unlock(&ht->lock);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_take()
+*
+*  Description: Takes a task from the back of the deque of w
+*               (its newest) or, when stealing, from the front
+*
+*  Returns:     the task, NULL if the deque is empty
+*
+*---------------------------------------------------------*/
+static htree_task * htree_take(htree_worker *w, bool steal)
+{
+	htree_deque *dq = &w->dq;
+	htree_task *t = NULL;
+
+	pthread_mutex_lock(&dq->lock);
+	if (dq->head < dq->tail) t = steal ? dq->task[dq->head++] : dq->task[--dq->tail];
+	if (dq->head == dq->tail) dq->head = dq->tail = 0;
+	pthread_mutex_unlock(&dq->lock);
+
+	return t;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_scan()
+*
+*  Description: Queues the subdirectories of a directory, its
+*               small files in groups of HBATCH_GROUP and its
+*               bigger files one by one. Symbolic links and
+*               special files are skipped.
+*
+*---------------------------------------------------------*/
+static void htree_scan(htree_worker *w, htree_task *t)
+{
+	htree_state *ht = w->ht;
+	htree_task *g = NULL, *b;
+	struct dirent *de;
+	struct stat st;
+	size_t dlen = strlen(t->dir);
+	bool slash = dlen > 0 && t->dir[dlen - 1] == '/';
+	DIR *d;
+	char *p;
+
+	if ((d = opendir(t->dir)) == NULL) {
+		htree_fail(w, t->dir, errno);
+		t->dir = NULL;
+		return;
+	}
+
+	while ((de = readdir(d)) != NULL) {
+		if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) continue;
+
+		if ((p = (char *) malloc(dlen + strlen(de->d_name) + 2)) == NULL) {
+			die(109, (char *) error_to_string(CRYPT_MEM));
+		}
+		sprintf(p, slash ? "%s%s" : "%s/%s", t->dir, de->d_name);
+
+		if (lstat(p, &st) != 0) {
+			htree_fail(w, p, errno);
+		}
+		else if (S_ISDIR(st.st_mode)) {
+			htree_push(w, htree_newtask(ht, p, 0));
+		}
+		else if (S_ISREG(st.st_mode) && st.st_size < HBATCH_SMALL) {
+			if (g == NULL) g = htree_newtask(ht, NULL, HBATCH_GROUP);
+			g->item[g->n++].path = p;
+			if (g->n == HBATCH_GROUP) {
+				htree_push(w, g);
+				g = NULL;
+			}
+		}
+		else if (S_ISREG(st.st_mode)) {
+			b = htree_newtask(ht, NULL, 1);
+			b->n = 1;
+			b->item[0].path = p;
+			htree_push(w, b);
+		}
+		else free(p);
+	}
+	closedir(d);
+
+	if (g) htree_push(w, g);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_thread()
+*
+*  Description: Worker loop: runs its own tasks, newest first,
+*               then steals the oldest ones of the others, and
+*               sleeps while there is nothing to take but tasks
+*               are still running (they may queue more)
+*
+*---------------------------------------------------------*/
+static void *htree_thread(void *arg)
+{
+	htree_worker *w = (htree_worker *) arg;
+	htree_state *ht = w->ht;
+	htree_task *t;
+	unsigned long gen;
+	bool quit;
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&ht->lock);
+		gen = ht->gen;
+		pthread_mutex_unlock(&ht->lock);
+
+		t = htree_take(w, false);
+		for (i = 1; ! t && i < ht->threads; i++) {
+			t = htree_take(&ht->worker[(w->id + i) % ht->threads], true);
+		}
+
+		if (t) {
+			if (t->dir) {
+				htree_scan(w, t);
+				free(t->dir);
+				free(t);
+			}
+			else {
+				hbatch_group(ht->ha, ht->nha, t->item, t->n, w->buf, false);
+				t->next = w->done;
+				w->done = t;
+			}
+
+			pthread_mutex_lock(&ht->lock);
+			if (--ht->pending == 0) pthread_cond_broadcast(&ht->cond);
+			pthread_mutex_unlock(&ht->lock);
+			continue;
+		}
+
+		pthread_mutex_lock(&ht->lock);
+		while (ht->pending > 0 && ht->gen == gen) pthread_cond_wait(&ht->cond, &ht->lock);
+		quit = (ht->pending == 0);
+		pthread_mutex_unlock(&ht->lock);
+
+		if (quit) break;
+	}
+
+	return NULL;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_cmp()
+*
+*  Description: qsort() comparison of two results by path, byte
+*               by byte, as "LC_ALL=C sort" orders them
+*
+*---------------------------------------------------------*/
+static int htree_cmp(const void *a, const void *b)
+{
+	return strcmp((*(hbatch_item * const *) a)->path, (*(hbatch_item * const *) b)->path);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    htree_run()
+*
+*  Description: Hashes every regular file under dir and prints
+*               a sha256sum style line per file, sorted by path
+*
+*  On Entry:    ha, nha = the algorithms, see hash_algo_list()
+*               dir = the top of the tree
+*               threads = number of workers, the calling thread
+*                         being one of them
+*               out = where the lines go
+*
+*  Returns:     the number of files (or directories) that could
+*               not be read, those are reported on stderr
+*
+*---------------------------------------------------------*/
+int htree_run(hash_algo *ha, int nha, char *dir, int threads, FILE *out)
+{
+	htree_state ht;
+	htree_task *t, *next;
+	hbatch_item **all;
+	char *root;
+	size_t n = 0, i;
+	int failed = 0;
+
+	if (threads < 1) threads = 1;
+
+	memset(&ht, 0, sizeof(htree_state));
+	ht.ha = ha;
+	ht.nha = nha;
+	ht.outlen = hash_algo_outlen(ha, nha);
+	ht.threads = threads;
+	if ((ht.worker = (htree_worker *) calloc(threads, sizeof(htree_worker))) == NULL) {
+		die(109, (char *) error_to_string(CRYPT_MEM));
+	}
+
+	pthread_mutex_init(&ht.lock, NULL);
+	pthread_cond_init(&ht.cond, NULL);
+
+	for (i = 0; i < (size_t) threads; i++) {
+		ht.worker[i].ht = &ht;
+		ht.worker[i].id = (int) i;
+		ht.worker[i].buf = (unsigned char *) malloc(HBATCH_GROUP * HBATCH_SMALL);
+		pthread_mutex_init(&ht.worker[i].dq.lock, NULL);
+	}
+
+	if ((root = (char *) malloc(strlen(dir) + 1)) == NULL) die(109, (char *) error_to_string(CRYPT_MEM));
+	strcpy(root, dir);
+	htree_push(&ht.worker[0], htree_newtask(&ht, root, 0));
+
+	/* worker 0 is the calling thread. only the workers that could be */
+	/* started steal from each other, they see how many once the lock */
+	/* is released                                                    */
+	pthread_mutex_lock(&ht.lock);
+	for (i = 1; i < (size_t) threads; i++) {
+		if (pthread_create(&ht.worker[i].tid, NULL, htree_thread, &ht.worker[i]) != 0) break;
+	}
+	ht.threads = (int) i;
+	pthread_mutex_unlock(&ht.lock);
+
+	htree_thread(&ht.worker[0]);
+	for (i = 1; i < (size_t) ht.threads; i++) pthread_join(ht.worker[i].tid, NULL);
+
+	/* gather the results of all workers and sort them by path */
+	for (i = 0; i < (size_t) threads; i++) {
+		for (t = ht.worker[i].done; t; t = t->next) n += t->n;
+	}
+	if ((all = (hbatch_item **) malloc((n + 1) * sizeof(hbatch_item *))) == NULL) {
+		die(109, (char *) error_to_string(CRYPT_MEM));
+	}
+	n = 0;
+	for (i = 0; i < (size_t) threads; i++) {
+		for (t = ht.worker[i].done; t; t = t->next) {
+			size_t j;
+			for (j = 0; j < t->n; j++) all[n++] = &t->item[j];
+		}
+	}
+	qsort(all, n, sizeof(hbatch_item *), htree_cmp);
+
+	for (i = 0; i < n; i++) failed += hbatch_report(out, ha, nha, all[i]);
+
+	for (i = 0; i < (size_t) threads; i++) {
+		for (t = ht.worker[i].done; t; t = next) {
+			size_t j;
+			next = t->next;
+			for (j = 0; j < t->n; j++) free(t->item[j].path);
+			free(t);
+		}
+		free(ht.worker[i].buf);
+		free(ht.worker[i].dq.task);
+		pthread_mutex_destroy(&ht.worker[i].dq.lock);
+	}
+	pthread_cond_destroy(&ht.cond);
+	pthread_mutex_destroy(&ht.lock);
+	free(ht.worker);
+	free(all);
+
+	return failed;
+}
@@ -17,16 +17,19 @@
 #define DEFAULT_HASH "sha3-256"
 #define DEFAULT_CIPHER "aes"
 #define MULTI2_KEYSIZE 40
+#define MAX_CHUNK (1024L * 1024 * 1024)
 
 #define CIP_OPTIONS {"-v", "-h", "-s", "-f", "-ts", "-tf", "-u", "-len", "-us", "-uf", \
-                     "-be", "-bd", "-es", "-ef", "-ds", "-df", "-c", "-a"}
+                     "-be", "-bd", "-es", "-ef", "-ds", "-df", "-c", "-a", "-chunk", "-j", \
+                     "--files-from", "-0", "-td", "--check", "--cache", "-m", \
+                     "--offset", "--length", "-r", "-ru", "-rk", "-o", "--seed"}
 
 #define HASH_ALGORITHMS { "md2", "md4", "md5", "sha1", "sha224", "sha256", "sha384", \
 			"sha512", "sha512-224", "sha512-256", "sha3-224", "sha3-256", "sha3-384", "sha3-512", \
 			"whirlpool", "blake2b-160", "blake2b-256", "blake2b-384", "blake2b-512", \
 			"tiger", "blake2s-128", "blake2s-160", "blake2s-224", "blake2s-256", \
 			"rmd128", "rmd160", "rmd256", "rmd320", "chc_hash", "siphash", \
-            "shake3-128", "shake3-256", "crc32", "adler32" }
+            "shake3-128", "shake3-256", "crc32", "adler32", "blake3" }
 
 #define CIPHERS { "aes", "blowfish", "xtea", "rc2", "rc5", "rc6", \
             "twofish", "safer-k64", "safer-sk64", "safer-k128", "safer-sk128", \
@@ -79,6 +82,25 @@
             {142, "error writing output file: %s"}, \
             {143, "error reading IV from input: %s"}, \
             {144, "ctr_decrypt error: %s"}, \
+            {145, "invalid chunk size: %s"}, \
+            {146, "invalid number of threads: %s"}, \
+            {147, "hash length (-len) cannot be more than %s bytes"}, \
+            {148, "%s file(s) could not be hashed"}, \
+            {149, "\"%s\" is not a directory"}, \
+            {150, "%s file(s) failed the check"}, \
+            {151, "no properly formatted lines found in %s"}, \
+            {152, "at most %s hashing algorithms can be given at once"}, \
+            {153, "%s failed authentication: wrong key, or the data is damaged or cut short"}, \
+            {154, "unable to set up the sealed format: %s"}, \
+            {155, "invalid mode: %s"}, \
+            {156, "%s has 64-bit blocks, too small for gcm. try -m chacha20poly1305 or -m ctr"}, \
+            {157, "invalid offset or length: %s"}, \
+            {158, "--offset and --length only go with -ds and -df"}, \
+            {159, "invalid count: %s"}, \
+            {160, "key length (-len) for -rk must be 1 to %s bytes"}, \
+            {161, "unable to generate random data: %s"}, \
+            {162, "-o and --seed only go with -r, -ru and -rk"}, \
+            {163, "unable to start the threads of the cipher pipeline"}, \
             {0, NULL} }
 
 
@@ -29,6 +29,10 @@
 #include "cip.h"
 #include "hash.h"
 #include "nutsbox.h"
+#include "finput.h"
+#include "kpipe.h"
+#include "pctr.h"
+#include "kseal.h"
 
 
 /*---------------------------------------
@@ -41,8 +45,21 @@
 /* implementatin is in other.c */
 
 
+/* formats -m chooses from besides KSEAL_GCM and KSEAL_CHACHA20POLY1305 */
+#define KRYPT_AUTO -1         /* gcm files for 128-bit ciphers, else ctr */
+#define KRYPT_CTR 0           /* IV || CTR, as written by v0.53          */
+
+/* options to krypt() beyond the cipher, key and hash */
+typedef struct {
+	size_t chunk;             /* bytes per pipeline chunk (-chunk) */
+	int threads;              /* CTR worker threads (-j)           */
+	int aead;                 /* format to encrypt to (-m)         */
+	long long offset;         /* first byte to decrypt (--offset)  */
+	long long length;         /* bytes to decrypt, -1 for all      */
+} krypt_opts;
+
 /* implementations is in cipher.c */
-char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher, char *inkey, char *algo);
+char * krypt (bool is_file, bool is_encrypt, char *in, char *out, char *cipher, char *inkey, char *algo, krypt_opts *opts);
 #if defined (_WIN32) || defined(_WIN64)
 char * readkey(char * prompt);
 #endif
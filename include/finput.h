@@ -0,0 +1,61 @@
+#ifndef FINPUT_H_INCLUDED
+#define FINPUT_H_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/* files smaller than this are read rather than mapped */
+#define FINPUT_MAP_MIN (64 * 1024)
+
+/* largest chunk handed out at a time from a mapped file */
+#define FINPUT_MAP_WINDOW (4 * 1024 * 1024)
+
+
+/*----------------------------
+*   Input source
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+*  A source of input bytes. Regular files are memory-mapped and
+*  handed out in place; pipes, special files, small files and
+*  platforms without mmap fall back to read() into buf. Strings
+*  are wrapped with finput_mem() and handed out in place as well.
+*/
+typedef struct {
+	int fd;                       /* -1 for an in-memory source         */
+	const unsigned char *data;    /* mapped file or in-memory source    */
+	unsigned char *buf;           /* read() buffer when not mapped      */
+	size_t bufsize;
+	size_t size;                  /* size of data                       */
+	size_t pos;                   /* bytes handed out so far            */
+	size_t end;                   /* input stops here, see finput_range */
+	size_t keep;                  /* mapped bytes behind pos to keep    */
+	size_t released;              /* mapped bytes given back so far     */
+	bool mapped;
+	bool eof;
+} finput;
+
+
+/* true if finput_next() hands out the source in place */
+#define finput_inplace(fi) ((fi)->fd < 0 || (fi)->mapped)
+
+/* implementation is in finput.c */
+int finput_open(finput *fi, char *fname, size_t bufsize);
+void finput_mem(finput *fi, const unsigned char *data, size_t size);
+long finput_next(finput *fi, const unsigned char **data, size_t max);
+long finput_read(finput *fi, unsigned char *dst, size_t max);
+long long finput_size(finput *fi);
+int finput_range(finput *fi, size_t off, size_t len);
+void finput_close(finput *fi);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // FINPUT_H_INCLUDED
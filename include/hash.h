@@ -9,6 +9,10 @@
 #include <sys/time.h>
 
 
+/* size of the chunks a file is read in when hashing it */
+#define HASH_READ_BUFSIZE (64 * 1024)
+
+
 /*----------------------------
 *   Hashing functions
 *---------------------------*/
@@ -16,13 +20,74 @@
 	extern "C" {
 #endif
 
+/* incremental siphash state, see siphash24_init() */
+typedef struct {
+	uint64_t v0, v1, v2, v3;
+	uint64_t total;
+	unsigned char buf[8];
+	int buflen;
+} siphash24_state;
+
+/* kinds of hash_algo */
+#define HASH_DESC    0      /* an entry of hash_descriptor[] */
+#define HASH_SHAKE   1
+#define HASH_CRC32   2
+#define HASH_ADLER32 3
+#define HASH_SIPHASH 4
+
+/* largest digest hash_algo_file() and hash_algo_buf() produce */
+#define HASH_MAX_DIGEST MAXBLOCKSIZE
+
+/*
+*  An algorithm from HASH_ALGORITHMS resolved once, so many inputs
+*  can be hashed with it (from several threads) without dying on
+*  the first one that cannot be read. See hash_algo_init().
+*/
+typedef struct {
+	char *name;
+	int kind;
+	int idx;                /* index into hash_descriptor[], HASH_DESC   */
+	int bits;               /* 128 or 256, HASH_SHAKE                   */
+	unsigned long outlen;   /* size of the digest in bytes              */
+	char *key;              /* HASH_SIPHASH                             */
+} hash_algo;
+
+/* most algorithms hashed at once, e.g., -tf md5,sha256,sha3-256 */
+#define HASH_MAX_ALGOS 8
+
+/* the state of a hash_algo part way through an input */
+typedef struct {
+	hash_algo *ha;
+	union {
+		crc32_state crc;
+		adler32_state adler;
+		siphash24_state sip;
+		hash_state md;
+	} st;
+} hash_ctx;
+
+/* the update step of a hashing algorithm, as called by hash_stream() */
+typedef int (*hash_update_fn)(void *ctx, const unsigned char *in, unsigned long len);
+
 /* implementatin is in csiphash.c */
 uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]);
+void siphash24_init(siphash24_state *st, const char key[16]);
+void siphash24_update(siphash24_state *st, const void *src, unsigned long src_sz);
+uint64_t siphash24_final(siphash24_state *st);
 
 /* implementation is in hash.c */
 char * crc32(bool is_file, char *in);
 char * adler32(bool is_file, char *in);
 char * hash(char *in, char *algo, bool is_file, char *key);
+int hash_stream(char *fname, hash_update_fn update, void *ctx);
+void hash_algo_init(hash_algo *ha, char *algo, char *key, int len);
+int hash_algo_list(hash_algo *ha, char *list, char *key, int len);
+unsigned long hash_algo_outlen(hash_algo *ha, int nha);
+int hash_ctx_init(hash_ctx *c, hash_algo *ha);
+int hash_ctx_update(void *ctx, const unsigned char *in, unsigned long len);
+int hash_ctx_done(hash_ctx *c, unsigned char *out);
+int hash_algo_file(hash_algo *ha, char *fname, unsigned char *out);
+int hash_algo_buf(hash_algo *ha, const unsigned char *in, unsigned long len, unsigned char *out);
 unsigned char * hash_md5(unsigned char *msg);
 unsigned char * shakehash(int bits, char *in, long size);
 unsigned char * getshake(bool is_file, int bits, char *in, int outlen);
@@ -0,0 +1,79 @@
+#ifndef HBATCH_H_INCLUDED
+#define HBATCH_H_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "hash.h"
+#include "finput.h"
+#include "hmulti.h"
+
+
+/* most files a worker takes from the batch at a time */
+#define HBATCH_GROUP 16
+
+/* files smaller than this are read whole and hashed side by side */
+#define HBATCH_SMALL FINPUT_MAP_MIN
+
+
+/*----------------------------
+*   Batch hashing
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* one file of the batch */
+typedef struct {
+	char *path;
+	unsigned char *digest;        /* hash_algo_outlen() bytes         */
+	int err;                      /* as from hash_algo_file()         */
+	int errnum;                   /* errno if err is not CRYPT_OK     */
+	bool done;
+} hbatch_item;
+
+/*
+*  Files hashed by a pool of threads. Workers take groups of
+*  consecutive files, the small ones of a group being hashed
+*  together through hash_memory_batch(), while the calling
+*  thread reports the results in the order the files were given.
+*  With several algorithms and fewer files than threads, the spare
+*  threads go to running the algorithms of a file side by side.
+*/
+typedef struct {
+	hash_algo *ha;
+	int nha;                      /* number of algorithms             */
+	bool fanout;                  /* see hmulti_file()                */
+	hbatch_item *item;
+	size_t n;
+	size_t next;                  /* first file not yet taken         */
+	size_t group;                 /* files taken at a time            */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} hbatch_state;
+
+/* true if the name of a file needs escaping in a sha256sum line */
+#define hbatch_escaped(path) (strpbrk((path), "\\\n") != NULL)
+
+/* called for each file of hbatch_hash() once it is done */
+typedef int (*hbatch_report_fn)(hbatch_item *it, void *ctx);
+
+
+/* implementation is in hbatch.c */
+char ** hbatch_list(char *listname, bool nul, char **paths, size_t *n);
+int hbatch_hash(hash_algo *ha, int nha, hbatch_item *item, size_t n, int threads, hbatch_report_fn report, void *ctx);
+int hbatch_run(hash_algo *ha, int nha, char **paths, size_t n, int threads, FILE *out);
+void hbatch_name(FILE *out, char *path);
+void hbatch_print(FILE *out, hash_algo *ha, int nha, const unsigned char *digest, char *path);
+int hbatch_report(FILE *out, hash_algo *ha, int nha, hbatch_item *it);
+void hbatch_group(hash_algo *ha, int nha, hbatch_item *item, size_t count, unsigned char *buf, bool fanout);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // HBATCH_H_INCLUDED
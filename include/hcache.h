@@ -0,0 +1,82 @@
+#ifndef HCACHE_H_INCLUDED
+#define HCACHE_H_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hash.h"
+
+
+/* first bytes of a cache file, and the layout it has */
+#define HCACHE_MAGIC "cipcache"
+#define HCACHE_VERSION 2
+
+/* files changed this close to the start of a check are not cached */
+#define HCACHE_RACY_NS 2000000000ULL
+
+
+/*----------------------------
+*   Digest cache
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* what stat() says about a file, a cached digest is only used if
+*  none of it changed */
+typedef struct {
+	uint64_t dev;
+	uint64_t ino;
+	uint64_t size;
+	uint64_t mtime_ns;
+} hcache_key;
+
+/* a cache file starts with this, followed by count records of a
+*  hcache_key and a digest, sorted by dev and ino */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t reclen;              /* bytes per record                 */
+	char algo[32];                /* what the digests are             */
+	uint32_t outlen;              /* bytes per digest, e.g., -len     */
+	uint32_t reserved;
+	unsigned char keyfp[32];      /* sha256 of the key, e.g., siphash */
+	uint64_t count;
+} hcache_header;
+
+/*
+*  Digests of files from the last check, looked up in place in
+*  the mapped cache file. hcache_save() replaces the file with
+*  the digests of the files seen by this check.
+*/
+typedef struct {
+	char *fname;
+	hash_algo *ha;
+	size_t reclen;
+	unsigned char keyfp[32];      /* as in hcache_header              */
+	const unsigned char *rec;     /* records of the cache file        */
+	size_t count;
+	void *map;                    /* the mapped (or read) cache file  */
+	size_t mapsize;
+	bool mapped;
+	unsigned char *add;           /* records for hcache_save()        */
+	size_t nadd, capadd;
+} hcache;
+
+
+/* implementation is in hcache.c */
+void hcache_open(hcache *hc, char *fname, hash_algo *ha);
+bool hcache_stat(char *path, hcache_key *k);
+const unsigned char * hcache_find(hcache *hc, const hcache_key *k);
+void hcache_add(hcache *hc, const hcache_key *k, const unsigned char *digest);
+int hcache_save(hcache *hc, uint64_t since_ns);
+void hcache_close(hcache *hc);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // HCACHE_H_INCLUDED
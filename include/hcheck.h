@@ -0,0 +1,41 @@
+#ifndef HCHECK_H_INCLUDED
+#define HCHECK_H_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "hash.h"
+#include "hbatch.h"
+#include "hcache.h"
+
+
+/*----------------------------
+*   Manifest check
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* what hcheck_run() keeps while the files are hashed */
+typedef struct {
+	hash_algo *ha;
+	FILE *out;
+	unsigned char *expect;        /* digests listed in the manifest   */
+	hcache_key *key;              /* of each file, if has_key         */
+	bool *has_key;
+	hcache *cache;                /* NULL without --cache             */
+	hbatch_item *item;
+	size_t mismatch;
+	size_t unreadable;
+} hcheck_state;
+
+
+/* implementation is in hcheck.c */
+int hcheck_run(hash_algo *ha, char *manifest, char *cachefile, int threads, FILE *out);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // HCHECK_H_INCLUDED
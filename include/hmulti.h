@@ -0,0 +1,52 @@
+#ifndef HMULTI_H_INCLUDED
+#define HMULTI_H_INCLUDED
+
+#include <stdbool.h>
+
+#include "hash.h"
+#include "finput.h"
+#include "tpool.h"
+
+
+/* read() buffer of hmulti_file(), bigger than HASH_READ_BUFSIZE so
+*  the workers meet less often on pipes */
+#define HMULTI_READ_BUFSIZE (1024 * 1024)
+
+
+/*----------------------------
+*   Multi-digest hashing
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* one worker: the algorithm it runs over every chunk */
+typedef struct {
+	hash_ctx ctx;
+	int err;
+} hmulti_worker;
+
+/*
+*  Several algorithms over one read of the input. Each chunk is
+*  handed to every worker, one per algorithm, and the next chunk
+*  is read once they are all done with it.
+*/
+typedef struct {
+	int nha;
+	bool threaded;
+	hmulti_worker worker[HASH_MAX_ALGOS];
+	const unsigned char *data;    /* the chunk being hashed        */
+	unsigned long len;
+	tpool pool;
+} hmulti_state;
+
+
+/* implementation is in hmulti.c */
+int hmulti_file(hash_algo *ha, int nha, char *fname, unsigned char *out, bool threaded);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // HMULTI_H_INCLUDED
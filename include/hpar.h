@@ -0,0 +1,59 @@
+#ifndef HPAR_H_INCLUDED
+#define HPAR_H_INCLUDED
+
+#include <stdbool.h>
+#include <tomcrypt.h>
+
+#include "tpool.h"
+
+
+/* BLAKE3 chunk size, and the size of a BLAKE3 digest */
+#define HPAR_CHUNK 1024
+#define HPAR_OUTLEN 32
+
+/* subtrees handed to a worker are not smaller than this */
+#define HPAR_MIN_SUBTREE (64 * 1024)
+
+
+/*----------------------------
+*   Parallel BLAKE3
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* one worker: the subtree it is given and its chaining value */
+typedef struct {
+	const unsigned char *in;
+	unsigned long len;
+	ulong64 chunk;                /* index of its first chunk      */
+	unsigned char cv[HPAR_OUTLEN];
+	int err;
+} hpar_worker;
+
+/*
+*  BLAKE3 split across threads. Whole chunks of the input are
+*  cut into equal subtrees, one per worker, and their chaining
+*  values are added to the hash state in order, so the digest
+*  is that of blake3_process() over the whole input.
+*/
+typedef struct {
+	int threads;                  /* workers started, plus the caller */
+	hash_state md;
+	hpar_worker *worker;
+	tpool pool;
+} hpar_state;
+
+
+/* implementation is in hpar.c */
+int hpar_start(hpar_state *hp, int threads);
+int hpar_process(void *ctx, const unsigned char *in, unsigned long len);
+int hpar_done(hpar_state *hp, unsigned char *out);
+int hpar_file(char *fname, int threads, unsigned char *out);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // HPAR_H_INCLUDED
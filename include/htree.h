@@ -0,0 +1,78 @@
+#ifndef HTREE_H_INCLUDED
+#define HTREE_H_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "hash.h"
+#include "hbatch.h"
+
+
+/*----------------------------
+*   Directory tree hashing
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+*  A unit of work: a directory to scan, or a group of files to
+*  hash (up to HBATCH_GROUP small files, or a single big one).
+*  Hashed groups are kept on a list of the worker until the end.
+*/
+typedef struct htree_task {
+	char *dir;                    /* directory to scan, or NULL       */
+	hbatch_item *item;            /* files to hash                    */
+	size_t n;
+	struct htree_task *next;
+} htree_task;
+
+/* the tasks of one worker, taken from the back by the worker and
+*  from the front by the others when they run out of their own */
+typedef struct {
+	htree_task **task;
+	size_t head, tail, cap;
+	pthread_mutex_t lock;
+} htree_deque;
+
+struct htree_state;
+
+typedef struct {
+	struct htree_state *ht;
+	int id;
+	pthread_t tid;
+	htree_deque dq;
+	htree_task *done;             /* hashed groups                    */
+	unsigned char *buf;           /* see hbatch_group()               */
+} htree_worker;
+
+/*
+*  A work-stealing pool walking a directory tree. Scanning a
+*  directory queues its subdirectories and its files on the
+*  deque of the worker, so while one worker is busy with a huge
+*  file the rest of its queue goes to the idle ones.
+*/
+typedef struct htree_state {
+	hash_algo *ha;
+	int nha;                      /* number of algorithms             */
+	unsigned long outlen;         /* of their digests, back to back   */
+	int threads;
+	htree_worker *worker;
+	size_t pending;               /* tasks queued or running          */
+	unsigned long gen;            /* bumped whenever tasks are queued */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} htree_state;
+
+
+/* implementation is in htree.c */
+int htree_run(hash_algo *ha, int nha, char *dir, int threads, FILE *out);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // HTREE_H_INCLUDED
@@ -0,0 +1,54 @@
+#ifndef KPIPE_H_INCLUDED
+#define KPIPE_H_INCLUDED
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "finput.h"
+
+
+/* number of chunks in flight between the reader, cipher and writer */
+#define KPIPE_SLOTS 4
+
+/* default chunk size, see -chunk */
+#define KPIPE_CHUNK (4 * 1024 * 1024)
+
+/* kpipe_run() results */
+#define KPIPE_OK      0
+#define KPIPE_EREAD   1
+#define KPIPE_EWRITE  2
+#define KPIPE_ECIPHER 3
+#define KPIPE_EMEM    4
+#define KPIPE_ETHREAD 5
+
+
+/*----------------------------
+*   Cipher pipeline
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+*  The cipher stage: transforms len bytes of in into out and
+*  returns CRYPT_OK. in and out may be the same buffer.
+*/
+typedef int (*kpipe_fn)(const unsigned char *in, unsigned char *out, unsigned long len, void *ctx);
+
+/*
+*  A cipher stage whose output differs in size: transforms len
+*  bytes of in into *outlen bytes of out. It is called once more
+*  with len 0 at the end of input, to put out what it holds back.
+*/
+typedef int (*kpipe_sfn)(const unsigned char *in, unsigned long len, unsigned char *out, unsigned long *outlen, void *ctx);
+
+/* implementation is in kpipe.c */
+int kpipe_run(finput *fi, FILE *fo, size_t chunk, kpipe_fn fn, void *ctx, int *err);
+int kpipe_run_sized(finput *fi, FILE *fo, size_t chunk, size_t outmax, kpipe_sfn sfn, void *ctx, int *err);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // KPIPE_H_INCLUDED
@@ -0,0 +1,107 @@
+#ifndef KSEAL_H_INCLUDED
+#define KSEAL_H_INCLUDED
+
+#include <stdbool.h>
+#include <tomcrypt.h>
+
+#include "tpool.h"
+
+
+/*
+*  Layout of the header of a sealed file, which is also the
+*  associated data of every record:
+*
+*     0  magic "CIPAEAD" and the format version
+*     8  aead (KSEAL_GCM or KSEAL_CHACHA20POLY1305)
+*     9  log2 of the plaintext bytes per record
+*    10  two reserved bytes, zero
+*    12  salt the file key is derived with
+*    28  name of the GCM cipher, NUL padded
+*/
+#define KSEAL_MAGIC "CIPAEAD"
+#define KSEAL_VERSION 1
+#define KSEAL_MAGICLEN 8
+#define KSEAL_SALTLEN 16
+#define KSEAL_NAMELEN 16
+#define KSEAL_HEADER (12 + KSEAL_SALTLEN + KSEAL_NAMELEN)
+
+/* aead ids, as stored in the header */
+#define KSEAL_GCM 1
+#define KSEAL_CHACHA20POLY1305 2
+
+/* record size, 1 << KSEAL_SHIFT bytes of plaintext plus a tag */
+#define KSEAL_SHIFT 16
+#define KSEAL_MIN_SHIFT 10
+#define KSEAL_MAX_SHIFT 24
+#define KSEAL_TAG 16
+
+/* size of the GCM or ChaCha20 key derived for the file */
+#define KSEAL_KEYLEN 32
+
+
+/*----------------------------
+*   Sealed (AEAD) records
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+struct kseal_state;
+
+/* one worker: its own AEAD state and the records it is given */
+typedef struct {
+	struct kseal_state *ks;
+	union {
+		gcm_state gcm;
+		chacha20poly1305_state cp;
+	} aead;
+	const unsigned char *in;
+	unsigned char *out;
+	ulong64 first;                /* index of its first record     */
+	unsigned long count;
+	int err;
+} kseal_worker;
+
+/*
+*  A file cut into records of recsize plaintext bytes, sealed
+*  one by one with the nonce derived from the record index. The
+*  last record is shorter than recsize (empty if need be) and is
+*  sealed with the final flag set in its nonce, so a file cut
+*  short at a record boundary is noticed as well. Records are
+*  independent, so they are spread over several threads.
+*/
+typedef struct kseal_state {
+	bool encrypt;
+	int aead;
+	int cipher;                   /* GCM cipher index              */
+	unsigned long recsize;        /* plaintext bytes per record    */
+	unsigned char header[KSEAL_HEADER];
+	unsigned char key[KSEAL_KEYLEN];  /* file key, for ChaCha20   */
+	ulong64 index;                /* next record                   */
+	unsigned char *carry;         /* a record split between calls  */
+	unsigned long carried;
+	ulong64 skip;                 /* output bytes before the range */
+	ulong64 left;                 /* output bytes left in it       */
+	bool cut;                     /* the range ends before the last record */
+	bool past;                    /* it may start past the end of a pipe   */
+	int threads;                  /* workers started, plus the caller */
+	kseal_worker *worker;
+	tpool pool;
+} kseal_state;
+
+
+/* implementation is in kseal.c */
+int kseal_header(unsigned char *header, int aead, const char *cipher, const unsigned char *salt);
+bool kseal_is_sealed(const unsigned char *magic);
+int kseal_start(kseal_state *ks, bool encrypt, const unsigned char *header, const unsigned char *key, unsigned long keylen, int threads);
+void kseal_range(kseal_state *ks, long long body, ulong64 offset, ulong64 length, ulong64 *from, ulong64 *len);
+size_t kseal_outmax(kseal_state *ks, size_t chunk);
+int kseal_crypt(const unsigned char *in, unsigned long len, unsigned char *out, unsigned long *outlen, void *ctx);
+void kseal_done(kseal_state *ks);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // KSEAL_H_INCLUDED
@@ -22,8 +22,10 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdint.h>
+#include <limits.h>
 #include <sys/time.h>
 #include <stdbool.h>
+#include <unistd.h>
 
 
 #define MAX_CHARS_PER_LINE 255
@@ -43,6 +45,8 @@
 char * readfile( char *fname, long *flen );
 char * bytox(unsigned char *bytes, int size);
 bool isnum(char *snum);
+long long strtosize(char *s);
+int numcpus(void);
 uint64_t gettime_ns();
 char *pullstr( char *s1, int pos, int length );
 char *concat( char *s1, char *s2 );
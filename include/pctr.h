@@ -0,0 +1,67 @@
+#ifndef PCTR_H_INCLUDED
+#define PCTR_H_INCLUDED
+
+#include <stdbool.h>
+#include <tomcrypt.h>
+
+#include "tpool.h"
+
+
+/* most threads -j accepts */
+#define PCTR_MAX_THREADS 256
+
+/* chunks are not split into segments smaller than this */
+#define PCTR_MIN_SEGMENT (64 * 1024)
+
+/* segment size per thread krypt() aims for when -chunk is not given */
+#define PCTR_SEGMENT (1024 * 1024)
+
+
+/*----------------------------
+*   Parallel CTR mode
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+struct pctr_state;
+
+/* one worker: its own CTR state and the segment it is given */
+typedef struct {
+	struct pctr_state *pc;
+	symmetric_CTR ctr;
+	const unsigned char *in;
+	unsigned char *out;
+	unsigned long len;
+	ulong64 pos;
+	int err;
+} pctr_worker;
+
+/*
+*  CTR mode (CTR_COUNTER_LITTLE_ENDIAN, full block counter) split
+*  across threads. Each worker positions its counter at IV plus the
+*  block number of its segment, so the output is the same as that
+*  of ctr_encrypt() over the whole stream.
+*/
+typedef struct pctr_state {
+	int threads;                  /* workers started, plus the caller */
+	int blocklen;
+	unsigned char IV[MAXBLOCKSIZE];
+	ulong64 pos;                  /* stream bytes processed so far */
+	pctr_worker *worker;
+	tpool pool;
+} pctr_state;
+
+
+/* implementation is in pctr.c */
+int pctr_start(pctr_state *pc, int cipher, const unsigned char *IV, const unsigned char *key, int keylen, int threads);
+int pctr_seek(symmetric_CTR *ctr, const unsigned char *IV, ulong64 pos);
+int pctr_crypt(const unsigned char *in, unsigned char *out, unsigned long len, void *ctx);
+void pctr_done(pctr_state *pc);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // PCTR_H_INCLUDED
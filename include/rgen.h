@@ -0,0 +1,78 @@
+#ifndef RGEN_H_INCLUDED
+#define RGEN_H_INCLUDED
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <tomcrypt.h>
+
+#include "tpool.h"
+
+
+/* what -r, -ru and -rk make */
+#define RGEN_BYTES 0
+#define RGEN_UUID 1
+#define RGEN_KEY 2
+
+/* random bytes of a -rk key, unless -len says otherwise */
+#define RGEN_KEYLEN 32
+#define RGEN_MAX_KEYLEN 1024
+
+/* output bytes a worker makes per job, at most */
+#define RGEN_SEGMENT (1024 * 1024)
+
+/* size of the ChaCha20 key of the stream */
+#define RGEN_SEEDLEN 32
+
+
+/*----------------------------
+*   Random data generation
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+struct rgen_state;
+
+/* one worker: its own ChaCha20 state and the records it is given */
+typedef struct {
+	struct rgen_state *rg;
+	chacha_state cs;
+	unsigned char *out;
+	ulong64 first;                /* index of its first record     */
+	unsigned long count;
+	int err;
+} rgen_worker;
+
+/*
+*  Records of reclen random bytes, each written out as linelen
+*  bytes: raw, a uuid4 line or a hex key line. Record i is made
+*  of bytes i * reclen on of the ChaCha20 keystream of the key,
+*  so a worker seeks straight to its records, and the output
+*  does not depend on the number of threads. Workers fill one
+*  buffer while the previous one is written.
+*/
+typedef struct rgen_state {
+	int kind;
+	unsigned long reclen;         /* random bytes per record       */
+	unsigned long linelen;        /* output bytes per record       */
+	unsigned char key[RGEN_SEEDLEN];
+	unsigned long perworker;      /* records per worker per job    */
+	unsigned char *buf[2];        /* a job is made in one, while   */
+	                              /* the other is written          */
+	int threads;                  /* parts of a job                */
+	rgen_worker *worker;
+	tpool pool;
+} rgen_state;
+
+
+/* implementation is in rgen.c */
+int rgen_start(rgen_state *rg, int kind, unsigned long keylen, const char *seed, int threads);
+int rgen_write(rgen_state *rg, ulong64 count, FILE *fo);
+void rgen_done(rgen_state *rg);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // RGEN_H_INCLUDED
@@ -0,0 +1,49 @@
+#ifndef TPOOL_H_INCLUDED
+#define TPOOL_H_INCLUDED
+
+#include <stdbool.h>
+#include <pthread.h>
+
+
+/*----------------------------
+*   Worker threads
+*---------------------------*/
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/* does part i of a job */
+typedef void (*tpool_fn)(void *ctx, int i);
+
+/*
+*  Threads that wait for a job and take its parts one at a time.
+*  The thread that waits for a job takes parts as well, so a job
+*  gets done even if fewer threads (or none) could be started.
+*/
+typedef struct {
+	int threads;                  /* workers actually started      */
+	pthread_t *tid;
+	tpool_fn fn;                  /* the job                       */
+	void *ctx;
+	int parts;                    /* parts of the job              */
+	int next;                     /* next part to be taken         */
+	int pending;                  /* parts not done yet            */
+	bool quit;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} tpool;
+
+
+/* implementation is in tpool.c */
+int tpool_start(tpool *tp, int threads);
+void tpool_post(tpool *tp, int parts, tpool_fn fn, void *ctx);
+void tpool_wait(tpool *tp);
+void tpool_run(tpool *tp, int parts, tpool_fn fn, void *ctx);
+void tpool_done(tpool *tp);
+
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif // TPOOL_H_INCLUDED
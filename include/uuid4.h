@@ -18,6 +18,7 @@ enum {
 
 int  uuid4_init(void);
 void uuid4_generate(char *dst);
+void uuid4_format(const unsigned char *b, char *dst);
 char * uuid4_gets(bool is_file, char *in);
 void to_uuid4(unsigned char * in, char *out);
 
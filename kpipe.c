@@ -0,0 +1,289 @@
+/*-------------------------------------------------------------------
+*  kpipe.c:        cipher pipeline implementation file
+*
+*  Description:    Moves a file through a cipher in large chunks.
+*                  A reader thread, the cipher stage (the calling
+*                  thread) and a writer thread pass KPIPE_SLOTS
+*                  buffers around a ring, so reading and writing
+*                  overlap with keystream generation.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <tomcrypt.h>
+
+#include "include/kpipe.h"
+
+
+/* life cycle of a slot: FREE -> READ -> DONE -> FREE ... */
+enum { SLOT_FREE, SLOT_READ, SLOT_DONE };
+
+typedef struct {
+	const unsigned char *in;      /* input, buf or in place   */
+	unsigned char *buf;           /* chunk bytes, output      */
+	unsigned char *rbuf;          /* input, if not buf        */
+	long len;                     /* 0 marks end of input     */
+	unsigned long outlen;         /* output bytes in buf      */
+	int state;
+} kslot;
+
+typedef struct {
+	finput *fi;
+	FILE *fo;
+	size_t chunk;
+	kslot slot[KPIPE_SLOTS];
+	int status;                   /* first error, KPIPE_OK    */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} kpipe;
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_wait()
+*
+*  Description: Blocks until slot s reaches state, or until
+*               another stage has failed
+*
+*  Returns:     KPIPE_OK, otherwise the failure
+*
+*---------------------------------------------------------*/
+static int kpipe_wait(kpipe *kp, kslot *s, int state)
+{
+	int status;
+
+	pthread_mutex_lock(&kp->lock);
+	while (s->state != state && kp->status == KPIPE_OK) {
+		pthread_cond_wait(&kp->cond, &kp->lock);
+	}
+	status = kp->status;
+	pthread_mutex_unlock(&kp->lock);
+
+	return status;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_post()
+*
+*  Description: Hands slot s to the next stage, or records
+*               the failure of the current one
+*
+*---------------------------------------------------------*/
+static void kpipe_post(kpipe *kp, kslot *s, int state, int status)
+{
+	pthread_mutex_lock(&kp->lock);
+	s->state = state;
+	if (status != KPIPE_OK && kp->status == KPIPE_OK) kp->status = status;
+	pthread_cond_broadcast(&kp->cond);
+	pthread_mutex_unlock(&kp->lock);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_reader()
+*
+*  Description: Reader stage. Mapped and in-memory input is
+*               passed on in place, anything else is read into
+*               the slot's own buffer.
+*
+*---------------------------------------------------------*/
+static void *kpipe_reader(void *arg)
+{
+	kpipe *kp = (kpipe *) arg;
+	kslot *s;
+	long n;
+	int i = 0;
+
+	do {
+		s = &kp->slot[i];
+		if (kpipe_wait(kp, s, SLOT_FREE) != KPIPE_OK) break;
+
+		if (finput_inplace(kp->fi)) n = finput_next(kp->fi, &s->in, kp->chunk);
+		else {
+			s->in = s->rbuf ? s->rbuf : s->buf;
+			n = finput_read(kp->fi, (unsigned char *) s->in, kp->chunk);
+		}
+		s->len = n;
+
+		kpipe_post(kp, s, SLOT_READ, (n < 0) ? KPIPE_EREAD : KPIPE_OK);
+		i = (i + 1) % KPIPE_SLOTS;
+	} while (n > 0);
+
+	return NULL;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_writer()
+*
+*  Description: Writer stage
+*
+*---------------------------------------------------------*/
+static void *kpipe_writer(void *arg)
+{
+	kpipe *kp = (kpipe *) arg;
+	kslot *s;
+	int i = 0;
+
+	for (;;) {
+		s = &kp->slot[i];
+		if (kpipe_wait(kp, s, SLOT_DONE) != KPIPE_OK) break;
+
+		if (fwrite(s->buf, 1, (size_t) s->outlen, kp->fo) != (size_t) s->outlen) {
+			kpipe_post(kp, s, SLOT_DONE, KPIPE_EWRITE);
+			break;
+		}
+		if (s->len == 0) break;
+
+		kpipe_post(kp, s, SLOT_FREE, KPIPE_OK);
+		i = (i + 1) % KPIPE_SLOTS;
+	}
+
+	return NULL;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_exec()
+*
+*  Description: Runs the input through fn, or through sfn
+*               whose output differs in size, and writes the
+*               result, chunk bytes of input at a time
+*
+*---------------------------------------------------------*/
+static int kpipe_exec(finput *fi, FILE *fo, size_t chunk, size_t outmax, kpipe_fn fn, kpipe_sfn sfn, void *ctx, int *err)
+{
+	kpipe kp;
+	kslot *s;
+	pthread_t reader, writer;
+	unsigned long outlen;
+	long n;
+	int i, started, status;
+
+	/* no point in buffers larger than an input of known size */
+	if (finput_inplace(fi) && fi->size < chunk) chunk = fi->size;
+	if (chunk < 16) chunk = 16;
+
+	/* sfn reads from a buffer of its own, fn works in place */
+	if (! sfn) outmax = chunk;
+
+	kp.fi = fi;
+	kp.fo = fo;
+	kp.chunk = chunk;
+	kp.status = KPIPE_OK;
+	*err = CRYPT_OK;
+
+	/* keep the chunks in flight resident when the input is mapped */
+	fi->keep = KPIPE_SLOTS * chunk;
+
+	for (i=0; i < KPIPE_SLOTS; i++) {
+		kp.slot[i].state = SLOT_FREE;
+		kp.slot[i].len = 0;
+		kp.slot[i].buf = (unsigned char *) malloc(outmax);
+		kp.slot[i].rbuf = (sfn && ! finput_inplace(fi)) ? (unsigned char *) malloc(chunk) : NULL;
+		if (kp.slot[i].buf == NULL || (sfn && ! finput_inplace(fi) && kp.slot[i].rbuf == NULL)) {
+			do {
+				free(kp.slot[i].buf);
+				free(kp.slot[i].rbuf);
+			} while (i-- > 0);
+			return KPIPE_EMEM;
+		}
+	}
+
+	pthread_mutex_init(&kp.lock, NULL);
+	pthread_cond_init(&kp.cond, NULL);
+
+	/* a stage that did not start would leave the others waiting */
+	/* on the ring, stopping it lets the reader finish           */
+	started = 0;
+	if (pthread_create(&reader, NULL, kpipe_reader, &kp) == 0) started++;
+	if (started == 1 && pthread_create(&writer, NULL, kpipe_writer, &kp) == 0) started++;
+	if (started < 2) {
+		pthread_mutex_lock(&kp.lock);
+		kp.status = KPIPE_ETHREAD;
+		pthread_cond_broadcast(&kp.cond);
+		pthread_mutex_unlock(&kp.lock);
+	}
+
+	/* cipher stage */
+	for (i=0; started == 2; i = (i + 1) % KPIPE_SLOTS) {
+		s = &kp.slot[i];
+		if (kpipe_wait(&kp, s, SLOT_READ) != KPIPE_OK) break;
+
+		/* the slot belongs to the writer once posted, sfn is
+		*  called at the end of input as well to flush */
+		n = s->len;
+		if (sfn) *err = sfn(s->in, (unsigned long) n, s->buf, &outlen, ctx);
+		else if (n > 0) *err = fn(s->in, s->buf, (unsigned long) n, ctx);
+		if (*err != CRYPT_OK) {
+			kpipe_post(&kp, s, SLOT_READ, KPIPE_ECIPHER);
+			break;
+		}
+		s->outlen = sfn ? outlen : (unsigned long) n;
+
+		kpipe_post(&kp, s, SLOT_DONE, KPIPE_OK);
+		if (n == 0) break;
+	}
+
+	if (started > 0) pthread_join(reader, NULL);
+	if (started > 1) pthread_join(writer, NULL);
+	pthread_cond_destroy(&kp.cond);
+	pthread_mutex_destroy(&kp.lock);
+
+	status = kp.status;
+	for (i=0; i < KPIPE_SLOTS; i++) {
+		free(kp.slot[i].buf);
+		free(kp.slot[i].rbuf);
+	}
+
+	return status;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_run()
+*
+*  Description: Runs the input through fn and writes the
+*               result, chunk bytes at a time
+*
+*  On Entry:    fi = the opened input
+*               fo = where the output goes
+*               chunk = bytes per chunk
+*               fn, ctx = the cipher stage and its state
+*               err = where to put fn's error, if any
+*
+*  Returns:     KPIPE_OK if successful, otherwise one of the
+*               KPIPE_E* codes
+*
+*---------------------------------------------------------*/
+int kpipe_run(finput *fi, FILE *fo, size_t chunk, kpipe_fn fn, void *ctx, int *err)
+{
+	return kpipe_exec(fi, fo, chunk, chunk, fn, NULL, ctx, err);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kpipe_run_sized()
+*
+*  Description: Like kpipe_run() for a stage whose output is
+*               not the size of its input (e.g., one that adds
+*               authentication tags)
+*
+*  On Entry:    outmax = the most bytes sfn puts out for a
+*                        chunk, or for its final call
+*               sfn = the stage, called once more with no
+*                     input at the end
+*
+*  Returns:     KPIPE_OK if successful, otherwise one of the
+*               KPIPE_E* codes
+*
+*---------------------------------------------------------*/
+int kpipe_run_sized(finput *fi, FILE *fo, size_t chunk, size_t outmax, kpipe_sfn sfn, void *ctx, int *err)
+{
+	return kpipe_exec(fi, fo, chunk, outmax, NULL, sfn, ctx, err);
+}
@@ -0,0 +1,524 @@
+/*-------------------------------------------------------------------
+*  kseal.c:        sealed (AEAD) file format implementation file
+*
+*  Description:    The input is cut into records of a fixed size,
+*                  each sealed with GCM or ChaCha20-Poly1305 under
+*                  a key derived for the file and a nonce made of
+*                  the record index. A record can be checked and
+*                  opened on its own, so records are spread over
+*                  several threads and every one is verified
+*                  before it is written out.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/kseal.h"
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_record()
+*
+*  Description: Seals or opens one record with the AEAD state
+*               of worker w
+*
+*  On Entry:    index = the record number
+*               final = true for the last record of the file
+*               in = len bytes of plaintext to seal, or len
+*                    bytes of ciphertext and the tag to open
+*               out = where the ciphertext and tag, or the
+*                     plaintext go
+*
+*  Returns:     CRYPT_OK if successful, CRYPT_ERROR if the
+*               record does not authenticate
+*
+*---------------------------------------------------------*/
+static int kseal_record(kseal_worker *w, ulong64 index, bool final, const unsigned char *in, unsigned long len, unsigned char *out)
+{
+	kseal_state *ks = w->ks;
+	unsigned char nonce[12], tag[KSEAL_TAG];
+	unsigned long taglen = KSEAL_TAG;
+	int err;
+
+	/* the record index, big endian, and the final flag */
+	memset(nonce, 0, sizeof(nonce));
+	STORE64H(index, nonce);
+	nonce[11] = final ? 1 : 0;
+
+	if (ks->aead == KSEAL_GCM) {
+		gcm_state *gcm = &w->aead.gcm;
+
+		/* the done() of the 128-bit block ciphers keeps the key, so
+		*  the state set up by gcm_init() is only reset */
+		if ((err = gcm_reset(gcm)) != CRYPT_OK) return err;
+		if ((err = gcm_add_iv(gcm, nonce, sizeof(nonce))) != CRYPT_OK) return err;
+		if ((err = gcm_add_aad(gcm, ks->header, KSEAL_HEADER)) != CRYPT_OK) return err;
+		if (ks->encrypt) err = gcm_process(gcm, (unsigned char *) in, len, out, GCM_ENCRYPT);
+		else err = gcm_process(gcm, out, len, (unsigned char *) in, GCM_DECRYPT);
+		if (err != CRYPT_OK) return err;
+		if ((err = gcm_done(gcm, tag, &taglen)) != CRYPT_OK) return err;
+	}
+	else {
+		chacha20poly1305_state *cp = &w->aead.cp;
+
+		/* chacha20poly1305_done() wipes the key, it is set again */
+		if ((err = chacha20poly1305_init(cp, ks->key, KSEAL_KEYLEN)) != CRYPT_OK) return err;
+		if ((err = chacha20poly1305_setiv(cp, nonce, sizeof(nonce))) != CRYPT_OK) return err;
+		if ((err = chacha20poly1305_add_aad(cp, ks->header, KSEAL_HEADER)) != CRYPT_OK) return err;
+		if (ks->encrypt) err = chacha20poly1305_encrypt(cp, in, len, out);
+		else err = chacha20poly1305_decrypt(cp, in, len, out);
+		if (err != CRYPT_OK) return err;
+		if ((err = chacha20poly1305_done(cp, tag, &taglen)) != CRYPT_OK) return err;
+	}
+
+	if (ks->encrypt) {
+		memcpy(out + len, tag, KSEAL_TAG);
+		return CRYPT_OK;
+	}
+
+	/* nothing of a record that does not authenticate is kept */
+	if (mem_neq(tag, in + len, KSEAL_TAG) != 0) {
+		zeromem(out, len);
+		return CRYPT_ERROR;
+	}
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_records()
+*
+*  Description: Seals or opens the full records given to
+*               worker w
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+static int kseal_records(kseal_worker *w)
+{
+	kseal_state *ks = w->ks;
+	unsigned long inrec = ks->encrypt ? ks->recsize : ks->recsize + KSEAL_TAG;
+	unsigned long outrec = ks->encrypt ? ks->recsize + KSEAL_TAG : ks->recsize;
+	unsigned long i;
+	int err;
+
+	for (i = 0; i < w->count; i++) {
+		err = kseal_record(w, w->first + i, false, w->in + i * inrec, ks->recsize, w->out + i * outrec);
+		if (err != CRYPT_OK) return err;
+	}
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_part()
+*
+*  Description: Does the records of worker i, as a part of a
+*               tpool job
+*
+*---------------------------------------------------------*/
+static void kseal_part(void *ctx, int i)
+{
+	kseal_state *ks = (kseal_state *) ctx;
+
+	ks->worker[i].err = kseal_records(&ks->worker[i]);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_run()
+*
+*  Description: Seals or opens count full records from in to
+*               out, split among the workers, starting with
+*               record ks->index
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+static int kseal_run(kseal_state *ks, const unsigned char *in, unsigned char *out, unsigned long count)
+{
+	unsigned long inrec = ks->encrypt ? ks->recsize : ks->recsize + KSEAL_TAG;
+	unsigned long outrec = ks->encrypt ? ks->recsize + KSEAL_TAG : ks->recsize;
+	unsigned long per = (count + ks->threads - 1) / ks->threads, done = 0;
+	int i, busy = 0, err = CRYPT_OK;
+
+	for (i = 0; i < ks->threads; i++) {
+		kseal_worker *w = &ks->worker[i];
+
+		w->in = in + done * inrec;
+		w->out = out + done * outrec;
+		w->first = ks->index + done;
+		w->count = (count - done < per) ? count - done : per;
+		w->err = CRYPT_OK;
+		done += w->count;
+		if (i > 0 && w->count > 0) busy++;
+	}
+
+	/* the workers with records come first */
+	if (busy) tpool_run(&ks->pool, busy + 1, kseal_part, ks);
+	else kseal_part(ks, 0);
+
+	ks->index += count;
+
+	for (i = 0; i < ks->threads; i++) {
+		if (ks->worker[i].err != CRYPT_OK) err = ks->worker[i].err;
+	}
+
+	return err;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_header()
+*
+*  Description: Makes the header of a sealed file
+*
+*  On Entry:    header = KSEAL_HEADER bytes to fill in
+*               aead = KSEAL_GCM or KSEAL_CHACHA20POLY1305
+*               cipher = the cipher GCM is used with, it must
+*                        have 128-bit blocks
+*               salt = KSEAL_SALTLEN random bytes
+*
+*  Returns:     CRYPT_OK, CRYPT_INVALID_CIPHER if the cipher
+*               cannot be used with GCM
+*
+*---------------------------------------------------------*/
+int kseal_header(unsigned char *header, int aead, const char *cipher, const unsigned char *salt)
+{
+	int idx;
+
+	memset(header, 0, KSEAL_HEADER);
+	memcpy(header, KSEAL_MAGIC, KSEAL_MAGICLEN - 1);
+	header[KSEAL_MAGICLEN - 1] = KSEAL_VERSION;
+	header[8] = (unsigned char) aead;
+	header[9] = KSEAL_SHIFT;
+	memcpy(header + 12, salt, KSEAL_SALTLEN);
+
+	if (aead == KSEAL_GCM) {
+		idx = find_cipher_builtin(cipher);
+		if (idx == -1 || cipher_descriptor[idx].block_length != 16 || strlen(cipher) >= KSEAL_NAMELEN) {
+			return CRYPT_INVALID_CIPHER;
+		}
+		memcpy(header + 12 + KSEAL_SALTLEN, cipher, strlen(cipher));
+	}
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_is_sealed()
+*
+*  Description: Tells a sealed file from the IV || CTR files
+*               of earlier versions by its first KSEAL_MAGICLEN
+*               bytes
+*
+*  Returns:     true if they are the magic of a sealed file
+*
+*---------------------------------------------------------*/
+bool kseal_is_sealed(const unsigned char *magic)
+{
+	return memcmp(magic, KSEAL_MAGIC, KSEAL_MAGICLEN - 1) == 0;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_start()
+*
+*  Description: Checks the header, derives the file key from
+*               key and the salt (HKDF-SHA256, the header being
+*               the info) and sets up the workers
+*
+*  On Entry:    ks = the state to set up
+*               encrypt = true to seal, false to open
+*               header = the KSEAL_HEADER bytes of the header
+*               key, keylen = the key as hashed from -k
+*               threads = number of workers, the calling
+*                         thread being one of them. Fewer are
+*                         used if not all threads can be
+*                         started.
+*
+*  Returns:     CRYPT_OK if successful, CRYPT_INVALID_PACKET
+*               if the header is not one this version reads
+*
+*---------------------------------------------------------*/
+int kseal_start(kseal_state *ks, bool encrypt, const unsigned char *header, const unsigned char *key, unsigned long keylen, int threads)
+{
+	unsigned char filekey[KSEAL_KEYLEN];
+	char name[KSEAL_NAMELEN];
+	int i, err, idx, filekeylen = KSEAL_KEYLEN;
+
+	if (threads < 1) threads = 1;
+
+	memset(ks, 0, sizeof(kseal_state));
+	ks->encrypt = encrypt;
+	ks->aead = header[8];
+	ks->cipher = -1;
+	ks->left = ~(ulong64) 0;
+	memcpy(ks->header, header, KSEAL_HEADER);
+
+	if (! kseal_is_sealed(header) || header[KSEAL_MAGICLEN - 1] != KSEAL_VERSION ||
+		header[9] < KSEAL_MIN_SHIFT || header[9] > KSEAL_MAX_SHIFT || header[10] || header[11]) {
+		return CRYPT_INVALID_PACKET;
+	}
+	ks->recsize = 1UL << header[9];
+
+	if (ks->aead == KSEAL_GCM) {
+		memcpy(name, header + 12 + KSEAL_SALTLEN, KSEAL_NAMELEN);
+		if (name[KSEAL_NAMELEN - 1] != '\0') return CRYPT_INVALID_PACKET;
+		ks->cipher = find_cipher_builtin(name);
+		if (ks->cipher == -1 || cipher_descriptor[ks->cipher].block_length != 16) return CRYPT_INVALID_PACKET;
+		if ((err = cipher_descriptor[ks->cipher].keysize(&filekeylen)) != CRYPT_OK) return err;
+	}
+	else if (ks->aead != KSEAL_CHACHA20POLY1305) return CRYPT_INVALID_PACKET;
+
+	/* a key of its own for every file, as the nonces repeat across files */
+	if ((idx = find_hash_builtin("sha256")) == -1) return CRYPT_INVALID_HASH;
+	err = hkdf(idx, header + 12, KSEAL_SALTLEN, header, KSEAL_HEADER,
+			   key, keylen, filekey, (unsigned long) filekeylen);
+	if (err != CRYPT_OK) return err;
+
+	/* worker 0 is the calling thread */
+	if ((err = tpool_start(&ks->pool, threads - 1)) != CRYPT_OK) {
+		zeromem(filekey, sizeof(filekey));
+		return err;
+	}
+	ks->threads = ks->pool.threads + 1;
+
+	ks->carry = (unsigned char *) malloc(ks->recsize + KSEAL_TAG);
+	ks->worker = (kseal_worker *) calloc(ks->threads, sizeof(kseal_worker));
+	if (ks->carry == NULL || ks->worker == NULL) {
+		tpool_done(&ks->pool);
+		free(ks->carry);
+		free(ks->worker);
+		zeromem(filekey, sizeof(filekey));
+		return CRYPT_MEM;
+	}
+
+	/* GCM keeps its key schedule across records, ChaCha20 is keyed
+	*  for every record */
+	if (ks->aead == KSEAL_CHACHA20POLY1305) memcpy(ks->key, filekey, KSEAL_KEYLEN);
+
+	for (i = 0; i < ks->threads; i++) {
+		ks->worker[i].ks = ks;
+		err = (ks->aead == KSEAL_GCM) ? gcm_init(&ks->worker[i].aead.gcm, ks->cipher, filekey, filekeylen) : CRYPT_OK;
+		if (err != CRYPT_OK) {
+			tpool_done(&ks->pool);
+			zeromem(filekey, sizeof(filekey));
+			zeromem(ks->worker, ks->threads * sizeof(kseal_worker));
+			free(ks->carry);
+			free(ks->worker);
+			return err;
+		}
+	}
+	zeromem(filekey, sizeof(filekey));
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_range()
+*
+*  Description: Sets up ks (opening) to put out only length
+*               bytes of plaintext from offset on. Only the
+*               records holding them need to be read, the
+*               first being record offset / recsize.
+*
+*  On Entry:    ks = the state, as set up by kseal_start()
+*               body = the size of the file less the header, -1
+*                      if not known, in which case the records
+*                      are read up to the end
+*               offset, length = the range of the plaintext,
+*                                length ~0 for up to the end
+*               from, len = where to put the part of the body
+*                           to read, len ~0 for up to the end
+*
+*---------------------------------------------------------*/
+void kseal_range(kseal_state *ks, long long body, ulong64 offset, ulong64 length, ulong64 *from, ulong64 *len)
+{
+	ulong64 inrec = ks->recsize + KSEAL_TAG;
+	ulong64 first = offset / ks->recsize, last, final;
+
+	ks->index = first;
+	ks->skip = offset % ks->recsize;
+	ks->left = length;
+	*from = first * inrec;
+	*len = ~(ulong64) 0;
+
+	/* a pipe that ends before the first record is past its end */
+	if (body < 0) {
+		ks->past = (first > 0);
+		return;
+	}
+
+	/* the final record is the one shorter than a full record */
+	final = (ulong64) body / inrec;
+	if (first > final) {
+		*from = (ulong64) body;
+		*len = 0;
+		ks->cut = true;
+		return;
+	}
+
+	if (length == 0) last = first;
+	else if (length > ~(ulong64) 0 - offset) last = final;
+	else last = (offset + length - 1) / ks->recsize;
+
+	if (last < final) {
+		*len = (last - first + 1) * inrec;
+		ks->cut = true;
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_outmax()
+*
+*  Description: The most bytes kseal_crypt() puts out for
+*               chunk bytes of input
+*
+*---------------------------------------------------------*/
+size_t kseal_outmax(kseal_state *ks, size_t chunk)
+{
+	size_t inrec = ks->encrypt ? ks->recsize : ks->recsize + KSEAL_TAG;
+	size_t outrec = ks->encrypt ? ks->recsize + KSEAL_TAG : ks->recsize;
+
+	/* the record completed from the carry, the whole ones in the
+	*  chunk, or the final record */
+	return (chunk / inrec + 2) * outrec;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_feed()
+*
+*  Description: Seals or opens the next len bytes. Whole
+*               records are done at once, a record split
+*               between calls is held back until it is
+*               complete, and what is held back at the end
+*               (len 0) is the final record.
+*
+*  Returns:     CRYPT_OK if successful, CRYPT_ERROR if a record
+*               does not authenticate or the input ends before
+*               the final record
+*
+*---------------------------------------------------------*/
+static int kseal_feed(kseal_state *ks, const unsigned char *in, unsigned long len, unsigned char *out, unsigned long *outlen)
+{
+	unsigned long inrec = ks->encrypt ? ks->recsize : ks->recsize + KSEAL_TAG;
+	unsigned long outrec = ks->encrypt ? ks->recsize + KSEAL_TAG : ks->recsize;
+	unsigned long n;
+	int err;
+
+	*outlen = 0;
+
+	/* end of input, what is held back is the final record, unless
+	*  the range stops short of it or starts after it */
+	if (len == 0) {
+		if (ks->cut || ks->past) return (ks->carried == 0) ? CRYPT_OK : CRYPT_ERROR;
+		if (ks->encrypt) n = ks->carried;
+		else if (ks->carried >= KSEAL_TAG) n = ks->carried - KSEAL_TAG;
+		else return CRYPT_ERROR;
+
+		err = kseal_record(&ks->worker[0], ks->index++, true, ks->carry, n, out);
+		if (err != CRYPT_OK) return err;
+		*outlen = ks->encrypt ? n + KSEAL_TAG : n;
+		ks->carried = 0;
+		return CRYPT_OK;
+	}
+
+	ks->past = false;
+
+	/* complete the record split between calls, a full one is
+	*  never the final record */
+	if (ks->carried) {
+		n = inrec - ks->carried;
+		if (n > len) n = len;
+		memcpy(ks->carry + ks->carried, in, n);
+		ks->carried += n;
+		in += n;
+		len -= n;
+		if (ks->carried < inrec) return CRYPT_OK;
+
+		err = kseal_record(&ks->worker[0], ks->index++, false, ks->carry, ks->recsize, out);
+		if (err != CRYPT_OK) return err;
+		ks->carried = 0;
+		out += outrec;
+		*outlen += outrec;
+	}
+
+	/* whole records straight from in */
+	n = len / inrec;
+	if (n) {
+		if ((err = kseal_run(ks, in, out, n)) != CRYPT_OK) return err;
+		in += n * inrec;
+		len -= n * inrec;
+		*outlen += n * outrec;
+	}
+
+	/* the rest waits for the next call */
+	memcpy(ks->carry, in, len);
+	ks->carried = len;
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_crypt()
+*
+*  Description: Seals or opens the next len bytes (see
+*               kseal_feed()), and drops what falls outside the
+*               range set by kseal_range(). Has the kpipe_sfn
+*               signature so it can serve as the cipher stage
+*               of kpipe_run_sized().
+*
+*  Returns:     CRYPT_OK if successful, CRYPT_ERROR if a record
+*               does not authenticate or the input ends before
+*               the final record
+*
+*---------------------------------------------------------*/
+int kseal_crypt(const unsigned char *in, unsigned long len, unsigned char *out, unsigned long *outlen, void *ctx)
+{
+	kseal_state *ks = (kseal_state *) ctx;
+	unsigned long n;
+	int err;
+
+	if ((err = kseal_feed(ks, in, len, out, outlen)) != CRYPT_OK) return err;
+
+	if (ks->skip) {
+		n = (*outlen < ks->skip) ? *outlen : (unsigned long) ks->skip;
+		memmove(out, out + n, *outlen - n);
+		*outlen -= n;
+		ks->skip -= n;
+	}
+	if (*outlen > ks->left) *outlen = (unsigned long) ks->left;
+	ks->left -= *outlen;
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    kseal_done()
+*
+*  Description: Stops the workers and wipes their AEAD states
+*
+*---------------------------------------------------------*/
+void kseal_done(kseal_state *ks)
+{
+	tpool_done(&ks->pool);
+
+	zeromem(ks->worker, ks->threads * sizeof(kseal_worker));
+	zeromem(ks->carry, ks->recsize + KSEAL_TAG);
+	zeromem(ks->key, sizeof(ks->key));
+	free(ks->worker);
+	free(ks->carry);
+}
@@ -41,13 +41,35 @@
 #define ECB_TEST rijndael_test
 #define ECB_KS   rijndael_keysize
 
+#ifdef LTC_AES_NI
+#define ACCEL_ECB_ENC aes_accel_ecb_encrypt
+#define ACCEL_ECB_DEC aes_accel_ecb_decrypt
+#define ACCEL_CBC_DEC aes_accel_cbc_decrypt
+#define ACCEL_CTR     aes_accel_ctr_encrypt
+#ifdef LTC_XTS_MODE
+#define ACCEL_XTS_ENC aes_accel_xts_encrypt
+#define ACCEL_XTS_DEC aes_accel_xts_decrypt
+#else
+#define ACCEL_XTS_ENC NULL
+#define ACCEL_XTS_DEC NULL
+#endif
+#else
+#define ACCEL_ECB_ENC NULL
+#define ACCEL_ECB_DEC NULL
+#define ACCEL_CBC_DEC NULL
+#define ACCEL_CTR     NULL
+#define ACCEL_XTS_ENC NULL
+#define ACCEL_XTS_DEC NULL
+#endif
+
 const struct ltc_cipher_descriptor rijndael_desc =
 {
     "rijndael",
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, ECB_DEC, ECB_TEST, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ACCEL_ECB_ENC, ACCEL_ECB_DEC, NULL, ACCEL_CBC_DEC, ACCEL_CTR,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, ACCEL_XTS_ENC, ACCEL_XTS_DEC
 };
 
 const struct ltc_cipher_descriptor aes_desc =
@@ -56,7 +78,8 @@ const struct ltc_cipher_descriptor aes_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, ECB_DEC, ECB_TEST, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ACCEL_ECB_ENC, ACCEL_ECB_DEC, NULL, ACCEL_CBC_DEC, ACCEL_CTR,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, ACCEL_XTS_ENC, ACCEL_XTS_DEC
 };
 
 #else
@@ -293,6 +316,12 @@ int ECB_ENC(const unsigned char *pt, unsigned char *ct, symmetric_key *skey)
     LTC_ARGCHK(ct != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (aesni_is_supported()) {
+       return aesni_ecb_encrypt(pt, ct, 1, skey);
+    }
+#endif
+
     Nr = skey->rijndael.Nr;
     rk = skey->rijndael.eK;
 
@@ -472,6 +501,12 @@ int ECB_DEC(const unsigned char *ct, unsigned char *pt, symmetric_key *skey)
     LTC_ARGCHK(ct != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (aesni_is_supported()) {
+       return aesni_ecb_decrypt(ct, pt, 1, skey);
+    }
+#endif
+
     Nr = skey->rijndael.Nr;
     rk = skey->rijndael.dK;
 
@@ -0,0 +1,611 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file aes_ni.c
+  AES using the x86 AES-NI instructions, selected at runtime.
+
+  The key schedule is the one computed by rijndael_setup(); its round
+  keys are byte swapped into place as they are loaded. Bulk routines
+  keep 8 blocks in flight so the AESENC/AESDEC latency is hidden.
+*/
+#include "tomcrypt.h"
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AES_NI)
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+
+#define AESNI_TARGET __attribute__((target("aes,ssse3")))
+
+/* number of blocks processed in parallel */
+#define AESNI_LANES 8
+
+/**
+  Whether the CPU supports AES-NI (and SSSE3, used to load the keys)
+  @return 1 if supported, 0 if not
+*/
+int aesni_is_supported(void)
+{
+   return crypt_cpu_has(LTC_CPU_AESNI | LTC_CPU_SSSE3);
+}
+
+/* load the Nr+1 round keys of K, stored as big endian words, into the
+   15 of rk. The slots past Nr are zeroed, so the compiler can see that
+   every round key used is set whatever Nr is */
+AESNI_TARGET
+static void _aesni_load_keys(const ulong32 *K, int Nr, __m128i *rk)
+{
+   const __m128i bswap32 = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   int r;
+
+   for (r = 0; r < 15; r++) {
+      rk[r] = (r <= Nr) ? _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(K + 4 * r)), bswap32)
+                        : _mm_setzero_si128();
+   }
+}
+
+AESNI_TARGET
+static LTC_INLINE __m128i _aesni_enc1(__m128i b, const __m128i *rk, int Nr)
+{
+   int r;
+
+   b = _mm_xor_si128(b, rk[0]);
+   for (r = 1; r < Nr; r++) {
+      b = _mm_aesenc_si128(b, rk[r]);
+   }
+   return _mm_aesenclast_si128(b, rk[Nr]);
+}
+
+AESNI_TARGET
+static LTC_INLINE __m128i _aesni_dec1(__m128i b, const __m128i *rk, int Nr)
+{
+   int r;
+
+   b = _mm_xor_si128(b, rk[0]);
+   for (r = 1; r < Nr; r++) {
+      b = _mm_aesdec_si128(b, rk[r]);
+   }
+   return _mm_aesdeclast_si128(b, rk[Nr]);
+}
+
+AESNI_TARGET
+static LTC_INLINE void _aesni_enc8(__m128i *b, const __m128i *rk, int Nr)
+{
+   int r, i;
+
+   for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_xor_si128(b[i], rk[0]);
+   for (r = 1; r < Nr; r++) {
+      for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_aesenc_si128(b[i], rk[r]);
+   }
+   for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_aesenclast_si128(b[i], rk[Nr]);
+}
+
+AESNI_TARGET
+static LTC_INLINE void _aesni_dec8(__m128i *b, const __m128i *rk, int Nr)
+{
+   int r, i;
+
+   for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_xor_si128(b[i], rk[0]);
+   for (r = 1; r < Nr; r++) {
+      for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_aesdec_si128(b[i], rk[r]);
+   }
+   for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_aesdeclast_si128(b[i], rk[Nr]);
+}
+
+/**
+  AES-NI ECB encryption, the CPU must support it
+  @param pt      Plaintext
+  @param ct      [out] Ciphertext
+  @param blocks  The number of complete blocks to process
+  @param skey    The key as scheduled by rijndael_setup()
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+   __m128i rk[15], b[AESNI_LANES];
+   int Nr, i;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   _aesni_load_keys(skey->rijndael.eK, Nr, rk);
+
+   for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+      for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_loadu_si128((const __m128i *)(const void *)(pt + 16 * i));
+      _aesni_enc8(b, rk, Nr);
+      for (i = 0; i < AESNI_LANES; i++) _mm_storeu_si128((__m128i *)(void *)(ct + 16 * i), b[i]);
+      pt += 16 * AESNI_LANES;
+      ct += 16 * AESNI_LANES;
+   }
+   for (; blocks > 0; blocks--) {
+      _mm_storeu_si128((__m128i *)(void *)ct, _aesni_enc1(_mm_loadu_si128((const __m128i *)(const void *)pt), rk, Nr));
+      pt += 16;
+      ct += 16;
+   }
+   return CRYPT_OK;
+}
+
+#ifndef ENCRYPT_ONLY
+/**
+  AES-NI ECB decryption, the CPU must support it
+  @param ct      Ciphertext
+  @param pt      [out] Plaintext
+  @param blocks  The number of complete blocks to process
+  @param skey    The key as scheduled by rijndael_setup()
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+   __m128i rk[15], b[AESNI_LANES];
+   int Nr, i;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   _aesni_load_keys(skey->rijndael.dK, Nr, rk);
+
+   for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+      for (i = 0; i < AESNI_LANES; i++) b[i] = _mm_loadu_si128((const __m128i *)(const void *)(ct + 16 * i));
+      _aesni_dec8(b, rk, Nr);
+      for (i = 0; i < AESNI_LANES; i++) _mm_storeu_si128((__m128i *)(void *)(pt + 16 * i), b[i]);
+      ct += 16 * AESNI_LANES;
+      pt += 16 * AESNI_LANES;
+   }
+   for (; blocks > 0; blocks--) {
+      _mm_storeu_si128((__m128i *)(void *)pt, _aesni_dec1(_mm_loadu_si128((const __m128i *)(const void *)ct), rk, Nr));
+      ct += 16;
+      pt += 16;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  AES-NI CBC decryption, the CPU must support it. Unlike encryption
+  the blocks are independent, so they are decrypted 8 at a time.
+  @param ct      Ciphertext
+  @param pt      [out] Plaintext (may be the same buffer as ct)
+  @param blocks  The number of complete blocks to process
+  @param IV      The initial value (input/output)
+  @param skey    The key as scheduled by rijndael_setup()
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, symmetric_key *skey)
+{
+   __m128i rk[15], b[AESNI_LANES], c[AESNI_LANES], iv;
+   int Nr, i;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   _aesni_load_keys(skey->rijndael.dK, Nr, rk);
+   iv = _mm_loadu_si128((const __m128i *)(const void *)IV);
+
+   for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+      for (i = 0; i < AESNI_LANES; i++) b[i] = c[i] = _mm_loadu_si128((const __m128i *)(const void *)(ct + 16 * i));
+      _aesni_dec8(b, rk, Nr);
+      b[0] = _mm_xor_si128(b[0], iv);
+      for (i = 1; i < AESNI_LANES; i++) b[i] = _mm_xor_si128(b[i], c[i - 1]);
+      for (i = 0; i < AESNI_LANES; i++) _mm_storeu_si128((__m128i *)(void *)(pt + 16 * i), b[i]);
+      iv = c[AESNI_LANES - 1];
+      ct += 16 * AESNI_LANES;
+      pt += 16 * AESNI_LANES;
+   }
+   for (; blocks > 0; blocks--) {
+      c[0] = _mm_loadu_si128((const __m128i *)(const void *)ct);
+      _mm_storeu_si128((__m128i *)(void *)pt, _mm_xor_si128(_aesni_dec1(c[0], rk, Nr), iv));
+      iv = c[0];
+      ct += 16;
+      pt += 16;
+   }
+
+   _mm_storeu_si128((__m128i *)(void *)IV, iv);
+   return CRYPT_OK;
+}
+#ifdef LTC_XTS_MODE
+/* the XTS tweak times x: the 64-bit halves are doubled, the bit
+ * carried out of the low half goes into the high one and the bit out
+ * of the top is reduced with 0x87 */
+AESNI_TARGET
+static LTC_INLINE __m128i _aesni_xts_mult_x(__m128i t)
+{
+   const __m128i poly = _mm_set_epi32(0, 1, 0, 0x87);
+   __m128i c = _mm_srai_epi32(_mm_shuffle_epi32(t, 0x13), 31);
+
+   return _mm_xor_si128(_mm_add_epi64(t, t), _mm_and_si128(c, poly));
+}
+
+/**
+  AES-NI XTS encryption, the CPU must support it
+  @param pt      Plaintext
+  @param ct      [out] Ciphertext
+  @param blocks  The number of complete blocks to process
+  @param tweak   The tweak (input), the next tweak encrypted (output)
+  @param skey1   The data key as scheduled by rijndael_setup()
+  @param skey2   The tweak key as scheduled by rijndael_setup()
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak,
+                      symmetric_key *skey1, symmetric_key *skey2)
+{
+   __m128i rk[15], b[AESNI_LANES], t[AESNI_LANES], T;
+   int Nr, i;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(skey1 != NULL);
+   LTC_ARGCHK(skey2 != NULL);
+
+   _aesni_load_keys(skey2->rijndael.eK, skey2->rijndael.Nr, rk);
+   T = _aesni_enc1(_mm_loadu_si128((const __m128i *)(const void *)tweak), rk, skey2->rijndael.Nr);
+
+   Nr = skey1->rijndael.Nr;
+   _aesni_load_keys(skey1->rijndael.eK, Nr, rk);
+
+   for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+      for (i = 0; i < AESNI_LANES; i++) {
+         t[i] = T;
+         T = _aesni_xts_mult_x(T);
+         b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)(pt + 16 * i)), t[i]);
+      }
+      _aesni_enc8(b, rk, Nr);
+      for (i = 0; i < AESNI_LANES; i++) _mm_storeu_si128((__m128i *)(void *)(ct + 16 * i), _mm_xor_si128(b[i], t[i]));
+      pt += 16 * AESNI_LANES;
+      ct += 16 * AESNI_LANES;
+   }
+   for (; blocks > 0; blocks--) {
+      b[0] = _aesni_enc1(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)pt), T), rk, Nr);
+      _mm_storeu_si128((__m128i *)(void *)ct, _mm_xor_si128(b[0], T));
+      T = _aesni_xts_mult_x(T);
+      pt += 16;
+      ct += 16;
+   }
+
+   _mm_storeu_si128((__m128i *)(void *)tweak, T);
+   return CRYPT_OK;
+}
+
+/**
+  AES-NI XTS decryption, the CPU must support it
+  @param ct      Ciphertext
+  @param pt      [out] Plaintext
+  @param blocks  The number of complete blocks to process
+  @param tweak   The tweak (input), the next tweak encrypted (output)
+  @param skey1   The data key as scheduled by rijndael_setup()
+  @param skey2   The tweak key as scheduled by rijndael_setup()
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak,
+                      symmetric_key *skey1, symmetric_key *skey2)
+{
+   __m128i rk[15], b[AESNI_LANES], t[AESNI_LANES], T;
+   int Nr, i;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(skey1 != NULL);
+   LTC_ARGCHK(skey2 != NULL);
+
+   _aesni_load_keys(skey2->rijndael.eK, skey2->rijndael.Nr, rk);
+   T = _aesni_enc1(_mm_loadu_si128((const __m128i *)(const void *)tweak), rk, skey2->rijndael.Nr);
+
+   Nr = skey1->rijndael.Nr;
+   _aesni_load_keys(skey1->rijndael.dK, Nr, rk);
+
+   for (; blocks >= AESNI_LANES; blocks -= AESNI_LANES) {
+      for (i = 0; i < AESNI_LANES; i++) {
+         t[i] = T;
+         T = _aesni_xts_mult_x(T);
+         b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)(ct + 16 * i)), t[i]);
+      }
+      _aesni_dec8(b, rk, Nr);
+      for (i = 0; i < AESNI_LANES; i++) _mm_storeu_si128((__m128i *)(void *)(pt + 16 * i), _mm_xor_si128(b[i], t[i]));
+      ct += 16 * AESNI_LANES;
+      pt += 16 * AESNI_LANES;
+   }
+   for (; blocks > 0; blocks--) {
+      b[0] = _aesni_dec1(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)ct), T), rk, Nr);
+      _mm_storeu_si128((__m128i *)(void *)pt, _mm_xor_si128(b[0], T));
+      T = _aesni_xts_mult_x(T);
+      ct += 16;
+      pt += 16;
+   }
+
+   _mm_storeu_si128((__m128i *)(void *)tweak, T);
+   return CRYPT_OK;
+}
+#endif /* LTC_XTS_MODE */
+#endif /* ENCRYPT_ONLY */
+
+/**
+  AES-NI CTR encryption, the CPU must support it. Like the other
+  accel_ctr_encrypt hooks the counter spans the whole block, and it
+  is incremented before each block is encrypted.
+  @param pt      Plaintext
+  @param ct      [out] Ciphertext
+  @param blocks  The number of complete blocks to process
+  @param IV      The last counter used (input/output)
+  @param mode    CTR_COUNTER_LITTLE_ENDIAN or CTR_COUNTER_BIG_ENDIAN
+  @param skey    The key as scheduled by rijndael_setup()
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, symmetric_key *skey)
+{
+   const __m128i bswap128 = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   __m128i rk[15], b[AESNI_LANES], ctr;
+   ulong64 lo, hi;
+   int Nr, i, n;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   _aesni_load_keys(skey->rijndael.eK, Nr, rk);
+
+   /* keep the counter as a little endian 128-bit number lo:hi */
+   ctr = _mm_loadu_si128((const __m128i *)(const void *)IV);
+   if (mode == CTR_COUNTER_BIG_ENDIAN) ctr = _mm_shuffle_epi8(ctr, bswap128);
+   LOAD64L(lo, (const unsigned char *)&ctr);
+   LOAD64L(hi, (const unsigned char *)&ctr + 8);
+
+   while (blocks > 0) {
+      n = (blocks < AESNI_LANES) ? (int)blocks : AESNI_LANES;
+      for (i = 0; i < n; i++) {
+         if (++lo == 0) ++hi;
+         b[i] = _mm_set_epi64x((long long)hi, (long long)lo);
+         if (mode == CTR_COUNTER_BIG_ENDIAN) b[i] = _mm_shuffle_epi8(b[i], bswap128);
+      }
+      ctr = b[n - 1];
+      if (n == AESNI_LANES) {
+         _aesni_enc8(b, rk, Nr);
+      } else {
+         for (i = 0; i < n; i++) b[i] = _aesni_enc1(b[i], rk, Nr);
+      }
+      for (i = 0; i < n; i++) {
+         b[i] = _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i *)(const void *)(pt + 16 * i)));
+         _mm_storeu_si128((__m128i *)(void *)(ct + 16 * i), b[i]);
+      }
+      pt += 16 * n;
+      ct += 16 * n;
+      blocks -= n;
+   }
+
+   _mm_storeu_si128((__m128i *)(void *)IV, ctr);
+   return CRYPT_OK;
+}
+
+
+/*
+ * The accel_* hooks of aes_desc. They use AES-NI when the CPU has it
+ * and fall back to the portable block functions otherwise.
+ */
+
+/**
+  Accelerated ECB encryption for aes_desc
+  @param pt      Plaintext
+  @param ct      [out] Ciphertext
+  @param blocks  The number of complete blocks to process
+  @param skey    The scheduled key
+  @return CRYPT_OK if successful
+*/
+int aes_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+
+   if (aesni_is_supported()) {
+      return aesni_ecb_encrypt(pt, ct, blocks, skey);
+   }
+   for (; blocks > 0; blocks--) {
+      if ((err = rijndael_ecb_encrypt(pt, ct, skey)) != CRYPT_OK) {
+         return err;
+      }
+      pt += 16;
+      ct += 16;
+   }
+   return CRYPT_OK;
+}
+
+#ifndef ENCRYPT_ONLY
+/**
+  Accelerated ECB decryption for aes_desc
+  @param ct      Ciphertext
+  @param pt      [out] Plaintext
+  @param blocks  The number of complete blocks to process
+  @param skey    The scheduled key
+  @return CRYPT_OK if successful
+*/
+int aes_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+
+   if (aesni_is_supported()) {
+      return aesni_ecb_decrypt(ct, pt, blocks, skey);
+   }
+   for (; blocks > 0; blocks--) {
+      if ((err = rijndael_ecb_decrypt(ct, pt, skey)) != CRYPT_OK) {
+         return err;
+      }
+      ct += 16;
+      pt += 16;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Accelerated CBC decryption for aes_desc
+  @param ct      Ciphertext
+  @param pt      [out] Plaintext
+  @param blocks  The number of complete blocks to process
+  @param IV      The initial value (input/output)
+  @param skey    The scheduled key
+  @return CRYPT_OK if successful
+*/
+int aes_accel_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, symmetric_key *skey)
+{
+   unsigned char tmp[16], c[16];
+   int x, err;
+
+   if (aesni_is_supported()) {
+      return aesni_cbc_decrypt(ct, pt, blocks, IV, skey);
+   }
+   for (; blocks > 0; blocks--) {
+      XMEMCPY(c, ct, 16);
+      if ((err = rijndael_ecb_decrypt(c, tmp, skey)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         pt[x] = tmp[x] ^ IV[x];
+      }
+      XMEMCPY(IV, c, 16);
+      ct += 16;
+      pt += 16;
+   }
+   return CRYPT_OK;
+}
+#ifdef LTC_XTS_MODE
+/**
+  Accelerated XTS encryption for aes_desc
+  @param pt      Plaintext
+  @param ct      [out] Ciphertext
+  @param blocks  The number of complete blocks to process
+  @param tweak   The tweak (input), the next tweak encrypted (output)
+  @param skey1   The data key
+  @param skey2   The tweak key
+  @return CRYPT_OK if successful
+*/
+int aes_accel_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak,
+                          symmetric_key *skey1, symmetric_key *skey2)
+{
+   unsigned char T[16];
+   int x, err;
+
+   if (aesni_is_supported()) {
+      return aesni_xts_encrypt(pt, ct, blocks, tweak, skey1, skey2);
+   }
+   if ((err = rijndael_ecb_encrypt(tweak, T, skey2)) != CRYPT_OK) {
+      return err;
+   }
+   for (; blocks > 0; blocks--) {
+      for (x = 0; x < 16; x++) {
+         ct[x] = pt[x] ^ T[x];
+      }
+      if ((err = rijndael_ecb_encrypt(ct, ct, skey1)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         ct[x] ^= T[x];
+      }
+      xts_mult_x(T);
+      pt += 16;
+      ct += 16;
+   }
+   XMEMCPY(tweak, T, 16);
+   return CRYPT_OK;
+}
+
+/**
+  Accelerated XTS decryption for aes_desc
+  @param ct      Ciphertext
+  @param pt      [out] Plaintext
+  @param blocks  The number of complete blocks to process
+  @param tweak   The tweak (input), the next tweak encrypted (output)
+  @param skey1   The data key
+  @param skey2   The tweak key
+  @return CRYPT_OK if successful
+*/
+int aes_accel_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak,
+                          symmetric_key *skey1, symmetric_key *skey2)
+{
+   unsigned char T[16];
+   int x, err;
+
+   if (aesni_is_supported()) {
+      return aesni_xts_decrypt(ct, pt, blocks, tweak, skey1, skey2);
+   }
+   if ((err = rijndael_ecb_encrypt(tweak, T, skey2)) != CRYPT_OK) {
+      return err;
+   }
+   for (; blocks > 0; blocks--) {
+      for (x = 0; x < 16; x++) {
+         pt[x] = ct[x] ^ T[x];
+      }
+      if ((err = rijndael_ecb_decrypt(pt, pt, skey1)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         pt[x] ^= T[x];
+      }
+      xts_mult_x(T);
+      ct += 16;
+      pt += 16;
+   }
+   XMEMCPY(tweak, T, 16);
+   return CRYPT_OK;
+}
+#endif /* LTC_XTS_MODE */
+#endif /* ENCRYPT_ONLY */
+
+/**
+  Accelerated CTR encryption for aes_desc (whole block counters only)
+  @param pt      Plaintext
+  @param ct      [out] Ciphertext
+  @param blocks  The number of complete blocks to process
+  @param IV      The last counter used (input/output)
+  @param mode    CTR_COUNTER_LITTLE_ENDIAN or CTR_COUNTER_BIG_ENDIAN
+  @param skey    The scheduled key
+  @return CRYPT_OK if successful
+*/
+int aes_accel_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, symmetric_key *skey)
+{
+   unsigned char pad[16];
+   int x, err;
+
+   if (aesni_is_supported()) {
+      return aesni_ctr_encrypt(pt, ct, blocks, IV, mode, skey);
+   }
+   for (; blocks > 0; blocks--) {
+      if (mode == CTR_COUNTER_LITTLE_ENDIAN) {
+         for (x = 0; x < 16 && ++IV[x] == 0; x++);
+      } else {
+         for (x = 15; x >= 0 && ++IV[x] == 0; x--);
+      }
+      if ((err = rijndael_ecb_encrypt(IV, pad, skey)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         ct[x] = pt[x] ^ pad[x];
+      }
+      pt += 16;
+      ct += 16;
+   }
+   return CRYPT_OK;
+}
+
+#endif /* LTC_RIJNDAEL && LTC_AES_NI */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -88,8 +88,16 @@ int gcm_add_aad(gcm_state *gcm,
    }
 
    x = 0;
+#ifdef LTC_GCM_CLMUL
+   if (gcm->buflen == 0 && gcm->clmul) {
+      x = adatalen & ~15uL;
+      gcm_clmul_ghash(gcm, adata, x / 16);
+      gcm->totlen += x * CONST64(8);
+      adata += x;
+   }
+#endif
 #ifdef LTC_FAST
-   if (gcm->buflen == 0) {
+   if (gcm->buflen == 0 && x == 0) {
       for (x = 0; x < (adatalen & ~15); x += 16) {
           for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
               *(LTC_FAST_TYPE_PTR_CAST(&gcm->X[y])) ^= *(LTC_FAST_TYPE_PTR_CAST(&adata[x + y]));
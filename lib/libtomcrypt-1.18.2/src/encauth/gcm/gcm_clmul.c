@@ -0,0 +1,188 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_clmul.c
+   GCM GHASH using the x86 PCLMULQDQ carry-less multiply, selected at runtime.
+
+   Blocks are byte reflected on load so the field elements sit in the
+   register in the usual polynomial order. Up to 8 blocks are multiplied
+   by H^8..H^1 and summed before a single reduction.
+*/
+#include "tomcrypt.h"
+
+#if defined(LTC_GCM_MODE) && defined(LTC_GCM_CLMUL)
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+
+#define CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+
+/**
+  Whether the CPU supports PCLMULQDQ (and SSSE3, used to reflect the blocks)
+  @return 1 if supported, 0 if not
+*/
+int gcm_clmul_is_supported(void)
+{
+   return crypt_cpu_has(LTC_CPU_PCLMUL | LTC_CPU_SSSE3);
+}
+
+CLMUL_TARGET
+static LTC_INLINE __m128i _clmul_load(const unsigned char *p)
+{
+   const __m128i bswap128 = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)p), bswap128);
+}
+
+CLMUL_TARGET
+static LTC_INLINE void _clmul_store(unsigned char *p, __m128i x)
+{
+   const __m128i bswap128 = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   _mm_storeu_si128((__m128i *)(void *)p, _mm_shuffle_epi8(x, bswap128));
+}
+
+/* 256-bit carry-less product a*b, accumulated into lo:hi */
+CLMUL_TARGET
+static LTC_INLINE void _clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *hi)
+{
+   __m128i t0, t1, t2, t3;
+
+   t0 = _mm_clmulepi64_si128(a, b, 0x00);
+   t1 = _mm_clmulepi64_si128(a, b, 0x10);
+   t2 = _mm_clmulepi64_si128(a, b, 0x01);
+   t3 = _mm_clmulepi64_si128(a, b, 0x11);
+   t1 = _mm_xor_si128(t1, t2);
+   *lo = _mm_xor_si128(*lo, _mm_xor_si128(t0, _mm_slli_si128(t1, 8)));
+   *hi = _mm_xor_si128(*hi, _mm_xor_si128(t3, _mm_srli_si128(t1, 8)));
+}
+
+/* reduce lo:hi modulo the GCM polynomial, allowing for the bit reflection */
+CLMUL_TARGET
+static LTC_INLINE __m128i _clmul_reduce(__m128i lo, __m128i hi)
+{
+   __m128i t7, t8, t9, t2, t4, t5;
+
+   /* shift the 256-bit product left by one */
+   t7 = _mm_srli_epi32(lo, 31);
+   t8 = _mm_srli_epi32(hi, 31);
+   lo = _mm_slli_epi32(lo, 1);
+   hi = _mm_slli_epi32(hi, 1);
+   t9 = _mm_srli_si128(t7, 12);
+   t8 = _mm_slli_si128(t8, 4);
+   t7 = _mm_slli_si128(t7, 4);
+   lo = _mm_or_si128(lo, t7);
+   hi = _mm_or_si128(hi, t8);
+   hi = _mm_or_si128(hi, t9);
+
+   /* first phase */
+   t7 = _mm_slli_epi32(lo, 31);
+   t8 = _mm_slli_epi32(lo, 30);
+   t9 = _mm_slli_epi32(lo, 25);
+   t7 = _mm_xor_si128(t7, t8);
+   t7 = _mm_xor_si128(t7, t9);
+   t8 = _mm_srli_si128(t7, 4);
+   t7 = _mm_slli_si128(t7, 12);
+   lo = _mm_xor_si128(lo, t7);
+
+   /* second phase */
+   t2 = _mm_srli_epi32(lo, 1);
+   t4 = _mm_srli_epi32(lo, 2);
+   t5 = _mm_srli_epi32(lo, 7);
+   t2 = _mm_xor_si128(t2, t4);
+   t2 = _mm_xor_si128(t2, t5);
+   t2 = _mm_xor_si128(t2, t8);
+   lo = _mm_xor_si128(lo, t2);
+
+   return _mm_xor_si128(hi, lo);
+}
+
+CLMUL_TARGET
+static LTC_INLINE __m128i _clmul_mult(__m128i a, __m128i b)
+{
+   __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+   _clmul_acc(a, b, &lo, &hi);
+   return _clmul_reduce(lo, hi);
+}
+
+/**
+  Compute the powers H^1..H^8 used by the aggregated GHASH
+  @param gcm   The GCM state, H must be set
+*/
+CLMUL_TARGET
+void gcm_clmul_init(gcm_state *gcm)
+{
+   __m128i h, p;
+   int x;
+
+   LTC_ARGCHKVD(gcm != NULL);
+
+   h = p = _clmul_load(gcm->H);
+   _mm_storeu_si128((__m128i *)(void *)gcm->HP[0], h);
+   for (x = 1; x < 8; x++) {
+      p = _clmul_mult(p, h);
+      _mm_storeu_si128((__m128i *)(void *)gcm->HP[x], p);
+   }
+}
+
+/**
+  GCM multiply by H with PCLMULQDQ
+  @param gcm   The GCM state which holds the H value
+  @param I     The value to multiply H by
+*/
+CLMUL_TARGET
+void gcm_clmul_mult_h(gcm_state *gcm, unsigned char *I)
+{
+   __m128i h = _mm_loadu_si128((const __m128i *)(const void *)gcm->HP[0]);
+   _clmul_store(I, _clmul_mult(_clmul_load(I), h));
+}
+
+/**
+  Absorb complete blocks into the GHASH accumulator gcm->X,
+  i.e. X = (X ^ in[i]) * H for each block
+  @param gcm     The GCM state
+  @param in      The blocks to absorb
+  @param blocks  The number of 16 byte blocks
+*/
+CLMUL_TARGET
+void gcm_clmul_ghash(gcm_state *gcm, const unsigned char *in, unsigned long blocks)
+{
+   __m128i hp[8], x, lo, hi;
+   int i;
+
+   LTC_ARGCHKVD(gcm != NULL);
+   LTC_ARGCHKVD(in  != NULL || blocks == 0);
+
+   for (i = 0; i < 8; i++) {
+      hp[i] = _mm_loadu_si128((const __m128i *)(const void *)gcm->HP[i]);
+   }
+   x = _clmul_load(gcm->X);
+
+   /* (X ^ B0)*H^8 ^ B1*H^7 ^ ... ^ B7*H */
+   for (; blocks >= 8; blocks -= 8) {
+      lo = hi = _mm_setzero_si128();
+      _clmul_acc(_mm_xor_si128(x, _clmul_load(in)), hp[7], &lo, &hi);
+      for (i = 1; i < 8; i++) {
+         _clmul_acc(_clmul_load(in + 16 * i), hp[7 - i], &lo, &hi);
+      }
+      x = _clmul_reduce(lo, hi);
+      in += 128;
+   }
+   for (; blocks > 0; blocks--) {
+      x = _clmul_mult(_mm_xor_si128(x, _clmul_load(in)), hp[0]);
+      in += 16;
+   }
+
+   _clmul_store(gcm->X, x);
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
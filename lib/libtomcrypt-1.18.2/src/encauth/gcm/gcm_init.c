@@ -70,6 +70,12 @@ int gcm_init(gcm_state *gcm, int cipher,
    gcm->totlen   = 0;
    gcm->pttotlen = 0;
 
+#ifdef LTC_GCM_CLMUL
+   if ((gcm->clmul = gcm_clmul_is_supported()) != 0) {
+      gcm_clmul_init(gcm);
+   }
+#endif
+
 #ifdef LTC_GCM_TABLES
    /* setup tables */
 
@@ -24,6 +24,17 @@ void gcm_mult_h(gcm_state *gcm, unsigned char *I)
    unsigned char T[16];
 #ifdef LTC_GCM_TABLES
    int x;
+#ifndef LTC_GCM_TABLES_SSE2
+   int y;
+#endif
+#endif
+#ifdef LTC_GCM_CLMUL
+   if (gcm->clmul) {
+      gcm_clmul_mult_h(gcm, I);
+      return;
+   }
+#endif
+#ifdef LTC_GCM_TABLES
 #ifdef LTC_GCM_TABLES_SSE2
    asm("movdqa (%0),%%xmm0"::"r"(&gcm->PC[0][I[0]][0]));
    for (x = 1; x < 16; x++) {
@@ -31,7 +42,6 @@ void gcm_mult_h(gcm_state *gcm, unsigned char *I)
    }
    asm("movdqa %%xmm0,(%0)"::"r"(&T));
 #else
-   int y;
    XMEMCPY(T, &gcm->PC[0][I[0]][0], 16);
    for (x = 1; x < 16; x++) {
 #ifdef LTC_FAST
@@ -15,6 +15,89 @@
 
 #ifdef LTC_GCM_MODE
 
+#ifdef LTC_GCM_CLMUL
+/* blocks of keystream made per batch by _gcm_process_clmul() */
+#define GCM_CLMUL_BLOCKS 32
+
+/**
+  Bulk GCM for complete blocks when PCLMULQDQ is in use. The counters
+  of a batch are encrypted together (through accel_ecb_encrypt if the
+  cipher has it) and the batch is absorbed by gcm_clmul_ghash().
+  @param gcm       The GCM state, in text mode with an empty buffer
+  @param pt        The plaintext
+  @param ct        The ciphertext
+  @param blocks    The number of complete blocks to process
+  @param direction Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
+  @return CRYPT_OK on success
+*/
+static int _gcm_process_clmul(gcm_state *gcm, unsigned char *pt, unsigned char *ct,
+                              unsigned long blocks, int direction)
+{
+   unsigned char ctr[GCM_CLMUL_BLOCKS * 16], pad[(GCM_CLMUL_BLOCKS + 1) * 16];
+   unsigned long n, x, i;
+   int y, err = CRYPT_OK;
+
+   while (blocks > 0) {
+      n = (blocks < GCM_CLMUL_BLOCKS) ? blocks : GCM_CLMUL_BLOCKS;
+
+      /* gcm->buf is the pad of the first block, the rest come from Y+1..Y+n */
+      XMEMCPY(pad, gcm->buf, 16);
+      for (i = 0; i < n; i++) {
+         for (y = 15; y >= 12; y--) {
+             if (++gcm->Y[y] & 255) { break; }
+         }
+         XMEMCPY(ctr + 16 * i, gcm->Y, 16);
+      }
+      if (cipher_descriptor[gcm->cipher].accel_ecb_encrypt != NULL) {
+         err = cipher_descriptor[gcm->cipher].accel_ecb_encrypt(ctr, pad + 16, n, &gcm->K);
+      } else {
+         for (i = 0; i < n && err == CRYPT_OK; i++) {
+            err = cipher_descriptor[gcm->cipher].ecb_encrypt(ctr + 16 * i, pad + 16 * (i + 1), &gcm->K);
+         }
+      }
+      if (err != CRYPT_OK) {
+         break;
+      }
+
+      /* hash the ciphertext before it is overwritten when decrypting in place */
+      if (direction != GCM_ENCRYPT) {
+         gcm_clmul_ghash(gcm, ct, n);
+      }
+#ifdef LTC_FAST
+      for (x = 0; x < n * 16; x += sizeof(LTC_FAST_TYPE)) {
+         if (direction == GCM_ENCRYPT) {
+            *(LTC_FAST_TYPE_PTR_CAST(&ct[x])) = *(LTC_FAST_TYPE_PTR_CAST(&pt[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&pad[x]));
+         } else {
+            *(LTC_FAST_TYPE_PTR_CAST(&pt[x])) = *(LTC_FAST_TYPE_PTR_CAST(&ct[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&pad[x]));
+         }
+      }
+#else
+      for (x = 0; x < n * 16; x++) {
+         if (direction == GCM_ENCRYPT) {
+            ct[x] = pt[x] ^ pad[x];
+         } else {
+            pt[x] = ct[x] ^ pad[x];
+         }
+      }
+#endif
+      if (direction == GCM_ENCRYPT) {
+         gcm_clmul_ghash(gcm, ct, n);
+      }
+
+      XMEMCPY(gcm->buf, pad + 16 * n, 16);
+      gcm->pttotlen += n * CONST64(128);
+      pt += 16 * n;
+      ct += 16 * n;
+      blocks -= n;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(pad, sizeof(pad));
+#endif
+   return err;
+}
+#endif
+
 /**
   Process plaintext/ciphertext through GCM
   @param gcm       The GCM state
@@ -83,8 +166,16 @@ int gcm_process(gcm_state *gcm,
    }
 
    x = 0;
+#ifdef LTC_GCM_CLMUL
+   if (gcm->buflen == 0 && gcm->clmul) {
+      if ((err = _gcm_process_clmul(gcm, pt, ct, ptlen / 16, direction)) != CRYPT_OK) {
+         return err;
+      }
+      x = ptlen & ~15uL;
+   }
+#endif
 #ifdef LTC_FAST
-   if (gcm->buflen == 0) {
+   if (gcm->buflen == 0 && x == 0) {
       if (direction == GCM_ENCRYPT) {
          for (x = 0; x < (ptlen & ~15); x += 16) {
              /* ctr encrypt */
@@ -279,6 +279,20 @@ static int blake2b_compress(hash_state *md, const unsigned char *buf)
    ulong64 v[16];
    unsigned long i;
 
+#ifdef LTC_AVX2
+   if (crypt_cpu_has(LTC_CPU_AVX2)) {
+      blake2b_avx2_compress(&md->blake2b, buf);
+      return CRYPT_OK;
+   }
+#endif
+
+#ifdef LTC_SSSE3
+   if (crypt_cpu_has(LTC_CPU_SSSE3)) {
+      blake2b_ssse3_compress(&md->blake2b, buf);
+      return CRYPT_OK;
+   }
+#endif
+
    for (i = 0; i < 16; ++i) {
       LOAD64L(m[i], buf + i * sizeof(m[i]));
    }
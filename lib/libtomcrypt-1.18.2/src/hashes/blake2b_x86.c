@@ -0,0 +1,213 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file blake2b_x86.c
+  LTC_BLAKE2B compression with SSSE3 and AVX2. The 16 words of the state
+  are kept as 4 rows, the column step runs the 4 G functions of a round
+  side by side, and the rows are rotated so the diagonal step can do
+  the same.
+*/
+
+#if defined(LTC_BLAKE2B) && (defined(LTC_SSSE3) || defined(LTC_AVX2))
+
+#include "tomcrypt_x86.h"
+
+static const ulong64 blake2b_IV[8] =
+{
+  CONST64(0x6a09e667f3bcc908), CONST64(0xbb67ae8584caa73b),
+  CONST64(0x3c6ef372fe94f82b), CONST64(0xa54ff53a5f1d36f1),
+  CONST64(0x510e527fade682d1), CONST64(0x9b05688c2b3e6c1f),
+  CONST64(0x1f83d9abfb41bd6b), CONST64(0x5be0cd19137e2179)
+};
+
+static const unsigned char blake2b_sigma[12][16] =
+{
+  {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 } ,
+  { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 } ,
+  { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 } ,
+  {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 } ,
+  {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 } ,
+  {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 } ,
+  { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 } ,
+  { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 } ,
+  {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 } ,
+  { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13 , 0 } ,
+  {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 } ,
+  { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+#ifdef LTC_AVX2
+
+/* one G step on the 4 columns (or diagonals) held in a, b, c, d */
+#define G4(a, b, c, d, m0, m1)                                                   \
+   do {                                                                         \
+      a = _mm256_add_epi64(_mm256_add_epi64(a, b), m0);                          \
+      d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1)); \
+      c = _mm256_add_epi64(c, d);                                                \
+      b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), r24);                      \
+      a = _mm256_add_epi64(_mm256_add_epi64(a, b), m1);                          \
+      d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), r16);                      \
+      c = _mm256_add_epi64(c, d);                                                \
+      b = _mm256_xor_si256(b, c);                                                \
+      b = _mm256_xor_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));    \
+   } while (0)
+
+/* the message words of G functions 0-3 (or 4-7) of round r */
+#define MSG4(r, o) _mm256_set_epi64x((long long)m[s[r][(o) + 6]], (long long)m[s[r][(o) + 4]], \
+                                     (long long)m[s[r][(o) + 2]], (long long)m[s[r][(o) + 0]])
+
+/**
+  Compress a block with AVX2, the CPU must support it
+  (crypt_cpu_has(LTC_CPU_AVX2))
+  @param st   The state, its counter already includes the block
+  @param buf  The 128 byte block
+*/
+__attribute__((target("avx2")))
+void blake2b_avx2_compress(struct blake2b_state *st, const unsigned char *buf)
+{
+   const __m256i r16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                        2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+   const __m256i r24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                        3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+   const unsigned char (*s)[16] = blake2b_sigma;
+   __m256i a, b, c, d, a0, b0;
+   ulong64 m[16];
+   int r;
+
+   XMEMCPY(m, buf, sizeof(m));
+
+   a = a0 = _mm256_loadu_si256((const __m256i *)(const void *)st->h);
+   b = b0 = _mm256_loadu_si256((const __m256i *)(const void *)(st->h + 4));
+   c = _mm256_loadu_si256((const __m256i *)(const void *)blake2b_IV);
+   d = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(const void *)(blake2b_IV + 4)),
+                        _mm256_set_epi64x((long long)st->f[1], (long long)st->f[0],
+                                          (long long)st->t[1], (long long)st->t[0]));
+
+   #pragma GCC unroll 12
+   for (r = 0; r < 12; r++) {
+      G4(a, b, c, d, MSG4(r, 0), MSG4(r, 1));
+      /* rotate rows 1-3 so the diagonals line up as columns */
+      b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+      c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+      d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+      G4(a, b, c, d, MSG4(r, 8), MSG4(r, 9));
+      b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+      c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+      d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+   }
+
+   _mm256_storeu_si256((__m256i *)(void *)st->h, _mm256_xor_si256(a0, _mm256_xor_si256(a, c)));
+   _mm256_storeu_si256((__m256i *)(void *)(st->h + 4), _mm256_xor_si256(b0, _mm256_xor_si256(b, d)));
+}
+
+#undef G4
+#undef MSG4
+
+#endif /* LTC_AVX2 */
+
+#ifdef LTC_SSSE3
+
+/* one G step, each row being held in two halves l and h */
+#define G2(al, ah, bl, bh, cl, ch, dl, dh, m0l, m0h, m1l, m1h)                         \
+   do {                                                                               \
+      al = _mm_add_epi64(_mm_add_epi64(al, bl), m0l);                                  \
+      ah = _mm_add_epi64(_mm_add_epi64(ah, bh), m0h);                                  \
+      dl = _mm_shuffle_epi32(_mm_xor_si128(dl, al), _MM_SHUFFLE(2, 3, 0, 1));          \
+      dh = _mm_shuffle_epi32(_mm_xor_si128(dh, ah), _MM_SHUFFLE(2, 3, 0, 1));          \
+      cl = _mm_add_epi64(cl, dl);                                                      \
+      ch = _mm_add_epi64(ch, dh);                                                      \
+      bl = _mm_shuffle_epi8(_mm_xor_si128(bl, cl), r24);                               \
+      bh = _mm_shuffle_epi8(_mm_xor_si128(bh, ch), r24);                               \
+      al = _mm_add_epi64(_mm_add_epi64(al, bl), m1l);                                  \
+      ah = _mm_add_epi64(_mm_add_epi64(ah, bh), m1h);                                  \
+      dl = _mm_shuffle_epi8(_mm_xor_si128(dl, al), r16);                               \
+      dh = _mm_shuffle_epi8(_mm_xor_si128(dh, ah), r16);                               \
+      cl = _mm_add_epi64(cl, dl);                                                      \
+      ch = _mm_add_epi64(ch, dh);                                                      \
+      bl = _mm_xor_si128(bl, cl);                                                      \
+      bh = _mm_xor_si128(bh, ch);                                                      \
+      bl = _mm_xor_si128(_mm_srli_epi64(bl, 63), _mm_add_epi64(bl, bl));               \
+      bh = _mm_xor_si128(_mm_srli_epi64(bh, 63), _mm_add_epi64(bh, bh));               \
+   } while (0)
+
+/* the message words of G functions i and i + 2 of round r */
+#define MSG2(r, o) _mm_set_epi64x((long long)m[s[r][(o) + 2]], (long long)m[s[r][(o) + 0]])
+
+/**
+  Compress a block with SSSE3, the CPU must support it
+  (crypt_cpu_has(LTC_CPU_SSSE3))
+  @param st   The state, its counter already includes the block
+  @param buf  The 128 byte block
+*/
+__attribute__((target("ssse3")))
+void blake2b_ssse3_compress(struct blake2b_state *st, const unsigned char *buf)
+{
+   const __m128i r16 = _mm_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+   const __m128i r24 = _mm_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+   const unsigned char (*s)[16] = blake2b_sigma;
+   __m128i al, ah, bl, bh, cl, ch, dl, dh, t0, t1;
+   ulong64 m[16];
+   int r;
+
+   XMEMCPY(m, buf, sizeof(m));
+
+   al = _mm_loadu_si128((const __m128i *)(const void *)st->h);
+   ah = _mm_loadu_si128((const __m128i *)(const void *)(st->h + 2));
+   bl = _mm_loadu_si128((const __m128i *)(const void *)(st->h + 4));
+   bh = _mm_loadu_si128((const __m128i *)(const void *)(st->h + 6));
+   cl = _mm_loadu_si128((const __m128i *)(const void *)blake2b_IV);
+   ch = _mm_loadu_si128((const __m128i *)(const void *)(blake2b_IV + 2));
+   dl = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)(blake2b_IV + 4)),
+                      _mm_loadu_si128((const __m128i *)(const void *)st->t));
+   dh = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)(blake2b_IV + 6)),
+                      _mm_loadu_si128((const __m128i *)(const void *)st->f));
+
+   #pragma GCC unroll 12
+   for (r = 0; r < 12; r++) {
+      G2(al, ah, bl, bh, cl, ch, dl, dh, MSG2(r, 0), MSG2(r, 4), MSG2(r, 1), MSG2(r, 5));
+      /* rotate rows 1-3 so the diagonals line up as columns */
+      t0 = _mm_alignr_epi8(bh, bl, 8);
+      t1 = _mm_alignr_epi8(bl, bh, 8);
+      bl = t0; bh = t1;
+      t0 = cl; cl = ch; ch = t0;
+      t0 = _mm_alignr_epi8(dh, dl, 8);
+      t1 = _mm_alignr_epi8(dl, dh, 8);
+      dl = t1; dh = t0;
+      G2(al, ah, bl, bh, cl, ch, dl, dh, MSG2(r, 8), MSG2(r, 12), MSG2(r, 9), MSG2(r, 13));
+      t0 = _mm_alignr_epi8(bl, bh, 8);
+      t1 = _mm_alignr_epi8(bh, bl, 8);
+      bl = t0; bh = t1;
+      t0 = cl; cl = ch; ch = t0;
+      t0 = _mm_alignr_epi8(dl, dh, 8);
+      t1 = _mm_alignr_epi8(dh, dl, 8);
+      dl = t1; dh = t0;
+   }
+
+   al = _mm_xor_si128(al, cl);
+   ah = _mm_xor_si128(ah, ch);
+   bl = _mm_xor_si128(bl, dl);
+   bh = _mm_xor_si128(bh, dh);
+   _mm_storeu_si128((__m128i *)(void *)st->h, _mm_xor_si128(al, _mm_loadu_si128((const __m128i *)(const void *)st->h)));
+   _mm_storeu_si128((__m128i *)(void *)(st->h + 2), _mm_xor_si128(ah, _mm_loadu_si128((const __m128i *)(const void *)(st->h + 2))));
+   _mm_storeu_si128((__m128i *)(void *)(st->h + 4), _mm_xor_si128(bl, _mm_loadu_si128((const __m128i *)(const void *)(st->h + 4))));
+   _mm_storeu_si128((__m128i *)(void *)(st->h + 6), _mm_xor_si128(bh, _mm_loadu_si128((const __m128i *)(const void *)(st->h + 6))));
+}
+
+#undef G2
+#undef MSG2
+
+#endif /* LTC_SSSE3 */
+
+#endif /* LTC_BLAKE2B && (LTC_SSSE3 || LTC_AVX2) */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -271,6 +271,13 @@ static int blake2s_compress(hash_state *md, const unsigned char *buf)
    ulong32 m[16];
    ulong32 v[16];
 
+#ifdef LTC_SSSE3
+   if (crypt_cpu_has(LTC_CPU_SSSE3)) {
+      blake2s_ssse3_compress(&md->blake2s, buf);
+      return CRYPT_OK;
+   }
+#endif
+
    for (i = 0; i < 16; ++i) {
       LOAD32L(m[i], buf + i * sizeof(m[i]));
    }
@@ -0,0 +1,110 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file blake2s_x86.c
+  LTC_BLAKE2S compression with SSSE3. A row of the state is 4 words, so
+  each row fits one register and a round is two G steps on 4 lanes, the
+  rows being rotated in between so the diagonals line up as columns.
+*/
+
+#if defined(LTC_BLAKE2S) && defined(LTC_SSSE3)
+
+#include "tomcrypt_x86.h"
+
+static const ulong32 blake2s_IV[8] = {
+    0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+    0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+static const unsigned char blake2s_sigma[10][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+};
+
+#define ROR4(x, n) _mm_or_si128(_mm_srli_epi32((x), (n)), _mm_slli_epi32((x), 32 - (n)))
+
+/* one G step on the 4 columns (or diagonals) held in a, b, c, d */
+#define G4(a, b, c, d, m0, m1)                                   \
+   do {                                                         \
+      a = _mm_add_epi32(_mm_add_epi32(a, b), m0);                \
+      d = _mm_shuffle_epi8(_mm_xor_si128(d, a), r16);            \
+      c = _mm_add_epi32(c, d);                                   \
+      b = _mm_xor_si128(b, c);                                   \
+      b = ROR4(b, 12);                                           \
+      a = _mm_add_epi32(_mm_add_epi32(a, b), m1);                \
+      d = _mm_shuffle_epi8(_mm_xor_si128(d, a), r8);             \
+      c = _mm_add_epi32(c, d);                                   \
+      b = _mm_xor_si128(b, c);                                   \
+      b = ROR4(b, 7);                                            \
+   } while (0)
+
+/* the message words of G functions 0-3 (or 4-7) of round r */
+#define MSG4(r, o) _mm_setr_epi32((int)m[s[r][(o) + 0]], (int)m[s[r][(o) + 2]], \
+                                  (int)m[s[r][(o) + 4]], (int)m[s[r][(o) + 6]])
+
+/**
+  Compress a block with SSSE3, the CPU must support it
+  (crypt_cpu_has(LTC_CPU_SSSE3))
+  @param st   The state, its counter already includes the block
+  @param buf  The 64 byte block
+*/
+__attribute__((target("ssse3")))
+void blake2s_ssse3_compress(struct blake2s_state *st, const unsigned char *buf)
+{
+   const __m128i r16 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+   const __m128i r8 = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+   const unsigned char (*s)[16] = blake2s_sigma;
+   __m128i a, b, c, d, a0, b0;
+   ulong32 m[16];
+   int r;
+
+   XMEMCPY(m, buf, sizeof(m));
+
+   a = a0 = _mm_loadu_si128((const __m128i *)(const void *)st->h);
+   b = b0 = _mm_loadu_si128((const __m128i *)(const void *)(st->h + 4));
+   c = _mm_loadu_si128((const __m128i *)(const void *)blake2s_IV);
+   d = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(const void *)(blake2s_IV + 4)),
+                     _mm_setr_epi32((int)st->t[0], (int)st->t[1], (int)st->f[0], (int)st->f[1]));
+
+   #pragma GCC unroll 10
+   for (r = 0; r < 10; r++) {
+      G4(a, b, c, d, MSG4(r, 0), MSG4(r, 1));
+      /* rotate rows 1-3 so the diagonals line up as columns */
+      b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1));
+      c = _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2));
+      d = _mm_shuffle_epi32(d, _MM_SHUFFLE(2, 1, 0, 3));
+      G4(a, b, c, d, MSG4(r, 8), MSG4(r, 9));
+      b = _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3));
+      c = _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2));
+      d = _mm_shuffle_epi32(d, _MM_SHUFFLE(0, 3, 2, 1));
+   }
+
+   _mm_storeu_si128((__m128i *)(void *)st->h, _mm_xor_si128(a0, _mm_xor_si128(a, c)));
+   _mm_storeu_si128((__m128i *)(void *)(st->h + 4), _mm_xor_si128(b0, _mm_xor_si128(b, d)));
+}
+
+#undef ROR4
+#undef G4
+#undef MSG4
+
+#endif /* LTC_BLAKE2S && LTC_SSSE3 */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -0,0 +1,579 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+/* see also https://github.com/BLAKE3-team/BLAKE3-specs/blob/master/blake3.pdf */
+
+#include "tomcrypt.h"
+
+/**
+  @file blake3.c
+  BLAKE3 hash function. The input is split into 1024 byte chunks, hashed
+  independently, and their chaining values are combined by a binary tree
+  of parent nodes. Runs of whole chunks are hashed as complete subtrees,
+  many chunks side by side, and blake3_subtree() / blake3_push_subtree()
+  let a caller hash subtrees of one input on several threads.
+*/
+
+#ifdef LTC_BLAKE3
+
+enum blake3_constant {
+   BLAKE3_BLOCKBYTES = 64,
+   BLAKE3_CHUNKBYTES = 1024,
+   BLAKE3_OUTBYTES = 32,
+   /* chunks a subtree is hashed by at the bottom of _blake3_subtree() */
+   BLAKE3_WIDE = 32
+};
+
+/* domain separation flags */
+enum {
+   CHUNK_START = 1,
+   CHUNK_END = 2,
+   PARENT = 4,
+   ROOT = 8
+};
+
+const struct ltc_hash_descriptor blake3_desc =
+{
+    "blake3",
+    29,
+    32,
+    64,
+    { 0 },
+    0,
+    &blake3_init,
+    &blake3_process,
+    &blake3_done,
+    &blake3_test,
+    NULL
+};
+
+static const ulong32 blake3_IV[8] = {
+    0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+    0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+/* message words of each round, the fixed permutation applied 0..6 times */
+static const unsigned char blake3_schedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+};
+
+#define G(r, i, a, b, c, d)                                                    \
+   do {                                                                        \
+      a = a + b + m[blake3_schedule[r][2 * i + 0]];                            \
+      d = ROR(d ^ a, 16);                                                      \
+      c = c + d;                                                               \
+      b = ROR(b ^ c, 12);                                                      \
+      a = a + b + m[blake3_schedule[r][2 * i + 1]];                            \
+      d = ROR(d ^ a, 8);                                                       \
+      c = c + d;                                                               \
+      b = ROR(b ^ c, 7);                                                       \
+   } while (0)
+
+#define ROUND(r)                                                               \
+   do {                                                                        \
+      G(r, 0, v[0], v[4], v[8], v[12]);                                        \
+      G(r, 1, v[1], v[5], v[9], v[13]);                                        \
+      G(r, 2, v[2], v[6], v[10], v[14]);                                       \
+      G(r, 3, v[3], v[7], v[11], v[15]);                                       \
+      G(r, 4, v[0], v[5], v[10], v[15]);                                       \
+      G(r, 5, v[1], v[6], v[11], v[12]);                                       \
+      G(r, 6, v[2], v[7], v[8], v[13]);                                        \
+      G(r, 7, v[3], v[4], v[9], v[14]);                                        \
+   } while (0)
+
+/* compress a block into the chaining value cv */
+static void _blake3_compress(ulong32 cv[8], const unsigned char *block, ulong32 blocklen, ulong64 counter, ulong32 flags)
+{
+   ulong32 m[16];
+   ulong32 v[16];
+   int i;
+
+   for (i = 0; i < 16; ++i) {
+      LOAD32L(m[i], block + i * 4);
+   }
+   for (i = 0; i < 8; ++i) {
+      v[i] = cv[i];
+   }
+   v[8] = blake3_IV[0];
+   v[9] = blake3_IV[1];
+   v[10] = blake3_IV[2];
+   v[11] = blake3_IV[3];
+   v[12] = (ulong32)counter;
+   v[13] = (ulong32)(counter >> 32);
+   v[14] = blocklen;
+   v[15] = flags;
+
+   ROUND(0);
+   ROUND(1);
+   ROUND(2);
+   ROUND(3);
+   ROUND(4);
+   ROUND(5);
+   ROUND(6);
+
+   for (i = 0; i < 8; ++i) {
+      cv[i] = v[i] ^ v[i + 8];
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(m, sizeof(m));
+   zeromem(v, sizeof(v));
+#endif
+}
+
+#undef G
+#undef ROUND
+
+/*
+   Hash n inputs of the same number of blocks, each to a 32 byte chaining
+   value in out. The counter of input i is counter + i if inc is set, the
+   first block of each input gets fstart and the last fend on top of flags.
+*/
+static void _blake3_hash_many(const unsigned char *const *in, unsigned long n, unsigned long blocks,
+                              const ulong32 key[8], ulong64 counter, int inc,
+                              ulong32 flags, ulong32 fstart, ulong32 fend, unsigned char *out)
+{
+   ulong32 cv[8];
+   unsigned long i, b;
+   int j;
+
+#ifdef LTC_AVX2
+   if (n >= 8 && crypt_cpu_has(LTC_CPU_AVX2)) {
+      for (; n >= 8; n -= 8, in += 8, out += 8 * BLAKE3_OUTBYTES) {
+         blake3_avx2_hash8(in, blocks, key, counter, inc, flags, fstart, fend, out);
+         if (inc) counter += 8;
+      }
+   }
+#endif
+
+   for (i = 0; i < n; i++, out += BLAKE3_OUTBYTES) {
+      for (j = 0; j < 8; j++) {
+         cv[j] = key[j];
+      }
+      for (b = 0; b < blocks; b++) {
+         _blake3_compress(cv, in[i] + b * BLAKE3_BLOCKBYTES, BLAKE3_BLOCKBYTES, counter, flags |
+                          (b == 0 ? fstart : 0) | (b == blocks - 1 ? fend : 0));
+      }
+      for (j = 0; j < 8; j++) {
+         STORE32L(cv[j], out + 4 * j);
+      }
+      if (inc) counter++;
+   }
+}
+
+/* the chaining value of a parent node, its two children side by side in block */
+static void _blake3_parent(const ulong32 key[8], ulong32 flags, const unsigned char *block, unsigned char *cv)
+{
+   ulong32 h[8];
+   int i;
+
+   for (i = 0; i < 8; i++) {
+      h[i] = key[i];
+   }
+   _blake3_compress(h, block, BLAKE3_BLOCKBYTES, 0, flags | PARENT);
+   for (i = 0; i < 8; i++) {
+      STORE32L(h[i], cv + 4 * i);
+   }
+}
+
+/*
+   The chaining value of a complete subtree of chunks (a power of 2),
+   starting at chunk index counter. Up to BLAKE3_WIDE chunks are hashed
+   side by side, and so are the parent nodes above them.
+*/
+static void _blake3_subtree(const ulong32 key[8], ulong32 flags, const unsigned char *in,
+                            unsigned long chunks, ulong64 counter, unsigned char *cv)
+{
+   const unsigned char *ptr[BLAKE3_WIDE] = { NULL };
+   unsigned char cvs[2][BLAKE3_WIDE * BLAKE3_OUTBYTES];
+   unsigned char pair[2 * BLAKE3_OUTBYTES];
+   unsigned long i, n;
+   int cur = 0;
+
+   if (chunks > BLAKE3_WIDE) {
+      _blake3_subtree(key, flags, in, chunks / 2, counter, pair);
+      _blake3_subtree(key, flags, in + chunks / 2 * BLAKE3_CHUNKBYTES, chunks / 2, counter + chunks / 2,
+                      pair + BLAKE3_OUTBYTES);
+      _blake3_parent(key, flags, pair, cv);
+      return;
+   }
+
+   for (i = 0; i < chunks; i++) {
+      ptr[i] = in + i * BLAKE3_CHUNKBYTES;
+   }
+   _blake3_hash_many(ptr, chunks, BLAKE3_CHUNKBYTES / BLAKE3_BLOCKBYTES, key, counter, 1,
+                     flags, CHUNK_START, CHUNK_END, cvs[cur]);
+
+   for (n = chunks; n > 1; n /= 2, cur ^= 1) {
+      for (i = 0; i < n / 2; i++) {
+         ptr[i] = cvs[cur] + i * 2 * BLAKE3_OUTBYTES;
+      }
+      _blake3_hash_many(ptr, n / 2, 1, key, 0, 0, flags | PARENT, 0, 0, cvs[cur ^ 1]);
+   }
+   XMEMCPY(cv, cvs[cur], BLAKE3_OUTBYTES);
+}
+
+/*
+   Merge the subtrees on the stack that are complete once chunk index
+   counter is reached. The rest wait in case they turn out to be part of
+   the root.
+*/
+static void _blake3_merge(struct blake3_state *s, ulong64 counter)
+{
+   unsigned char pair[2 * BLAKE3_OUTBYTES];
+   unsigned long keep = 0;
+   int i;
+
+   for (; counter != 0; counter &= counter - 1) {
+      keep++;
+   }
+   while (s->depth > keep) {
+      for (i = 0; i < 8; i++) {
+         STORE32L(s->stack[s->depth - 2][i], pair + 4 * i);
+         STORE32L(s->stack[s->depth - 1][i], pair + BLAKE3_OUTBYTES + 4 * i);
+      }
+      _blake3_parent(s->key, s->flags, pair, pair);
+      s->depth--;
+      for (i = 0; i < 8; i++) {
+         LOAD32L(s->stack[s->depth - 1][i], pair + 4 * i);
+      }
+   }
+}
+
+/* push the chaining value of a subtree starting at chunk index counter */
+static int _blake3_push_cv(hash_state *md, const unsigned char *cv, ulong64 counter)
+{
+   struct blake3_state *s = &md->blake3;
+   int i;
+
+   _blake3_merge(s, counter);
+   if (s->depth == LTC_BLAKE3_MAX_DEPTH) {
+      return CRYPT_HASH_OVERFLOW;
+   }
+   for (i = 0; i < 8; i++) {
+      LOAD32L(s->stack[s->depth][i], cv + 4 * i);
+   }
+   s->depth++;
+   return CRYPT_OK;
+}
+
+/* finish a chunk that is known not to be the last of the input */
+static int _blake3_end_chunk(hash_state *md)
+{
+   struct blake3_state *s = &md->blake3;
+   unsigned char cv[BLAKE3_OUTBYTES];
+   int i, err;
+
+   _blake3_compress(s->cv, s->buf, BLAKE3_BLOCKBYTES, s->chunk, s->flags | CHUNK_END);
+   for (i = 0; i < 8; i++) {
+      STORE32L(s->cv[i], cv + 4 * i);
+   }
+   if ((err = _blake3_push_cv(md, cv, s->chunk)) != CRYPT_OK) {
+      return err;
+   }
+   for (i = 0; i < 8; i++) {
+      s->cv[i] = s->key[i];
+   }
+   s->chunk++;
+   s->blocks = 0;
+   s->curlen = 0;
+   return CRYPT_OK;
+}
+
+/**
+   Initialize the hash state
+   @param md   The hash state you wish to initialize
+   @return CRYPT_OK if successful
+*/
+int blake3_init(hash_state *md)
+{
+   int i;
+
+   LTC_ARGCHK(md != NULL);
+
+   XMEMSET(&md->blake3, 0, sizeof(md->blake3));
+   for (i = 0; i < 8; i++) {
+      md->blake3.key[i] = md->blake3.cv[i] = blake3_IV[i];
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Process a block of memory though the hash
+   @param md     The hash state
+   @param in     The data to hash
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK if successful
+*/
+int blake3_process(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+   struct blake3_state *s;
+   unsigned long n, chunks;
+   unsigned char cv[BLAKE3_OUTBYTES];
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(in != NULL || inlen == 0);
+
+   s = &md->blake3;
+   if (s->curlen > sizeof(s->buf)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   while (inlen > 0) {
+      /* at a chunk boundary, with more than a chunk to go: whole subtrees */
+      if (s->blocks == 0 && s->curlen == 0 && inlen > BLAKE3_CHUNKBYTES) {
+         chunks = (inlen - 1) / BLAKE3_CHUNKBYTES;
+         for (n = 1; n <= chunks / 2; n *= 2);
+         while ((s->chunk & (n - 1)) != 0) {
+            n /= 2;
+         }
+         _blake3_subtree(s->key, s->flags, in, n, s->chunk, cv);
+         if ((err = _blake3_push_cv(md, cv, s->chunk)) != CRYPT_OK) {
+            return err;
+         }
+         s->chunk += n;
+         in += n * BLAKE3_CHUNKBYTES;
+         inlen -= n * BLAKE3_CHUNKBYTES;
+         continue;
+      }
+
+      /* a full block is only compressed once more input shows it is not the last */
+      if (s->curlen == BLAKE3_BLOCKBYTES) {
+         if (s->blocks == BLAKE3_CHUNKBYTES / BLAKE3_BLOCKBYTES - 1) {
+            if ((err = _blake3_end_chunk(md)) != CRYPT_OK) {
+               return err;
+            }
+            continue;
+         }
+         _blake3_compress(s->cv, s->buf, BLAKE3_BLOCKBYTES, s->chunk, s->flags | (s->blocks == 0 ? CHUNK_START : 0));
+         s->blocks++;
+         s->curlen = 0;
+      }
+
+      n = MIN(inlen, BLAKE3_BLOCKBYTES - s->curlen);
+      XMEMCPY(s->buf + s->curlen, in, n);
+      s->curlen += n;
+      in += n;
+      inlen -= n;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Terminate the hash to get the digest
+   @param md   The hash state
+   @param out  [out] The destination of the hash (32 bytes)
+   @return CRYPT_OK if successful
+*/
+int blake3_done(hash_state *md, unsigned char *out)
+{
+   struct blake3_state *s;
+   unsigned char block[BLAKE3_BLOCKBYTES];
+   ulong32 flags;
+   unsigned long i;
+   int j;
+
+   LTC_ARGCHK(md  != NULL);
+   LTC_ARGCHK(out != NULL);
+
+   s = &md->blake3;
+   if (s->curlen > sizeof(s->buf)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the last chunk, then the parents above it up to the root */
+   _blake3_merge(s, s->chunk);
+   XMEMSET(s->buf + s->curlen, 0, BLAKE3_BLOCKBYTES - s->curlen);
+   flags = s->flags | CHUNK_END | (s->blocks == 0 ? CHUNK_START : 0) | (s->depth == 0 ? ROOT : 0);
+   _blake3_compress(s->cv, s->buf, (ulong32)s->curlen, s->chunk, flags);
+
+   for (i = s->depth; i-- > 0; ) {
+      for (j = 0; j < 8; j++) {
+         STORE32L(s->stack[i][j], block + 4 * j);
+         STORE32L(s->cv[j], block + BLAKE3_OUTBYTES + 4 * j);
+         s->cv[j] = s->key[j];
+      }
+      _blake3_compress(s->cv, block, BLAKE3_BLOCKBYTES, 0, s->flags | PARENT | (i == 0 ? ROOT : 0));
+   }
+
+   for (j = 0; j < 8; j++) {
+      STORE32L(s->cv[j], out + 4 * j);
+   }
+   zeromem(md, sizeof(hash_state));
+#ifdef LTC_CLEAN_STACK
+   zeromem(block, sizeof(block));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+   Get the index of the next chunk, for blake3_subtree()
+   @param md     The hash state, fed a multiple of 1024 bytes so far
+   @param chunk  [out] The index of the chunk the next input starts
+   @return CRYPT_OK if successful, CRYPT_INVALID_ARG if md is part way through a chunk
+*/
+int blake3_chunk(const hash_state *md, ulong64 *chunk)
+{
+   const struct blake3_state *s;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(chunk != NULL);
+
+   s = &md->blake3;
+   if (s->blocks == 0 && s->curlen == 0) {
+      *chunk = s->chunk;
+   } else if (s->blocks == BLAKE3_CHUNKBYTES / BLAKE3_BLOCKBYTES - 1 && s->curlen == BLAKE3_BLOCKBYTES) {
+      *chunk = s->chunk + 1;
+   } else {
+      return CRYPT_INVALID_ARG;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Hash a complete subtree of an input, e.g., on another thread than the
+   one feeding the hash state. The result goes to blake3_push_subtree().
+   @param md     The hash state the subtree belongs to (not changed)
+   @param in     The subtree
+   @param inlen  The length of the subtree, 1024 times a power of 2
+   @param chunk  The index of its first chunk, a multiple of inlen / 1024
+   @param cv     [out] Its chaining value (32 bytes)
+   @return CRYPT_OK if successful
+*/
+int blake3_subtree(const hash_state *md, const unsigned char *in, unsigned long inlen, ulong64 chunk, unsigned char *cv)
+{
+   unsigned long chunks;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(in != NULL);
+   LTC_ARGCHK(cv != NULL);
+
+   chunks = inlen / BLAKE3_CHUNKBYTES;
+   if (chunks == 0 || inlen % BLAKE3_CHUNKBYTES != 0 || (chunks & (chunks - 1)) != 0 || (chunk & (chunks - 1)) != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   _blake3_subtree(md->blake3.key, md->blake3.flags, in, chunks, chunk, cv);
+   return CRYPT_OK;
+}
+
+/**
+   Add a subtree hashed by blake3_subtree() to the hash state, as if its
+   input had been given to blake3_process(). It must start at the chunk
+   blake3_chunk() reports, and more input must follow it.
+   @param md     The hash state
+   @param cv     The chaining value of the subtree
+   @param inlen  The length of the subtree
+   @return CRYPT_OK if successful
+*/
+int blake3_push_subtree(hash_state *md, const unsigned char *cv, unsigned long inlen)
+{
+   struct blake3_state *s;
+   unsigned long chunks;
+   ulong64 chunk;
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(cv != NULL);
+
+   s = &md->blake3;
+   chunks = inlen / BLAKE3_CHUNKBYTES;
+   if ((err = blake3_chunk(md, &chunk)) != CRYPT_OK) {
+      return err;
+   }
+   if (chunks == 0 || inlen % BLAKE3_CHUNKBYTES != 0 || (chunks & (chunks - 1)) != 0 || (chunk & (chunks - 1)) != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (s->curlen != 0 && (err = _blake3_end_chunk(md)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = _blake3_push_cv(md, cv, s->chunk)) != CRYPT_OK) {
+      return err;
+   }
+   s->chunk += chunks;
+   return CRYPT_OK;
+}
+
+/**
+  Self-test the hash
+  @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
+*/
+int blake3_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* from the official test vectors, input byte i is i % 251 */
+   static const struct {
+      unsigned long len;
+      unsigned char hash[32];
+   } tests[] = {
+      { 0,
+        { 0xaf, 0x13, 0x49, 0xb9, 0xf5, 0xf9, 0xa1, 0xa6, 0xa0, 0x40, 0x4d, 0xea, 0x36, 0xdc, 0xc9, 0x49,
+          0x9b, 0xcb, 0x25, 0xc9, 0xad, 0xc1, 0x12, 0xb7, 0xcc, 0x9a, 0x93, 0xca, 0xe4, 0x1f, 0x32, 0x62 } },
+      { 1,
+        { 0x2d, 0x3a, 0xde, 0xdf, 0xf1, 0x1b, 0x61, 0xf1, 0x4c, 0x88, 0x6e, 0x35, 0xaf, 0xa0, 0x36, 0x73,
+          0x6d, 0xcd, 0x87, 0xa7, 0x4d, 0x27, 0xb5, 0xc1, 0x51, 0x02, 0x25, 0xd0, 0xf5, 0x92, 0xe2, 0x13 } },
+      { 1024,
+        { 0x42, 0x21, 0x47, 0x39, 0xf0, 0x95, 0xa4, 0x06, 0xf3, 0xfc, 0x83, 0xde, 0xb8, 0x89, 0x74, 0x4a,
+          0xc0, 0x0d, 0xf8, 0x31, 0xc1, 0x0d, 0xaa, 0x55, 0x18, 0x9b, 0x5d, 0x12, 0x1c, 0x85, 0x5a, 0xf7 } },
+      { 1025,
+        { 0xd0, 0x02, 0x78, 0xae, 0x47, 0xeb, 0x27, 0xb3, 0x4f, 0xae, 0xcf, 0x67, 0xb4, 0xfe, 0x26, 0x3f,
+          0x82, 0xd5, 0x41, 0x29, 0x16, 0xc1, 0xff, 0xd9, 0x7c, 0x8c, 0xb7, 0xfb, 0x81, 0x4b, 0x84, 0x44 } },
+      { 8193,
+        { 0xba, 0xb6, 0xc0, 0x9c, 0xb8, 0xce, 0x8c, 0xf4, 0x59, 0x26, 0x13, 0x98, 0xd2, 0xe7, 0xae, 0xf3,
+          0x57, 0x00, 0xbf, 0x48, 0x81, 0x16, 0xce, 0xb9, 0x4a, 0x36, 0xd0, 0xf5, 0xf1, 0xb7, 0xbc, 0x3b } },
+      { 31744,
+        { 0x62, 0xb6, 0x96, 0x0e, 0x1a, 0x44, 0xbc, 0xc1, 0xeb, 0x1a, 0x61, 0x1a, 0x8d, 0x62, 0x35, 0xb6,
+          0xb4, 0xb7, 0x8f, 0x32, 0xe7, 0xab, 0xc4, 0xfb, 0x4c, 0x6c, 0xdc, 0xce, 0x94, 0x89, 0x5c, 0x47 } },
+      { 102400,
+        { 0xbc, 0x3e, 0x3d, 0x41, 0xa1, 0x14, 0x6b, 0x06, 0x9a, 0xbf, 0xfa, 0xd3, 0xc0, 0xd4, 0x48, 0x60,
+          0xcf, 0x66, 0x43, 0x90, 0xaf, 0xce, 0x4d, 0x96, 0x61, 0xf7, 0x90, 0x2e, 0x79, 0x43, 0xe0, 0x85 } },
+   };
+
+   unsigned char *buf, tmp[32];
+   unsigned long i, j, step;
+   hash_state md;
+
+   if ((buf = XMALLOC(102400)) == NULL) {
+      return CRYPT_MEM;
+   }
+   for (i = 0; i < 102400; i++) {
+      buf[i] = (unsigned char)(i % 251);
+   }
+
+   for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+      /* all at once, then in odd sized pieces */
+      for (step = tests[i].len + 1; step > 0; step = (step == 1) ? 0 : 1 + step / 7) {
+         blake3_init(&md);
+         for (j = 0; j < tests[i].len; j += step) {
+            blake3_process(&md, buf + j, MIN(step, tests[i].len - j));
+         }
+         blake3_done(&md, tmp);
+         if (compare_testvector(tmp, sizeof(tmp), tests[i].hash, sizeof(tests[i].hash), "BLAKE3", (int)i)) {
+            XFREE(buf);
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+
+   XFREE(buf);
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
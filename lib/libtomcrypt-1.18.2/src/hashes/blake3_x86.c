@@ -0,0 +1,171 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file blake3_x86.c
+  LTC_BLAKE3 compression of 8 inputs at once with AVX2. Word i of the
+  8 states is kept in one register, lane j belonging to input j, so the
+  G functions run on whole registers without any shuffling between the
+  column and the diagonal steps.
+*/
+
+#if defined(LTC_BLAKE3) && defined(LTC_AVX2)
+
+#include "tomcrypt_x86.h"
+
+static const ulong32 blake3_IV[4] = {
+    0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL
+};
+
+static const unsigned char blake3_schedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+};
+
+#define ROR8(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+#define G8(a, b, c, d, m0, m1)                                   \
+   do {                                                         \
+      a = _mm256_add_epi32(_mm256_add_epi32(a, b), m0);          \
+      d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), r16);      \
+      c = _mm256_add_epi32(c, d);                                \
+      b = _mm256_xor_si256(b, c);                                \
+      b = ROR8(b, 12);                                           \
+      a = _mm256_add_epi32(_mm256_add_epi32(a, b), m1);          \
+      d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), r8);       \
+      c = _mm256_add_epi32(c, d);                                \
+      b = _mm256_xor_si256(b, c);                                \
+      b = ROR8(b, 7);                                            \
+   } while (0)
+
+/* the 8x8 32-bit transpose, r[i] lane j <-> r[j] lane i */
+__attribute__((target("avx2")))
+static LTC_INLINE void _transpose8(__m256i *r)
+{
+   __m256i t0, t1, t2, t3, t4, t5, t6, t7, u0, u1, u2, u3, u4, u5, u6, u7;
+
+   t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+   t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+   t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+   t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+   t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+   t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+   t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+   t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+   u0 = _mm256_unpacklo_epi64(t0, t2);
+   u1 = _mm256_unpackhi_epi64(t0, t2);
+   u2 = _mm256_unpacklo_epi64(t1, t3);
+   u3 = _mm256_unpackhi_epi64(t1, t3);
+   u4 = _mm256_unpacklo_epi64(t4, t6);
+   u5 = _mm256_unpackhi_epi64(t4, t6);
+   u6 = _mm256_unpacklo_epi64(t5, t7);
+   u7 = _mm256_unpackhi_epi64(t5, t7);
+   r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+   r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+   r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+   r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+   r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+   r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+   r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+   r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/**
+  Hash 8 inputs of the same number of blocks with AVX2, the CPU must
+  support it (crypt_cpu_has(LTC_CPU_AVX2))
+  @param in       The 8 inputs
+  @param blocks   The number of 64 byte blocks of each input
+  @param key      The chaining value all inputs start with
+  @param counter  The counter of the first input
+  @param inc      Non-zero if input j has counter + j, otherwise all share counter
+  @param flags    The flags of every block
+  @param fstart   Further flags of the first block
+  @param fend     Further flags of the last block
+  @param out      [out] The 8 chaining values, 32 bytes each
+*/
+__attribute__((target("avx2")))
+void blake3_avx2_hash8(const unsigned char *const *in, unsigned long blocks, const ulong32 key[8],
+                       ulong64 counter, int inc, ulong32 flags, ulong32 fstart, ulong32 fend, unsigned char *out)
+{
+   const __m256i r16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                        2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+   const __m256i r8 = _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                       1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+   const unsigned char (*s)[16] = blake3_schedule;
+   __m256i h[8], v[16], m[16], ctrlo, ctrhi;
+   ulong32 lo[8], hi[8], f;
+   unsigned long b;
+   int i, r;
+
+   for (i = 0; i < 8; i++) {
+      h[i] = _mm256_set1_epi32((int)key[i]);
+      lo[i] = (ulong32)(counter + (inc ? i : 0));
+      hi[i] = (ulong32)((counter + (inc ? i : 0)) >> 32);
+   }
+   ctrlo = _mm256_loadu_si256((const __m256i *)(const void *)lo);
+   ctrhi = _mm256_loadu_si256((const __m256i *)(const void *)hi);
+
+   for (b = 0; b < blocks; b++) {
+      /* words 0-7 and 8-15 of each block, then one word of all 8 per register */
+      for (i = 0; i < 8; i++) {
+         m[i] = _mm256_loadu_si256((const __m256i *)(const void *)(in[i] + 64 * b));
+         m[i + 8] = _mm256_loadu_si256((const __m256i *)(const void *)(in[i] + 64 * b + 32));
+      }
+      _transpose8(m);
+      _transpose8(m + 8);
+
+      f = flags | (b == 0 ? fstart : 0) | (b == blocks - 1 ? fend : 0);
+      for (i = 0; i < 8; i++) {
+         v[i] = h[i];
+      }
+      for (i = 0; i < 4; i++) {
+         v[i + 8] = _mm256_set1_epi32((int)blake3_IV[i]);
+      }
+      v[12] = ctrlo;
+      v[13] = ctrhi;
+      v[14] = _mm256_set1_epi32(64);
+      v[15] = _mm256_set1_epi32((int)f);
+
+      for (r = 0; r < 7; r++) {
+         G8(v[0], v[4], v[8],  v[12], m[s[r][0]],  m[s[r][1]]);
+         G8(v[1], v[5], v[9],  v[13], m[s[r][2]],  m[s[r][3]]);
+         G8(v[2], v[6], v[10], v[14], m[s[r][4]],  m[s[r][5]]);
+         G8(v[3], v[7], v[11], v[15], m[s[r][6]],  m[s[r][7]]);
+         G8(v[0], v[5], v[10], v[15], m[s[r][8]],  m[s[r][9]]);
+         G8(v[1], v[6], v[11], v[12], m[s[r][10]], m[s[r][11]]);
+         G8(v[2], v[7], v[8],  v[13], m[s[r][12]], m[s[r][13]]);
+         G8(v[3], v[4], v[9],  v[14], m[s[r][14]], m[s[r][15]]);
+      }
+
+      for (i = 0; i < 8; i++) {
+         h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+      }
+   }
+
+   /* back to one chaining value per register, the words are little endian */
+   _transpose8(h);
+   for (i = 0; i < 8; i++) {
+      _mm256_storeu_si256((__m256i *)(void *)(out + 32 * i), h[i]);
+   }
+}
+
+#undef G8
+#undef ROR8
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -0,0 +1,387 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+#ifdef LTC_HASH_HELPERS
+/**
+  @file hash_memory_batch.c
+  Hash many independent messages. SHA-1 and SHA-256 are run 8
+  messages at a time through the AVX2 kernels when the CPU has them,
+  SHA-3 4 at a time.
+*/
+
+#ifdef LTC_AVX2
+
+/* below this many busy lanes, and with no messages left to start, the
+ * remaining ones are finished one by one */
+#define MB_SCALAR_LANES 2
+
+typedef void (*_mb_x8_fn)(ulong32 (*state)[8], const unsigned char *const *blk);
+
+typedef struct {
+   const unsigned char *p;       /* next unread message byte      */
+   unsigned long full;           /* complete blocks left at p     */
+   unsigned long rem;            /* bytes after them, < 64        */
+   unsigned char tail[128];      /* rem bytes plus the padding    */
+   int ntail, itail;             /* tail blocks, tail blocks done */
+   ulong64 blocks;               /* blocks compressed so far      */
+   unsigned long msg;            /* message in this lane          */
+   int busy;
+} _mb_lane;
+
+static const unsigned char _mb_idle[64] = { 0 };
+
+/* start message m in lane j */
+static void _mb_start(_mb_lane *l, ulong32 (*st)[8], int j, int words, const ulong32 *iv,
+                      unsigned long m, const unsigned char *in, unsigned long inlen)
+{
+   int w;
+
+   l->p      = in;
+   l->full   = inlen / 64;
+   l->rem    = inlen % 64;
+   l->blocks = 0;
+   l->itail  = 0;
+   l->ntail  = (l->rem < 56) ? 1 : 2;
+   l->msg    = m;
+   l->busy   = 1;
+
+   zeromem(l->tail, sizeof(l->tail));
+   if (l->rem) {
+      XMEMCPY(l->tail, in + 64 * l->full, l->rem);
+   }
+   l->tail[l->rem] = 0x80;
+   STORE64H((ulong64)inlen * 8, l->tail + 64 * l->ntail - 8);
+
+   for (w = 0; w < words; w++) {
+      st[w][j] = iv[w];
+   }
+}
+
+/* finish the message in lane j without the other lanes */
+static int _mb_finish(int hash, _mb_lane *l, ulong32 (*st)[8], int j, int words, unsigned char *out)
+{
+   hash_state md;
+   int w, err;
+
+   if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
+      return err;
+   }
+   for (w = 0; w < words; w++) {
+      if (words == 8) md.sha256.state[w] = st[w][j];
+      else            md.sha1.state[w]   = st[w][j];
+   }
+   if (words == 8) md.sha256.length = l->blocks * 512;
+   else            md.sha1.length   = l->blocks * 512;
+
+   if ((err = hash_descriptor[hash].process(&md, l->p, l->full * 64 + l->rem)) != CRYPT_OK) {
+      return err;
+   }
+   err = hash_descriptor[hash].done(&md, out);
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+#endif
+   return err;
+}
+
+static int _mb_run(int hash, _mb_x8_fn x8, int words, const ulong32 *iv,
+                   const unsigned char **in, const unsigned long *inlen,
+                   unsigned char **out, unsigned long n)
+{
+   ulong32 st[8][8];
+   const unsigned char *blk[8];
+   _mb_lane *lane;
+   unsigned long next = 0;
+   int j, w, active = 0, err = CRYPT_OK;
+
+   lane = XCALLOC(8, sizeof(_mb_lane));
+   if (lane == NULL) {
+      return CRYPT_MEM;
+   }
+
+   for (j = 0; j < 8 && next < n; j++, next++, active++) {
+      _mb_start(&lane[j], st, j, words, iv, next, in[next], inlen[next]);
+   }
+
+   while (active > 0) {
+      if (next == n && active <= MB_SCALAR_LANES) {
+         for (j = 0; j < 8; j++) {
+            if (lane[j].busy && lane[j].itail == 0) {
+               if ((err = _mb_finish(hash, &lane[j], st, j, words, out[lane[j].msg])) != CRYPT_OK) {
+                  goto LBL_ERR;
+               }
+               lane[j].busy = 0;
+               --active;
+            }
+         }
+         if (active == 0) {
+            break;
+         }
+      }
+
+      for (j = 0; j < 8; j++) {
+         if (!lane[j].busy)        blk[j] = _mb_idle;
+         else if (lane[j].full)    blk[j] = lane[j].p;
+         else                      blk[j] = lane[j].tail + 64 * lane[j].itail;
+      }
+      x8(st, blk);
+
+      for (j = 0; j < 8; j++) {
+         if (!lane[j].busy) {
+            continue;
+         }
+         lane[j].blocks++;
+         if (lane[j].full) {
+            lane[j].p += 64;
+            lane[j].full--;
+            continue;
+         }
+         if (++lane[j].itail < lane[j].ntail) {
+            continue;
+         }
+         for (w = 0; w < words; w++) {
+            STORE32H(st[w][j], out[lane[j].msg] + 4 * w);
+         }
+         if (next < n) {
+            _mb_start(&lane[j], st, j, words, iv, next, in[next], inlen[next]);
+            next++;
+         } else {
+            lane[j].busy = 0;
+            --active;
+         }
+      }
+   }
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(lane, 8 * sizeof(_mb_lane));
+   zeromem(st, sizeof(st));
+#endif
+   XFREE(lane);
+   return err;
+}
+
+#ifdef LTC_SHA3
+
+/* below this many busy SHA-3 lanes, and with no messages left to start,
+ * the remaining ones are finished one by one */
+#define MB_SHA3_SCALAR_LANES 1
+
+typedef struct {
+   const unsigned char *p;       /* next unread message byte      */
+   unsigned long full;           /* complete blocks left at p     */
+   unsigned long rem;            /* bytes after them, < rate      */
+   unsigned char tail[144];      /* rem bytes plus the padding    */
+   unsigned long msg;            /* message in this lane          */
+   int busy;
+} _mb3_lane;
+
+/* start message m in lane j */
+static void _mb3_start(_mb3_lane *l, ulong64 (*st)[4], int j, unsigned long rate,
+                       unsigned long m, const unsigned char *in, unsigned long inlen)
+{
+   int w;
+
+   l->p    = in;
+   l->full = inlen / rate;
+   l->rem  = inlen % rate;
+   l->msg  = m;
+   l->busy = 1;
+
+   zeromem(l->tail, sizeof(l->tail));
+   if (l->rem) {
+      XMEMCPY(l->tail, in + rate * l->full, l->rem);
+   }
+   l->tail[l->rem] = 0x06;
+   l->tail[rate - 1] |= 0x80;
+
+   for (w = 0; w < 25; w++) {
+      st[w][j] = 0;
+   }
+}
+
+/* finish the message in lane j without the other lanes */
+static int _mb3_finish(int hash, _mb3_lane *l, ulong64 (*st)[4], int j, unsigned long rate, unsigned char *out)
+{
+   hash_state md;
+   int w, err;
+
+   if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
+      return err;
+   }
+   for (w = 0; w < 25; w++) {
+      md.sha3.s[w] = st[w][j];
+   }
+   if ((err = sha3_process(&md, l->p, l->full * rate + l->rem)) != CRYPT_OK) {
+      return err;
+   }
+   err = sha3_done(&md, out);
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+#endif
+   return err;
+}
+
+/* SHA-3 4 messages at a time, the sponges side by side */
+static int _mb3_run(int hash, const unsigned char **in, const unsigned long *inlen,
+                    unsigned char **out, unsigned long n)
+{
+   ulong64 st[25][4], t;
+   unsigned char buf[200];
+   const unsigned char *blk;
+   _mb3_lane *lane;
+   unsigned long rate = hash_descriptor[hash].blocksize, next = 0, w;
+   int j, active = 0, err = CRYPT_OK;
+
+   lane = XCALLOC(4, sizeof(_mb3_lane));
+   if (lane == NULL) {
+      return CRYPT_MEM;
+   }
+
+   for (j = 0; j < 4 && next < n; j++, next++, active++) {
+      _mb3_start(&lane[j], st, j, rate, next, in[next], inlen[next]);
+   }
+
+   while (active > 0) {
+      if (next == n && active <= MB_SHA3_SCALAR_LANES) {
+         for (j = 0; j < 4; j++) {
+            if (lane[j].busy) {
+               if ((err = _mb3_finish(hash, &lane[j], st, j, rate, out[lane[j].msg])) != CRYPT_OK) {
+                  goto LBL_ERR;
+               }
+               lane[j].busy = 0;
+            }
+         }
+         break;
+      }
+
+      for (j = 0; j < 4; j++) {
+         if (!lane[j].busy) {
+            continue;
+         }
+         blk = lane[j].full ? lane[j].p : lane[j].tail;
+         for (w = 0; w < rate / 8; w++) {
+            LOAD64L(t, blk + 8 * w);
+            st[w][j] ^= t;
+         }
+      }
+      sha3_avx2_keccakf4(st);
+
+      for (j = 0; j < 4; j++) {
+         if (!lane[j].busy) {
+            continue;
+         }
+         if (lane[j].full) {
+            lane[j].p += rate;
+            lane[j].full--;
+            continue;
+         }
+         for (w = 0; w < 25; w++) {
+            STORE64L(st[w][j], buf + 8 * w);
+         }
+         XMEMCPY(out[lane[j].msg], buf, hash_descriptor[hash].hashsize);
+         if (next < n) {
+            _mb3_start(&lane[j], st, j, rate, next, in[next], inlen[next]);
+            next++;
+         } else {
+            lane[j].busy = 0;
+            --active;
+         }
+      }
+   }
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(lane, 4 * sizeof(_mb3_lane));
+   zeromem(st, sizeof(st));
+   zeromem(buf, sizeof(buf));
+#endif
+   XFREE(lane);
+   return err;
+}
+
+#endif /* LTC_SHA3 */
+
+#endif /* LTC_AVX2 */
+
+/**
+  Hash n independent messages, out[i] = H(in[i])
+  @param hash   The index of the hash you wish to use
+  @param in     The messages
+  @param inlen  Their lengths (octets)
+  @param out    [out] Where to store the digests, hashsize octets each
+  @param n      The number of messages
+  @return CRYPT_OK if successful
+*/
+int hash_memory_batch(int hash, const unsigned char **in, const unsigned long *inlen,
+                      unsigned char **out, unsigned long n)
+{
+   hash_state md;
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(in    != NULL);
+   LTC_ARGCHK(inlen != NULL);
+   LTC_ARGCHK(out   != NULL);
+
+   if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+      return err;
+   }
+
+#ifdef LTC_AVX2
+   if (n > 1 && crypt_cpu_has(LTC_CPU_AVX2)) {
+#ifdef LTC_SHA256
+      /* a single SHA-256 stream on the SHA extensions outruns 8 lanes of AVX2 */
+      if (hash_descriptor[hash].process == sha256_process && hash_descriptor[hash].done == sha256_done &&
+          !crypt_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41)) {
+         static const ulong32 iv[8] = {
+            0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+            0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+         };
+         return _mb_run(hash, sha256_avx2_x8, 8, iv, in, inlen, out, n);
+      }
+#endif
+#ifdef LTC_SHA3
+      /* the SHA-3 variants, not SHAKE which has no fixed digest */
+      if (hash_descriptor[hash].process == sha3_process && hash_descriptor[hash].done == sha3_done) {
+         return _mb3_run(hash, in, inlen, out, n);
+      }
+#endif
+#ifdef LTC_SHA1
+      /* for SHA-1 the 8 lanes win either way */
+      if (hash_descriptor[hash].process == sha1_process) {
+         static const ulong32 iv[5] = {
+            0x67452301UL, 0xefcdab89UL, 0x98badcfeUL, 0x10325476UL, 0xc3d2e1f0UL
+         };
+         return _mb_run(hash, sha1_avx2_x8, 5, iv, in, inlen, out, n);
+      }
+#endif
+   }
+#endif
+
+   for (i = 0; i < n && err == CRYPT_OK; i++) {
+      if ((err = hash_descriptor[hash].init(&md)) != CRYPT_OK) {
+         break;
+      }
+      if ((err = hash_descriptor[hash].process(&md, in[i], inlen[i])) != CRYPT_OK) {
+         break;
+      }
+      err = hash_descriptor[hash].done(&md, out[i]);
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+#endif
+   return err;
+}
+
+#endif /* #ifdef LTC_HASH_HELPERS */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
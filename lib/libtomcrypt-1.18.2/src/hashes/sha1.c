@@ -50,6 +50,13 @@ static int  sha1_compress(hash_state *md, unsigned char *buf)
     ulong32 t;
 #endif
 
+#ifdef LTC_SHA_NI
+    if (crypt_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41)) {
+        sha1_ni_compress(md->sha1.state, buf, 1);
+        return CRYPT_OK;
+    }
+#endif
+
     /* copy the state into 512-bits into W[0..15] */
     for (i = 0; i < 16; i++) {
         LOAD32H(W[i], buf + (4*i));
@@ -0,0 +1,216 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha1_x86.c
+  LTC_SHA1 compression with the x86 SHA extensions, and an AVX2
+  kernel that compresses one block of 8 independent messages at once.
+*/
+
+#ifdef LTC_SHA1
+
+#if defined(LTC_SHA_NI) || defined(LTC_AVX2)
+#include "tomcrypt_x86.h"
+#endif
+
+#ifdef LTC_SHA_NI
+
+/* rounds of one group of 4, f selects the round function */
+#define SHA1_RNDS4(abcd, e, f) \
+   (f == 0 ? _mm_sha1rnds4_epu32(abcd, e, 0) : \
+    f == 1 ? _mm_sha1rnds4_epu32(abcd, e, 1) : \
+    f == 2 ? _mm_sha1rnds4_epu32(abcd, e, 2) : \
+             _mm_sha1rnds4_epu32(abcd, e, 3))
+
+/**
+  Compress blocks with the SHA extensions, the CPU must support them
+  (crypt_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41))
+  @param state   The 5 state words
+  @param buf     The blocks
+  @param blocks  The number of 64 byte blocks
+*/
+__attribute__((target("sha,sse4.1")))
+void sha1_ni_compress(ulong32 *state, const unsigned char *buf, unsigned long blocks)
+{
+   const __m128i bswap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+   __m128i abcd, abcd_save, e[2], e_save, m[4];
+   int i;
+
+   abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)state), 0x1B);
+   e[0] = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+   for (; blocks > 0; blocks--) {
+      abcd_save = abcd;
+      e_save    = e[0];
+
+      /* 20 groups of 4 rounds, m[] holds the last 16 message words:
+       * group g = msg2(msg1(g-4, g-3) ^ (g-2), g-1) */
+      /* fully unrolled so m[] stays in registers */
+      #pragma GCC unroll 20
+      for (i = 0; i < 20; i++) {
+         if (i < 4) {
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(buf + 16 * i)), bswap);
+         }
+         if (i == 0) {
+            e[0] = _mm_add_epi32(e[0], m[0]);
+         } else {
+            e[i & 1] = _mm_sha1nexte_epu32(e[i & 1], m[i & 3]);
+         }
+         e[(i + 1) & 1] = abcd;
+         abcd = SHA1_RNDS4(abcd, e[i & 1], i / 5);
+         if (i >= 3 && i <= 18) {
+            m[(i + 1) & 3] = _mm_sha1msg2_epu32(m[(i + 1) & 3], m[i & 3]);
+         }
+         if (i >= 2 && i <= 17) {
+            m[(i + 2) & 3] = _mm_xor_si128(m[(i + 2) & 3], m[i & 3]);
+         }
+         if (i >= 1 && i <= 16) {
+            m[(i + 3) & 3] = _mm_sha1msg1_epu32(m[(i + 3) & 3], m[i & 3]);
+         }
+      }
+
+      e[0] = _mm_sha1nexte_epu32(e[0], e_save);
+      abcd = _mm_add_epi32(abcd, abcd_save);
+      buf += 64;
+   }
+
+   _mm_storeu_si128((__m128i *)(void *)state, _mm_shuffle_epi32(abcd, 0x1B));
+   state[4] = (ulong32)_mm_extract_epi32(e[0], 3);
+}
+
+#undef SHA1_RNDS4
+
+#endif /* LTC_SHA_NI */
+
+#ifdef LTC_AVX2
+
+#define ROL8(x, n)   _mm256_or_si256(_mm256_slli_epi32((x), (n)), _mm256_srli_epi32((x), 32 - (n)))
+#define ADD8(a, b)   _mm256_add_epi32((a), (b))
+#define XOR8(a, b)   _mm256_xor_si256((a), (b))
+#define AND8(a, b)   _mm256_and_si256((a), (b))
+#define OR8(a, b)    _mm256_or_si256((a), (b))
+
+/* transpose 8 rows of 8 words, r[i] word j becomes r[j] word i */
+__attribute__((target("avx2")))
+static LTC_INLINE void _transpose8(__m256i *r)
+{
+   __m256i t0, t1, t2, t3, t4, t5, t6, t7, u0, u1, u2, u3, u4, u5, u6, u7;
+
+   t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+   t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+   t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+   t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+   t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+   t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+   t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+   t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+   u0 = _mm256_unpacklo_epi64(t0, t2);
+   u1 = _mm256_unpackhi_epi64(t0, t2);
+   u2 = _mm256_unpacklo_epi64(t1, t3);
+   u3 = _mm256_unpackhi_epi64(t1, t3);
+   u4 = _mm256_unpacklo_epi64(t4, t6);
+   u5 = _mm256_unpackhi_epi64(t4, t6);
+   u6 = _mm256_unpacklo_epi64(t5, t7);
+   u7 = _mm256_unpackhi_epi64(t5, t7);
+   r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+   r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+   r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+   r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+   r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+   r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+   r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+   r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/* load words i..i+7 of 8 blocks, one block per lane, as big endian words */
+__attribute__((target("avx2")))
+static LTC_INLINE void _load8(__m256i *w, const unsigned char *const blk[8], int i)
+{
+   const __m256i bswap32 = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                           12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   int j;
+
+   for (j = 0; j < 8; j++) {
+      w[j] = _mm256_loadu_si256((const __m256i *)(const void *)(blk[j] + 4 * i));
+   }
+   _transpose8(w);
+   for (j = 0; j < 8; j++) {
+      w[j] = _mm256_shuffle_epi8(w[j], bswap32);
+   }
+}
+
+/**
+  Compress one block of each of 8 messages with AVX2, the CPU must
+  support it (crypt_cpu_has(LTC_CPU_AVX2))
+  @param state   state[word][lane], the 8 states side by side
+  @param blk     The next block of each message
+*/
+__attribute__((target("avx2")))
+void sha1_avx2_x8(ulong32 state[5][8], const unsigned char *const blk[8])
+{
+   __m256i W[16], S[5], a, b, c, d, e, f, k, t;
+   int i, j;
+
+   _load8(W, blk, 0);
+   _load8(W + 8, blk, 8);
+   for (j = 0; j < 5; j++) {
+      S[j] = _mm256_loadu_si256((const __m256i *)(const void *)state[j]);
+   }
+   a = S[0]; b = S[1]; c = S[2]; d = S[3]; e = S[4];
+
+   for (i = 0; i < 80; i++) {
+      if (i >= 16) {
+         t = XOR8(XOR8(W[(i - 3) & 15], W[(i - 8) & 15]), XOR8(W[(i - 14) & 15], W[i & 15]));
+         W[i & 15] = ROL8(t, 1);
+      }
+      if (i < 20) {
+         f = XOR8(d, AND8(b, XOR8(c, d)));
+         k = _mm256_set1_epi32(0x5a827999);
+      } else if (i < 40) {
+         f = XOR8(XOR8(b, c), d);
+         k = _mm256_set1_epi32(0x6ed9eba1);
+      } else if (i < 60) {
+         f = OR8(AND8(b, c), AND8(d, OR8(b, c)));
+         k = _mm256_set1_epi32((int)0x8f1bbcdcUL);
+      } else {
+         f = XOR8(XOR8(b, c), d);
+         k = _mm256_set1_epi32((int)0xca62c1d6UL);
+      }
+      t = ADD8(ADD8(ROL8(a, 5), f), ADD8(ADD8(e, k), W[i & 15]));
+      e = d;
+      d = c;
+      c = ROL8(b, 30);
+      b = a;
+      a = t;
+   }
+
+   S[0] = ADD8(S[0], a);
+   S[1] = ADD8(S[1], b);
+   S[2] = ADD8(S[2], c);
+   S[3] = ADD8(S[3], d);
+   S[4] = ADD8(S[4], e);
+   for (j = 0; j < 5; j++) {
+      _mm256_storeu_si256((__m256i *)(void *)state[j], S[j]);
+   }
+}
+
+#undef ROL8
+#undef ADD8
+#undef XOR8
+#undef AND8
+#undef OR8
+
+#endif /* LTC_AVX2 */
+
+#endif /* LTC_SHA1 */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
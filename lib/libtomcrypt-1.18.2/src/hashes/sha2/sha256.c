@@ -75,6 +75,13 @@ static int  sha256_compress(hash_state * md, unsigned char *buf)
 #endif
     int i;
 
+#ifdef LTC_SHA_NI
+    if (crypt_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41)) {
+        sha256_ni_compress(md->sha256.state, buf, 1);
+        return CRYPT_OK;
+    }
+#endif
+
     /* copy state into S */
     for (i = 0; i < 8; i++) {
         S[i] = md->sha256.state[i];
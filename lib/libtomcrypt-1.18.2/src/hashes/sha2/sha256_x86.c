@@ -0,0 +1,220 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha256_x86.c
+  LTC_SHA256 compression with the x86 SHA extensions, and an AVX2
+  kernel that compresses one block of 8 independent messages at once.
+*/
+
+#ifdef LTC_SHA256
+
+#if defined(LTC_SHA_NI) || defined(LTC_AVX2)
+#include "tomcrypt_x86.h"
+#endif
+
+#if defined(LTC_SHA_NI) || defined(LTC_AVX2)
+static const ulong32 K[64] = {
+    0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL,
+    0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL,
+    0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL,
+    0xc19bf174UL, 0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL,
+    0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL, 0x983e5152UL,
+    0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL,
+    0x06ca6351UL, 0x14292967UL, 0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL,
+    0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+    0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL,
+    0xd6990624UL, 0xf40e3585UL, 0x106aa070UL, 0x19a4c116UL, 0x1e376c08UL,
+    0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL,
+    0x682e6ff3UL, 0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+    0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+#endif
+
+#ifdef LTC_SHA_NI
+
+/**
+  Compress blocks with the SHA extensions, the CPU must support them
+  (crypt_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41))
+  @param state   The 8 state words
+  @param buf     The blocks
+  @param blocks  The number of 64 byte blocks
+*/
+__attribute__((target("sha,sse4.1")))
+void sha256_ni_compress(ulong32 *state, const unsigned char *buf, unsigned long blocks)
+{
+   const __m128i bswap32 = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+   __m128i s0, s1, t, abef, cdgh, msg, m[4];
+   int i;
+
+   /* the instructions want the state as ABEF and CDGH */
+   t  = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)state), 0xB1);
+   s1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)(state + 4)), 0x1B);
+   s0 = _mm_alignr_epi8(t, s1, 8);
+   s1 = _mm_blend_epi16(s1, t, 0xF0);
+
+   for (; blocks > 0; blocks--) {
+      abef = s0;
+      cdgh = s1;
+
+      /* 16 groups of 4 rounds, m[] holds the last 16 message words */
+      /* fully unrolled so m[] stays in registers */
+      #pragma GCC unroll 16
+      for (i = 0; i < 16; i++) {
+         if (i < 4) {
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(buf + 16 * i)), bswap32);
+         }
+         msg = _mm_add_epi32(m[i & 3], _mm_loadu_si128((const __m128i *)(const void *)(K + 4 * i)));
+         s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+         if (i >= 3 && i <= 14) {
+            t = _mm_alignr_epi8(m[i & 3], m[(i - 1) & 3], 4);
+            m[(i + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(m[(i + 1) & 3], t), m[i & 3]);
+         }
+         s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0E));
+         if (i >= 1 && i <= 12) {
+            m[(i + 3) & 3] = _mm_sha256msg1_epu32(m[(i + 3) & 3], m[i & 3]);
+         }
+      }
+
+      s0 = _mm_add_epi32(s0, abef);
+      s1 = _mm_add_epi32(s1, cdgh);
+      buf += 64;
+   }
+
+   /* back to ABCD and EFGH */
+   t  = _mm_shuffle_epi32(s0, 0x1B);
+   s1 = _mm_shuffle_epi32(s1, 0xB1);
+   s0 = _mm_blend_epi16(t, s1, 0xF0);
+   s1 = _mm_alignr_epi8(s1, t, 8);
+   _mm_storeu_si128((__m128i *)(void *)state, s0);
+   _mm_storeu_si128((__m128i *)(void *)(state + 4), s1);
+}
+
+#endif /* LTC_SHA_NI */
+
+#ifdef LTC_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+#define ROR8(x, n)   _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define ADD8(a, b)   _mm256_add_epi32((a), (b))
+#define XOR8(a, b)   _mm256_xor_si256((a), (b))
+
+/* transpose 8 rows of 8 words, r[i] word j becomes r[j] word i */
+AVX2_TARGET
+static LTC_INLINE void _transpose8(__m256i *r)
+{
+   __m256i t0, t1, t2, t3, t4, t5, t6, t7, u0, u1, u2, u3, u4, u5, u6, u7;
+
+   t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+   t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+   t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+   t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+   t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+   t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+   t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+   t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+   u0 = _mm256_unpacklo_epi64(t0, t2);
+   u1 = _mm256_unpackhi_epi64(t0, t2);
+   u2 = _mm256_unpacklo_epi64(t1, t3);
+   u3 = _mm256_unpackhi_epi64(t1, t3);
+   u4 = _mm256_unpacklo_epi64(t4, t6);
+   u5 = _mm256_unpackhi_epi64(t4, t6);
+   u6 = _mm256_unpacklo_epi64(t5, t7);
+   u7 = _mm256_unpackhi_epi64(t5, t7);
+   r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+   r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+   r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+   r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+   r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+   r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+   r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+   r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/* load words i..i+7 of 8 blocks, one block per lane, as big endian words */
+AVX2_TARGET
+static LTC_INLINE void _load8(__m256i *w, const unsigned char *const blk[8], int i)
+{
+   const __m256i bswap32 = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                           12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   int j;
+
+   for (j = 0; j < 8; j++) {
+      w[j] = _mm256_loadu_si256((const __m256i *)(const void *)(blk[j] + 4 * i));
+   }
+   _transpose8(w);
+   for (j = 0; j < 8; j++) {
+      w[j] = _mm256_shuffle_epi8(w[j], bswap32);
+   }
+}
+
+/**
+  Compress one block of each of 8 messages with AVX2, the CPU must
+  support it (crypt_cpu_has(LTC_CPU_AVX2))
+  @param state   state[word][lane], the 8 states side by side
+  @param blk     The next block of each message
+*/
+AVX2_TARGET
+void sha256_avx2_x8(ulong32 state[8][8], const unsigned char *const blk[8])
+{
+   __m256i W[16], S[8], t0, t1, a, e;
+   int i, j;
+
+   _load8(W, blk, 0);
+   _load8(W + 8, blk, 8);
+   for (j = 0; j < 8; j++) {
+      S[j] = _mm256_loadu_si256((const __m256i *)(const void *)state[j]);
+   }
+
+   for (i = 0; i < 64; i++) {
+      if (i >= 16) {
+         /* W[i] = Gamma1(W[i-2]) + W[i-7] + Gamma0(W[i-15]) + W[i-16], in a ring of 16 */
+         t0 = W[(i - 15) & 15];
+         t1 = W[(i - 2) & 15];
+         t0 = XOR8(XOR8(ROR8(t0, 7), ROR8(t0, 18)), _mm256_srli_epi32(t0, 3));
+         t1 = XOR8(XOR8(ROR8(t1, 17), ROR8(t1, 19)), _mm256_srli_epi32(t1, 10));
+         W[i & 15] = ADD8(ADD8(W[i & 15], t0), ADD8(t1, W[(i - 7) & 15]));
+      }
+
+      a = S[(8 - (i & 7)) & 7];
+      e = S[(12 - (i & 7)) & 7];
+
+      /* t0 = h + Sigma1(e) + Ch(e,f,g) + K[i] + W[i] */
+      t0 = XOR8(XOR8(ROR8(e, 6), ROR8(e, 11)), ROR8(e, 25));
+      t1 = XOR8(S[(14 - (i & 7)) & 7], _mm256_and_si256(e, XOR8(S[(13 - (i & 7)) & 7], S[(14 - (i & 7)) & 7])));
+      t0 = ADD8(ADD8(S[(15 - (i & 7)) & 7], t0), ADD8(t1, ADD8(_mm256_set1_epi32((int)K[i]), W[i & 15])));
+
+      /* t1 = Sigma0(a) + Maj(a,b,c) */
+      t1 = XOR8(XOR8(ROR8(a, 2), ROR8(a, 13)), ROR8(a, 22));
+      t1 = ADD8(t1, _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, S[(9 - (i & 7)) & 7]), S[(10 - (i & 7)) & 7]),
+                                    _mm256_and_si256(a, S[(9 - (i & 7)) & 7])));
+
+      S[(11 - (i & 7)) & 7] = ADD8(S[(11 - (i & 7)) & 7], t0);
+      S[(15 - (i & 7)) & 7] = ADD8(t0, t1);
+   }
+
+   for (j = 0; j < 8; j++) {
+      t0 = _mm256_loadu_si256((const __m256i *)(const void *)state[j]);
+      _mm256_storeu_si256((__m256i *)(void *)state[j], ADD8(t0, S[j]));
+   }
+}
+
+#undef ROR8
+#undef ADD8
+#undef XOR8
+
+#endif /* LTC_AVX2 */
+
+#endif /* LTC_SHA256 */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -91,49 +91,116 @@ static const ulong64 keccakf_rndc[24] = {
    CONST64(0x0000000080000001), CONST64(0x8000000080008008)
 };
 
-static const unsigned keccakf_rotc[24] = {
-   1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
-};
+/*
+ * The permutation below is the "lane complementing" one of the Keccak team's
+ * optimized 64-bit implementation: with lanes 1, 2, 8, 12, 17 and 20 kept
+ * complemented between rounds, chi needs one NOT per row instead of five.
+ * The lanes are complemented on the way in and out, the state in sha3_state
+ * is the plain one. Each round is written out in full, two rounds per loop
+ * trip so the state moves between A and E without any copying.
+ */
 
-static const unsigned keccakf_piln[24] = {
-   10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
-};
+#define KECCAK_THETA(A)                                                         \
+   Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa;                                 \
+   Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se;                                 \
+   Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si;                                 \
+   Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so;                                 \
+   Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su;                                 \
+   Da = Cu ^ ROL64(Ce, 1);                                                     \
+   De = Ca ^ ROL64(Ci, 1);                                                     \
+   Di = Ce ^ ROL64(Co, 1);                                                     \
+   Do = Ci ^ ROL64(Cu, 1);                                                     \
+   Du = Co ^ ROL64(Ca, 1)
+
+/* theta, rho, pi, chi and iota from state A to state E */
+#define KECCAK_ROUND(A, E, rc)                                                  \
+   KECCAK_THETA(A);                                                            \
+                                                                               \
+   Ba = A##ba ^ Da;                                                            \
+   Be = ROL64(A##ge ^ De, 44);                                                 \
+   Bi = ROL64(A##ki ^ Di, 43);                                                 \
+   Bo = ROL64(A##mo ^ Do, 21);                                                 \
+   Bu = ROL64(A##su ^ Du, 14);                                                 \
+   E##ba = Ba ^ (Be | Bi) ^ (rc);                                              \
+   E##be = Be ^ ((~Bi) | Bo);                                                  \
+   E##bi = Bi ^ (Bo & Bu);                                                     \
+   E##bo = Bo ^ (Bu | Ba);                                                     \
+   E##bu = Bu ^ (Ba & Be);                                                     \
+                                                                               \
+   Ba = ROL64(A##bo ^ Do, 28);                                                 \
+   Be = ROL64(A##gu ^ Du, 20);                                                 \
+   Bi = ROL64(A##ka ^ Da, 3);                                                  \
+   Bo = ROL64(A##me ^ De, 45);                                                 \
+   Bu = ROL64(A##si ^ Di, 61);                                                 \
+   E##ga = Ba ^ (Be | Bi);                                                     \
+   E##ge = Be ^ (Bi & Bo);                                                     \
+   E##gi = Bi ^ (Bo | (~Bu));                                                  \
+   E##go = Bo ^ (Bu | Ba);                                                     \
+   E##gu = Bu ^ (Ba & Be);                                                     \
+                                                                               \
+   Ba = ROL64(A##be ^ De, 1);                                                  \
+   Be = ROL64(A##gi ^ Di, 6);                                                  \
+   Bi = ROL64(A##ko ^ Do, 25);                                                 \
+   Bo = ROL64(A##mu ^ Du, 8);                                                  \
+   Bu = ROL64(A##sa ^ Da, 18);                                                 \
+   E##ka = Ba ^ (Be | Bi);                                                     \
+   E##ke = Be ^ (Bi & Bo);                                                     \
+   E##ki = Bi ^ ((~Bo) & Bu);                                                  \
+   E##ko = (~Bo) ^ (Bu | Ba);                                                  \
+   E##ku = Bu ^ (Ba & Be);                                                     \
+                                                                               \
+   Ba = ROL64(A##bu ^ Du, 27);                                                 \
+   Be = ROL64(A##ga ^ Da, 36);                                                 \
+   Bi = ROL64(A##ke ^ De, 10);                                                 \
+   Bo = ROL64(A##mi ^ Di, 15);                                                 \
+   Bu = ROL64(A##so ^ Do, 56);                                                 \
+   E##ma = Ba ^ (Be & Bi);                                                     \
+   E##me = Be ^ (Bi | Bo);                                                     \
+   E##mi = Bi ^ ((~Bo) | Bu);                                                  \
+   E##mo = (~Bo) ^ (Bu & Ba);                                                  \
+   E##mu = Bu ^ (Ba | Be);                                                     \
+                                                                               \
+   Ba = ROL64(A##bi ^ Di, 62);                                                 \
+   Be = ROL64(A##go ^ Do, 55);                                                 \
+   Bi = ROL64(A##ku ^ Du, 39);                                                 \
+   Bo = ROL64(A##ma ^ Da, 41);                                                 \
+   Bu = ROL64(A##se ^ De, 2);                                                  \
+   E##sa = Ba ^ ((~Be) & Bi);                                                  \
+   E##se = (~Be) ^ (Bi | Bo);                                                  \
+   E##si = Bi ^ (Bo & Bu);                                                     \
+   E##so = Bo ^ (Bu | Ba);                                                     \
+   E##su = Bu ^ (Ba & Be)
 
 static void keccakf(ulong64 s[25])
 {
-   int i, j, round;
-   ulong64 t, bc[5];
-
-   for(round = 0; round < SHA3_KECCAK_ROUNDS; round++) {
-      /* Theta */
-      for(i = 0; i < 5; i++)
-         bc[i] = s[i] ^ s[i + 5] ^ s[i + 10] ^ s[i + 15] ^ s[i + 20];
-
-      for(i = 0; i < 5; i++) {
-         t = bc[(i + 4) % 5] ^ ROL64(bc[(i + 1) % 5], 1);
-         for(j = 0; j < 25; j += 5)
-            s[j + i] ^= t;
-      }
-      /* Rho Pi */
-      t = s[1];
-      for(i = 0; i < 24; i++) {
-         j = keccakf_piln[i];
-         bc[0] = s[j];
-         s[j] = ROL64(t, keccakf_rotc[i]);
-         t = bc[0];
-      }
-      /* Chi */
-      for(j = 0; j < 25; j += 5) {
-         for(i = 0; i < 5; i++)
-            bc[i] = s[j + i];
-         for(i = 0; i < 5; i++)
-            s[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
-      }
-      /* Iota */
-      s[0] ^= keccakf_rndc[round];
+   ulong64 Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu, Aka, Ake, Aki, Ako, Aku;
+   ulong64 Ama, Ame, Ami, Amo, Amu, Asa, Ase, Asi, Aso, Asu;
+   ulong64 Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku;
+   ulong64 Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+   ulong64 Ba, Be, Bi, Bo, Bu, Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du;
+   int round;
+
+   Aba =  s[ 0]; Abe = ~s[ 1]; Abi = ~s[ 2]; Abo =  s[ 3]; Abu =  s[ 4];
+   Aga =  s[ 5]; Age =  s[ 6]; Agi =  s[ 7]; Ago = ~s[ 8]; Agu =  s[ 9];
+   Aka =  s[10]; Ake =  s[11]; Aki = ~s[12]; Ako =  s[13]; Aku =  s[14];
+   Ama =  s[15]; Ame =  s[16]; Ami = ~s[17]; Amo =  s[18]; Amu =  s[19];
+   Asa = ~s[20]; Ase =  s[21]; Asi =  s[22]; Aso =  s[23]; Asu =  s[24];
+
+   for (round = 0; round < SHA3_KECCAK_ROUNDS; round += 2) {
+      KECCAK_ROUND(A, E, keccakf_rndc[round]);
+      KECCAK_ROUND(E, A, keccakf_rndc[round + 1]);
    }
+
+   s[ 0] =  Aba; s[ 1] = ~Abe; s[ 2] = ~Abi; s[ 3] =  Abo; s[ 4] =  Abu;
+   s[ 5] =  Aga; s[ 6] =  Age; s[ 7] =  Agi; s[ 8] = ~Ago; s[ 9] =  Agu;
+   s[10] =  Aka; s[11] =  Ake; s[12] = ~Aki; s[13] =  Ako; s[14] =  Aku;
+   s[15] =  Ama; s[16] =  Ame; s[17] = ~Ami; s[18] =  Amo; s[19] =  Amu;
+   s[20] = ~Asa; s[21] =  Ase; s[22] =  Asi; s[23] =  Aso; s[24] =  Asu;
 }
 
+#undef KECCAK_ROUND
+#undef KECCAK_THETA
+
 /* Public Inteface */
 
 int sha3_224_init(hash_state *md)
@@ -0,0 +1,115 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file sha3_x86.c
+  Keccak-f[1600] on 4 independent states at once with AVX2, lane i of
+  the 4 states side by side in one register. Used by hash_memory_batch()
+  to hash several messages with SHA-3 at once.
+*/
+
+#if defined(LTC_SHA3) && defined(LTC_AVX2)
+
+#include "tomcrypt_x86.h"
+
+static const ulong64 keccakf_rndc[24] = {
+   CONST64(0x0000000000000001), CONST64(0x0000000000008082),
+   CONST64(0x800000000000808a), CONST64(0x8000000080008000),
+   CONST64(0x000000000000808b), CONST64(0x0000000080000001),
+   CONST64(0x8000000080008081), CONST64(0x8000000000008009),
+   CONST64(0x000000000000008a), CONST64(0x0000000000000088),
+   CONST64(0x0000000080008009), CONST64(0x000000008000000a),
+   CONST64(0x000000008000808b), CONST64(0x800000000000008b),
+   CONST64(0x8000000000008089), CONST64(0x8000000000008003),
+   CONST64(0x8000000000008002), CONST64(0x8000000000000080),
+   CONST64(0x000000000000800a), CONST64(0x800000008000000a),
+   CONST64(0x8000000080008081), CONST64(0x8000000000008080),
+   CONST64(0x0000000080000001), CONST64(0x8000000080008008)
+};
+
+#define ROL4(x, n) _mm256_or_si256(_mm256_slli_epi64((x), (n)), _mm256_srli_epi64((x), 64 - (n)))
+
+/**
+  Apply Keccak-f[1600] to 4 states with AVX2, the CPU must support it
+  (crypt_cpu_has(LTC_CPU_AVX2))
+  @param s   s[lane][state], the 4 states side by side
+*/
+__attribute__((target("avx2")))
+void sha3_avx2_keccakf4(ulong64 s[25][4])
+{
+   __m256i A[25], B[25], C[5], D[5];
+   int i, round;
+
+   for (i = 0; i < 25; i++) {
+      A[i] = _mm256_loadu_si256((const __m256i *)(const void *)s[i]);
+   }
+
+   for (round = 0; round < 24; round++) {
+      /* Theta */
+      for (i = 0; i < 5; i++) {
+         C[i] = _mm256_xor_si256(_mm256_xor_si256(A[i], A[i + 5]),
+                                 _mm256_xor_si256(_mm256_xor_si256(A[i + 10], A[i + 15]), A[i + 20]));
+      }
+      for (i = 0; i < 5; i++) {
+         D[i] = _mm256_xor_si256(C[(i + 4) % 5], ROL4(C[(i + 1) % 5], 1));
+      }
+
+      /* Rho Pi */
+      B[ 0] = _mm256_xor_si256(A[0], D[0]);
+      B[ 1] = ROL4(_mm256_xor_si256(A[6], D[1]), 44);
+      B[ 2] = ROL4(_mm256_xor_si256(A[12], D[2]), 43);
+      B[ 3] = ROL4(_mm256_xor_si256(A[18], D[3]), 21);
+      B[ 4] = ROL4(_mm256_xor_si256(A[24], D[4]), 14);
+      B[ 5] = ROL4(_mm256_xor_si256(A[3], D[3]), 28);
+      B[ 6] = ROL4(_mm256_xor_si256(A[9], D[4]), 20);
+      B[ 7] = ROL4(_mm256_xor_si256(A[10], D[0]), 3);
+      B[ 8] = ROL4(_mm256_xor_si256(A[16], D[1]), 45);
+      B[ 9] = ROL4(_mm256_xor_si256(A[22], D[2]), 61);
+      B[10] = ROL4(_mm256_xor_si256(A[1], D[1]), 1);
+      B[11] = ROL4(_mm256_xor_si256(A[7], D[2]), 6);
+      B[12] = ROL4(_mm256_xor_si256(A[13], D[3]), 25);
+      B[13] = ROL4(_mm256_xor_si256(A[19], D[4]), 8);
+      B[14] = ROL4(_mm256_xor_si256(A[20], D[0]), 18);
+      B[15] = ROL4(_mm256_xor_si256(A[4], D[4]), 27);
+      B[16] = ROL4(_mm256_xor_si256(A[5], D[0]), 36);
+      B[17] = ROL4(_mm256_xor_si256(A[11], D[1]), 10);
+      B[18] = ROL4(_mm256_xor_si256(A[17], D[2]), 15);
+      B[19] = ROL4(_mm256_xor_si256(A[23], D[3]), 56);
+      B[20] = ROL4(_mm256_xor_si256(A[2], D[2]), 62);
+      B[21] = ROL4(_mm256_xor_si256(A[8], D[3]), 55);
+      B[22] = ROL4(_mm256_xor_si256(A[14], D[4]), 39);
+      B[23] = ROL4(_mm256_xor_si256(A[15], D[0]), 41);
+      B[24] = ROL4(_mm256_xor_si256(A[21], D[1]), 2);
+
+      /* Chi, andnot does the complement for free */
+      for (i = 0; i < 25; i += 5) {
+         A[i + 0] = _mm256_xor_si256(B[i + 0], _mm256_andnot_si256(B[i + 1], B[i + 2]));
+         A[i + 1] = _mm256_xor_si256(B[i + 1], _mm256_andnot_si256(B[i + 2], B[i + 3]));
+         A[i + 2] = _mm256_xor_si256(B[i + 2], _mm256_andnot_si256(B[i + 3], B[i + 4]));
+         A[i + 3] = _mm256_xor_si256(B[i + 3], _mm256_andnot_si256(B[i + 4], B[i + 0]));
+         A[i + 4] = _mm256_xor_si256(B[i + 4], _mm256_andnot_si256(B[i + 0], B[i + 1]));
+      }
+
+      /* Iota */
+      A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x((long long)keccakf_rndc[round]));
+   }
+
+   for (i = 0; i < 25; i++) {
+      _mm256_storeu_si256((__m256i *)(void *)s[i], A[i]);
+   }
+}
+
+#undef ROL4
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -249,6 +249,41 @@ typedef unsigned long ltc_mp_digit;
    #endif
 #endif
 
+/* The x86 instruction set extensions (AES-NI, SHA, AVX2, ...) are compiled in with
+ * __attribute__((target)) and only used when crypt_cpu_has() reports them at runtime */
+#if !defined(LTC_NO_ASM) && !defined(LTC_NO_X86_SIMD) && !defined(_MSC_VER) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+   #define LTC_X86_SIMD
+#endif
+
+#if defined(LTC_X86_SIMD) && !defined(LTC_NO_AES_NI)
+   #define LTC_AES_NI
+#endif
+
+#if defined(LTC_X86_SIMD) && !defined(LTC_NO_SHA_NI)
+   #define LTC_SHA_NI
+#endif
+
+#if defined(LTC_X86_SIMD) && !defined(LTC_NO_AVX2)
+   #define LTC_AVX2
+#endif
+
+#if defined(LTC_X86_SIMD) && !defined(LTC_NO_SSSE3)
+   #define LTC_SSSE3
+#endif
+
+/* Poly1305 with 3 x 44-bit limbs, where the compiler has 64x64->128 bit products */
+#if defined(__SIZEOF_INT128__) && !defined(LTC_NO_POLY1305_64)
+   #define LTC_POLY1305_64
+#endif
+
+/* GHASH with PCLMULQDQ replaces the 64KiB GCM tables, CPUs without it use gcm_gf_mult() */
+#if defined(LTC_AES_NI) && defined(LTC_GCM_MODE) && !defined(LTC_NO_GCM_CLMUL) && !defined(LTC_GCM_TABLES_SSE2)
+   #define LTC_GCM_CLMUL
+   #undef LTC_GCM_TABLES
+#endif
+
 #if !defined(ENDIAN_NEUTRAL) && (defined(ENDIAN_BIG) || defined(ENDIAN_LITTLE)) && !(defined(ENDIAN_32BITWORD) || defined(ENDIAN_64BITWORD))
    #error You must specify a word size as well as endianess in tomcrypt_cfg.h
 #endif
@@ -687,6 +687,23 @@ void rijndael_enc_done(symmetric_key *skey);
 int rijndael_enc_keysize(int *keysize);
 extern const struct ltc_cipher_descriptor rijndael_desc, aes_desc;
 extern const struct ltc_cipher_descriptor rijndael_enc_desc, aes_enc_desc;
+#ifdef LTC_AES_NI
+int aesni_is_supported(void);
+int aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+int aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
+int aesni_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, symmetric_key *skey);
+int aesni_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, symmetric_key *skey);
+int aes_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+int aes_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
+int aes_accel_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, symmetric_key *skey);
+int aes_accel_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, symmetric_key *skey);
+#ifdef LTC_XTS_MODE
+int aesni_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak, symmetric_key *skey1, symmetric_key *skey2);
+int aesni_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak, symmetric_key *skey1, symmetric_key *skey2);
+int aes_accel_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak, symmetric_key *skey1, symmetric_key *skey2);
+int aes_accel_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak, symmetric_key *skey1, symmetric_key *skey2);
+#endif
+#endif
 #endif
 
 #ifdef LTC_XTEA
@@ -938,6 +955,7 @@ void xts_mult_x(unsigned char *I);
 #endif
 
 int find_cipher(const char *name);
+int find_cipher_builtin(const char *name);
 int find_cipher_any(const char *name, int blocklen, int keylen);
 int find_cipher_id(unsigned char ID);
 int register_cipher(const struct ltc_cipher_descriptor *cipher);
@@ -966,6 +984,12 @@ int chacha_crypt(chacha_state *st, const unsigned char *in, unsigned long inlen,
 int chacha_keystream(chacha_state *st, unsigned char *out, unsigned long outlen);
 int chacha_done(chacha_state *st);
 int chacha_test(void);
+#ifdef LTC_SSSE3
+void chacha_ssse3_x4(const ulong32 *input, int rounds, const unsigned char *in, unsigned char *out);
+#endif
+#ifdef LTC_AVX2
+void chacha_avx2_x8(const ulong32 *input, int rounds, const unsigned char *in, unsigned char *out);
+#endif
 
 #endif /* LTC_CHACHA */
 
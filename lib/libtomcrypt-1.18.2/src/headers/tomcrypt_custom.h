@@ -260,6 +260,7 @@
 #define LTC_RIPEMD320
 #define LTC_BLAKE2S
 #define LTC_BLAKE2B
+#define LTC_BLAKE3
 
 #define LTC_HASH_HELPERS
 
@@ -317,6 +318,9 @@
 /* The ChaCha20 stream cipher based PRNG */
 #define LTC_CHACHA20_PRNG
 
+/* Fast key erasure PRNG on ChaCha20, with no lock */
+#define LTC_FKE_PRNG
+
 /* Fortuna PRNG */
 #define LTC_FORTUNA
 
@@ -521,6 +525,10 @@
    #error LTC_CHACHA20_PRNG requires LTC_CHACHA
 #endif
 
+#if defined(LTC_FKE_PRNG) && !defined(LTC_CHACHA)
+   #error LTC_FKE_PRNG requires LTC_CHACHA
+#endif
+
 #if defined(LTC_RC4) && !defined(LTC_RC4_STREAM)
    #error LTC_RC4 requires LTC_RC4_STREAM
 #endif
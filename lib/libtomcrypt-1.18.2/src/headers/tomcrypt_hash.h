@@ -147,6 +147,22 @@ struct blake2b_state {
 };
 #endif
 
+#ifdef LTC_BLAKE3
+/* enough for 2^40 chunks of 1 KiB */
+#define LTC_BLAKE3_MAX_DEPTH 40
+struct blake3_state {
+    ulong32 key[8];
+    ulong32 cv[8];
+    ulong32 stack[LTC_BLAKE3_MAX_DEPTH][8];
+    ulong64 chunk;
+    unsigned char buf[64];
+    unsigned long curlen;
+    unsigned long blocks;
+    unsigned long depth;
+    ulong32 flags;
+};
+#endif
+
 typedef union Hash_state {
     char dummy[1];
 #ifdef LTC_CHC_HASH
@@ -197,6 +213,9 @@ typedef union Hash_state {
 #ifdef LTC_BLAKE2B
     struct blake2b_state blake2b;
 #endif
+#ifdef LTC_BLAKE3
+    struct blake3_state blake3;
+#endif
 
     void *data;
 } hash_state;
@@ -285,6 +304,9 @@ int sha3_shake_init(hash_state *md, int num);
 int sha3_shake_done(hash_state *md, unsigned char *out, unsigned long outlen);
 int sha3_shake_test(void);
 int sha3_shake_memory(int num, const unsigned char *in, unsigned long inlen, unsigned char *out, unsigned long *outlen);
+#ifdef LTC_AVX2
+void sha3_avx2_keccakf4(ulong64 s[25][4]);
+#endif
 #endif
 
 #ifdef LTC_SHA512
@@ -334,6 +356,12 @@ int sha256_process(hash_state * md, const unsigned char *in, unsigned long inlen
 int sha256_done(hash_state * md, unsigned char *hash);
 int sha256_test(void);
 extern const struct ltc_hash_descriptor sha256_desc;
+#ifdef LTC_SHA_NI
+void sha256_ni_compress(ulong32 *state, const unsigned char *buf, unsigned long blocks);
+#endif
+#ifdef LTC_AVX2
+void sha256_avx2_x8(ulong32 state[8][8], const unsigned char *const blk[8]);
+#endif
 
 #ifdef LTC_SHA224
 #ifndef LTC_SHA256
@@ -353,6 +381,12 @@ int sha1_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int sha1_done(hash_state * md, unsigned char *hash);
 int sha1_test(void);
 extern const struct ltc_hash_descriptor sha1_desc;
+#ifdef LTC_SHA_NI
+void sha1_ni_compress(ulong32 *state, const unsigned char *buf, unsigned long blocks);
+#endif
+#ifdef LTC_AVX2
+void sha1_avx2_x8(ulong32 state[5][8], const unsigned char *const blk[8]);
+#endif
 #endif
 
 #ifdef LTC_BLAKE2S
@@ -375,6 +409,9 @@ int blake2s_128_test(void);
 int blake2s_init(hash_state * md, unsigned long outlen, const unsigned char *key, unsigned long keylen);
 int blake2s_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int blake2s_done(hash_state * md, unsigned char *hash);
+#ifdef LTC_SSSE3
+void blake2s_ssse3_compress(struct blake2s_state *st, const unsigned char *buf);
+#endif
 #endif
 
 #ifdef LTC_BLAKE2B
@@ -397,6 +434,27 @@ int blake2b_160_test(void);
 int blake2b_init(hash_state * md, unsigned long outlen, const unsigned char *key, unsigned long keylen);
 int blake2b_process(hash_state * md, const unsigned char *in, unsigned long inlen);
 int blake2b_done(hash_state * md, unsigned char *hash);
+#ifdef LTC_SSSE3
+void blake2b_ssse3_compress(struct blake2b_state *st, const unsigned char *buf);
+#endif
+#ifdef LTC_AVX2
+void blake2b_avx2_compress(struct blake2b_state *st, const unsigned char *buf);
+#endif
+#endif
+
+#ifdef LTC_BLAKE3
+extern const struct ltc_hash_descriptor blake3_desc;
+int blake3_init(hash_state * md);
+int blake3_process(hash_state * md, const unsigned char *in, unsigned long inlen);
+int blake3_done(hash_state * md, unsigned char *hash);
+int blake3_test(void);
+int blake3_chunk(const hash_state *md, ulong64 *chunk);
+int blake3_subtree(const hash_state *md, const unsigned char *in, unsigned long inlen, ulong64 chunk, unsigned char *cv);
+int blake3_push_subtree(hash_state *md, const unsigned char *cv, unsigned long inlen);
+#ifdef LTC_AVX2
+void blake3_avx2_hash8(const unsigned char *const *in, unsigned long blocks, const ulong32 key[8],
+                       ulong64 counter, int inc, ulong32 flags, ulong32 fstart, ulong32 fend, unsigned char *out);
+#endif
 #endif
 
 #ifdef LTC_MD5
@@ -465,6 +523,7 @@ extern const struct ltc_hash_descriptor rmd320_desc;
 
 
 int find_hash(const char *name);
+int find_hash_builtin(const char *name);
 int find_hash_id(unsigned char ID);
 int find_hash_oid(const unsigned long *ID, unsigned long IDlen);
 int find_hash_any(const char *name, int digestlen);
@@ -480,6 +539,8 @@ int hash_memory(int hash,
                       unsigned char *out, unsigned long *outlen);
 int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
                       const unsigned char *in, unsigned long inlen, ...);
+int hash_memory_batch(int hash, const unsigned char **in, const unsigned long *inlen,
+                      unsigned char **out, unsigned long n);
 
 #ifndef LTC_NO_FILE
 int hash_filehandle(int hash, FILE *in, unsigned char *out, unsigned long *outlen);
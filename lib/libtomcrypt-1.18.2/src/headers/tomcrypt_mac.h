@@ -107,8 +107,16 @@ void pmac_shift_xor(pmac_state *pmac);
 
 #ifdef LTC_POLY1305
 typedef struct {
+#ifdef LTC_POLY1305_64
+   ulong64 r[3];
+   ulong64 h[3];
+#else
    ulong32 r[5];
    ulong32 h[5];
+#endif
+#ifdef LTC_AVX2
+   ulong32 rp[4][5];       /* r^1..r^4 in 26-bit limbs, for poly1305_avx2_blocks() */
+#endif
    ulong32 pad[4];
    unsigned long leftover;
    unsigned char buffer[16];
@@ -122,6 +130,9 @@ int poly1305_memory(const unsigned char *key, unsigned long keylen, const unsign
 int poly1305_memory_multi(const unsigned char *key, unsigned long keylen, unsigned char *mac, unsigned long *maclen, const unsigned char *in,  unsigned long inlen, ...);
 int poly1305_file(const char *fname, const unsigned char *key, unsigned long keylen, unsigned char *mac, unsigned long *maclen);
 int poly1305_test(void);
+#ifdef LTC_AVX2
+void poly1305_avx2_blocks(ulong32 h[5], const ulong32 rp[4][5], const unsigned char *in, unsigned long blocks);
+#endif
 #endif /* LTC_POLY1305 */
 
 #ifdef LTC_BLAKE2SMAC
@@ -405,10 +416,22 @@ __attribute__ ((aligned (16)))
 #endif
 ;
 #endif
+
+#ifdef LTC_GCM_CLMUL
+   unsigned char       HP[8][16];    /* H^1..H^8 for PCLMULQDQ */
+   int                 clmul;        /* use PCLMULQDQ? */
+#endif
 } gcm_state;
 
 void gcm_mult_h(gcm_state *gcm, unsigned char *I);
 
+#ifdef LTC_GCM_CLMUL
+int gcm_clmul_is_supported(void);
+void gcm_clmul_init(gcm_state *gcm);
+void gcm_clmul_mult_h(gcm_state *gcm, unsigned char *I);
+void gcm_clmul_ghash(gcm_state *gcm, const unsigned char *in, unsigned long blocks);
+#endif
+
 int gcm_init(gcm_state *gcm, int cipher,
              const unsigned char *key, int keylen);
 
@@ -65,6 +65,40 @@ extern const char *crypt_build_settings;
 /* ---- HMM ---- */
 int crypt_fsa(void *mp, ...);
 
+/* ---- CPU features ---- */
+#define LTC_CPU_SSSE3    0x0001UL
+#define LTC_CPU_SSE41    0x0002UL
+#define LTC_CPU_AESNI    0x0004UL
+#define LTC_CPU_PCLMUL   0x0008UL
+#define LTC_CPU_AVX      0x0010UL
+#define LTC_CPU_AVX2     0x0020UL
+#define LTC_CPU_SHA      0x0040UL
+#define LTC_CPU_BMI2     0x0080UL
+#define LTC_CPU_AVX512F  0x0100UL
+
+int crypt_cpu_has(ulong32 features);
+
+/* ---- name index of the descriptor tables ---- */
+#ifndef LTC_NAME_SLOTS
+   #define LTC_NAME_SLOTS 256
+#endif
+
+typedef struct {
+   ulong32 seq;                  /* odd while the index is current */
+   ulong32 seed;
+   struct {
+      const char *name;
+      ulong32 hash;
+      int idx;
+   } slot[LTC_NAME_SLOTS];
+} ltc_name_index;
+
+extern ltc_name_index ltc_cipher_index, ltc_hash_index, ltc_prng_index;
+
+void crypt_name_index_stale(ltc_name_index *ni);
+int crypt_name_index_lookup(const ltc_name_index *ni, const char *name, int *idx);
+int crypt_name_index_find(ltc_name_index *ni, const void *table, unsigned long stride, const char *name);
+
 /* ---- Dynamic language support ---- */
 int crypt_get_constant(const char* namein, int *valueout);
 int crypt_list_all_constants(char *names_list, unsigned int *names_list_size);
@@ -30,6 +30,18 @@ struct chacha20_prng {
 };
 #endif
 
+#ifdef LTC_FKE_PRNG
+/* keystream made per batch, the first 32 bytes of which are the next key */
+#define LTC_FKE_BUFSIZE 512
+
+struct fke_prng {
+    unsigned char key[32];                 /* key of the next batch */
+    unsigned char buf[LTC_FKE_BUFSIZE];    /* the batch, wiped as it is read */
+    unsigned long avail;                   /* bytes left at the end of buf */
+    unsigned long idx;                     /* entropy counter */
+};
+#endif
+
 #ifdef LTC_FORTUNA
 struct fortuna_prng {
     hash_state pool[LTC_FORTUNA_POOLS];     /* the  pools */
@@ -67,6 +79,9 @@ typedef struct {
 #ifdef LTC_CHACHA20_PRNG
       struct chacha20_prng  chacha;
 #endif
+#ifdef LTC_FKE_PRNG
+      struct fke_prng       fke;
+#endif
 #ifdef LTC_FORTUNA
       struct fortuna_prng   fortuna;
 #endif
@@ -181,6 +196,19 @@ int  chacha20_prng_test(void);
 extern const struct ltc_prng_descriptor chacha20_prng_desc;
 #endif
 
+#ifdef LTC_FKE_PRNG
+int fke_start(prng_state *prng);
+int fke_add_entropy(const unsigned char *in, unsigned long inlen, prng_state *prng);
+int fke_ready(prng_state *prng);
+unsigned long fke_read(unsigned char *out, unsigned long outlen, prng_state *prng);
+int fke_done(prng_state *prng);
+int  fke_export(unsigned char *out, unsigned long *outlen, prng_state *prng);
+int  fke_import(const unsigned char *in, unsigned long inlen, prng_state *prng);
+int  fke_test(void);
+unsigned long fke_thread_read(unsigned char *out, unsigned long outlen);
+extern const struct ltc_prng_descriptor fke_desc;
+#endif
+
 #ifdef LTC_SPRNG
 int sprng_start(prng_state *prng);
 int sprng_add_entropy(const unsigned char *in, unsigned long inlen, prng_state *prng);
@@ -206,6 +234,7 @@ extern const struct ltc_prng_descriptor sober128_desc;
 #endif
 
 int find_prng(const char *name);
+int find_prng_builtin(const char *name);
 int register_prng(const struct ltc_prng_descriptor *prng);
 int unregister_prng(const struct ltc_prng_descriptor *prng);
 int register_all_prngs(void);
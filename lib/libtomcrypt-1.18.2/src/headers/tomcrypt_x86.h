@@ -0,0 +1,22 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/* Private header of the *_x86.c kernels, not installed with HEADERS.
+ * Pulls in <immintrin.h>, whose avx512fintrin.h (GCC 12) trips the
+ * -Wdeclaration-after-statement of makefile_include.mk.
+ */
+#ifndef TOMCRYPT_X86_H_
+#define TOMCRYPT_X86_H_
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+#endif
@@ -16,6 +16,100 @@
 
 #ifdef LTC_POLY1305
 
+#ifdef LTC_POLY1305_64
+
+/* 3 limbs of 44, 44 and 42 bits, as in poly1305-donna-64 */
+__extension__ typedef unsigned __int128 _poly1305_u128;
+
+#define M44 CONST64(0xfffffffffff)
+#define M42 CONST64(0x3ffffffffff)
+
+/* internal only */
+static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigned long inlen)
+{
+   const ulong64 hibit = (st->final) ? 0 : (CONST64(1) << 40); /* 1 << 128 */
+   ulong64 r0,r1,r2;
+   ulong64 s1,s2;
+   ulong64 h0,h1,h2;
+   ulong64 t0,t1;
+   ulong64 c;
+   _poly1305_u128 d0,d1,d2,d;
+
+   r0 = st->r[0];
+   r1 = st->r[1];
+   r2 = st->r[2];
+
+   s1 = r1 * (5 << 2);
+   s2 = r2 * (5 << 2);
+
+   h0 = st->h[0];
+   h1 = st->h[1];
+   h2 = st->h[2];
+
+   while (inlen >= 16) {
+      /* h += in[i] */
+      LOAD64L(t0, in+ 0);
+      LOAD64L(t1, in+ 8);
+      h0 += (t0                    ) & M44;
+      h1 += ((t0 >> 44) | (t1 << 20)) & M44;
+      h2 += (((t1 >> 24)           ) & M42) | hibit;
+
+      /* h *= r */
+      d0 = (_poly1305_u128)h0 * r0; d = (_poly1305_u128)h1 * s2; d0 += d; d = (_poly1305_u128)h2 * s1; d0 += d;
+      d1 = (_poly1305_u128)h0 * r1; d = (_poly1305_u128)h1 * r0; d1 += d; d = (_poly1305_u128)h2 * s2; d1 += d;
+      d2 = (_poly1305_u128)h0 * r2; d = (_poly1305_u128)h1 * r1; d2 += d; d = (_poly1305_u128)h2 * r0; d2 += d;
+
+      /* (partial) h %= p */
+                                c = (ulong64)(d0 >> 44); h0 = (ulong64)d0 & M44;
+      d1 += c;                  c = (ulong64)(d1 >> 44); h1 = (ulong64)d1 & M44;
+      d2 += c;                  c = (ulong64)(d2 >> 42); h2 = (ulong64)d2 & M42;
+      h0 += c * 5;              c =          (h0 >> 44); h0 =          h0 & M44;
+      h1 += c;
+
+      in += 16;
+      inlen -= 16;
+   }
+
+   st->h[0] = h0;
+   st->h[1] = h1;
+   st->h[2] = h2;
+}
+
+#ifdef LTC_AVX2
+/* h as 5 limbs of 26 bits, for the AVX2 code */
+static void _poly1305_get26(const poly1305_state *st, ulong32 g[5])
+{
+   ulong64 h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], c;
+
+                c = h0 >> 44; h0 &= M44;
+   h1 +=     c; c = h1 >> 44; h1 &= M44;
+   h2 +=     c; c = h2 >> 42; h2 &= M42;
+   h0 += c * 5; c = h0 >> 44; h0 &= M44;
+   h1 +=     c; c = h1 >> 44; h1 &= M44;
+   h2 +=     c;
+
+   g[0] = (ulong32)(h0 & 0x3ffffff);
+   g[1] = (ulong32)(((h0 >> 26) | (h1 << 18)) & 0x3ffffff);
+   g[2] = (ulong32)((h1 >> 8) & 0x3ffffff);
+   g[3] = (ulong32)(((h1 >> 34) | (h2 << 10)) & 0x3ffffff);
+   g[4] = (ulong32)(h2 >> 16);
+}
+
+static void _poly1305_set26(poly1305_state *st, const ulong32 g[5])
+{
+   ulong64 t;
+
+   t = (ulong64)g[0] + ((ulong64)g[1] << 26);
+   st->h[0] = t & M44; t >>= 44;
+   t += ((ulong64)g[2] << 8) + ((ulong64)g[3] << 34);
+   st->h[1] = t & M44; t >>= 44;
+   t += (ulong64)g[4] << 16;
+   st->h[2] = t;
+}
+#endif
+
+#else /* LTC_POLY1305_64 */
+
 /* internal only */
 static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigned long inlen)
 {
@@ -79,6 +173,69 @@ static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigne
    st->h[4] = h4;
 }
 
+#ifdef LTC_AVX2
+static void _poly1305_get26(const poly1305_state *st, ulong32 g[5])
+{
+   XMEMCPY(g, st->h, 5 * sizeof(ulong32));
+}
+
+static void _poly1305_set26(poly1305_state *st, const ulong32 g[5])
+{
+   XMEMCPY(st->h, g, 5 * sizeof(ulong32));
+}
+#endif
+
+#endif /* LTC_POLY1305_64 */
+
+#ifdef LTC_AVX2
+
+/* below this many bytes the AVX2 code does not pay for its set-up */
+#define POLY1305_AVX2_MIN 256
+
+/* out = a * b mod p, 26-bit limbs, partially reduced */
+static void _poly1305_mul26(ulong32 out[5], const ulong32 a[5], const ulong32 b[5])
+{
+   ulong32 s1 = b[1] * 5, s2 = b[2] * 5, s3 = b[3] * 5, s4 = b[4] * 5, c;
+   ulong64 d0, d1, d2, d3, d4;
+
+   d0 = ((ulong64)a[0] * b[0]) + ((ulong64)a[1] * s4) + ((ulong64)a[2] * s3) + ((ulong64)a[3] * s2) + ((ulong64)a[4] * s1);
+   d1 = ((ulong64)a[0] * b[1]) + ((ulong64)a[1] * b[0]) + ((ulong64)a[2] * s4) + ((ulong64)a[3] * s3) + ((ulong64)a[4] * s2);
+   d2 = ((ulong64)a[0] * b[2]) + ((ulong64)a[1] * b[1]) + ((ulong64)a[2] * b[0]) + ((ulong64)a[3] * s4) + ((ulong64)a[4] * s3);
+   d3 = ((ulong64)a[0] * b[3]) + ((ulong64)a[1] * b[2]) + ((ulong64)a[2] * b[1]) + ((ulong64)a[3] * b[0]) + ((ulong64)a[4] * s4);
+   d4 = ((ulong64)a[0] * b[4]) + ((ulong64)a[1] * b[3]) + ((ulong64)a[2] * b[2]) + ((ulong64)a[3] * b[1]) + ((ulong64)a[4] * b[0]);
+
+                 c = (ulong32)(d0 >> 26); out[0] = (ulong32)d0 & 0x3ffffff;
+   d1 += c;      c = (ulong32)(d1 >> 26); out[1] = (ulong32)d1 & 0x3ffffff;
+   d2 += c;      c = (ulong32)(d2 >> 26); out[2] = (ulong32)d2 & 0x3ffffff;
+   d3 += c;      c = (ulong32)(d3 >> 26); out[3] = (ulong32)d3 & 0x3ffffff;
+   d4 += c;      c = (ulong32)(d4 >> 26); out[4] = (ulong32)d4 & 0x3ffffff;
+   out[0] += c * 5; c = out[0] >> 26; out[0] &= 0x3ffffff;
+   out[1] += c;
+}
+
+#endif /* LTC_AVX2 */
+
+/* full blocks, 4 at a time with AVX2 when there are enough of them */
+static void _poly1305_blocks(poly1305_state *st, const unsigned char *in, unsigned long inlen)
+{
+#ifdef LTC_AVX2
+   if (inlen >= POLY1305_AVX2_MIN && crypt_cpu_has(LTC_CPU_AVX2)) {
+      ulong32 h[5];
+      unsigned long n = inlen / 64;
+
+      _poly1305_get26(st, h);
+      poly1305_avx2_blocks(h, (const ulong32 (*)[5])st->rp, in, n * 4);
+      _poly1305_set26(st, h);
+      in += n * 64;
+      inlen -= n * 64;
+#ifdef LTC_CLEAN_STACK
+      zeromem(h, sizeof(h));
+#endif
+   }
+#endif
+   if (inlen) _poly1305_block(st, in, inlen);
+}
+
 /**
    Initialize an POLY1305 context.
    @param st       The POLY1305 state
@@ -88,10 +245,27 @@ static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigne
 */
 int poly1305_init(poly1305_state *st, const unsigned char *key, unsigned long keylen)
 {
+#ifdef LTC_POLY1305_64
+   ulong64 t0, t1;
+#endif
+
    LTC_ARGCHK(st  != NULL);
    LTC_ARGCHK(key != NULL);
    LTC_ARGCHK(keylen == 32);
 
+#ifdef LTC_POLY1305_64
+   /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
+   LOAD64L(t0, key + 0);
+   LOAD64L(t1, key + 8);
+   st->r[0] = ( t0                    ) & CONST64(0xffc0fffffff);
+   st->r[1] = ((t0 >> 44) | (t1 << 20)) & CONST64(0xfffffc0ffff);
+   st->r[2] = ((t1 >> 24)             ) & CONST64(0x00ffffffc0f);
+
+   /* h = 0 */
+   st->h[0] = 0;
+   st->h[1] = 0;
+   st->h[2] = 0;
+#else
    /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
    LOAD32L(st->r[0], key +  0); st->r[0] = (st->r[0]     ) & 0x3ffffff;
    LOAD32L(st->r[1], key +  3); st->r[1] = (st->r[1] >> 2) & 0x3ffff03;
@@ -105,6 +279,19 @@ int poly1305_init(poly1305_state *st, const unsigned char *key, unsigned long ke
    st->h[2] = 0;
    st->h[3] = 0;
    st->h[4] = 0;
+#endif
+
+#ifdef LTC_AVX2
+   /* r, r^2, r^3 and r^4 for the 4-way code */
+   LOAD32L(st->rp[0][0], key +  0); st->rp[0][0] = (st->rp[0][0]     ) & 0x3ffffff;
+   LOAD32L(st->rp[0][1], key +  3); st->rp[0][1] = (st->rp[0][1] >> 2) & 0x3ffff03;
+   LOAD32L(st->rp[0][2], key +  6); st->rp[0][2] = (st->rp[0][2] >> 4) & 0x3ffc0ff;
+   LOAD32L(st->rp[0][3], key +  9); st->rp[0][3] = (st->rp[0][3] >> 6) & 0x3f03fff;
+   LOAD32L(st->rp[0][4], key + 12); st->rp[0][4] = (st->rp[0][4] >> 8) & 0x00fffff;
+   _poly1305_mul26(st->rp[1], st->rp[0], st->rp[0]);
+   _poly1305_mul26(st->rp[2], st->rp[1], st->rp[0]);
+   _poly1305_mul26(st->rp[3], st->rp[2], st->rp[0]);
+#endif
 
    /* save pad for later */
    LOAD32L(st->pad[0], key + 16);
@@ -148,7 +335,7 @@ int poly1305_process(poly1305_state *st, const unsigned char *in, unsigned long
    /* process full blocks */
    if (inlen >= 16) {
       unsigned long want = (inlen & ~(16 - 1));
-      _poly1305_block(st, in, want);
+      _poly1305_blocks(st, in, want);
       in += want;
       inlen -= want;
    }
@@ -170,10 +357,16 @@ int poly1305_process(poly1305_state *st, const unsigned char *in, unsigned long
 */
 int poly1305_done(poly1305_state *st, unsigned char *mac, unsigned long *maclen)
 {
+#ifdef LTC_POLY1305_64
+   ulong64 h0,h1,h2,c;
+   ulong64 g0,g1,g2;
+   ulong64 t0,t1;
+#else
    ulong32 h0,h1,h2,h3,h4,c;
    ulong32 g0,g1,g2,g3,g4;
    ulong64 f;
    ulong32 mask;
+#endif
 
    LTC_ARGCHK(st     != NULL);
    LTC_ARGCHK(mac    != NULL);
@@ -189,6 +382,51 @@ int poly1305_done(poly1305_state *st, unsigned char *mac, unsigned long *maclen)
       _poly1305_block(st, st->buffer, 16);
    }
 
+#ifdef LTC_POLY1305_64
+   /* fully carry h */
+   h0 = st->h[0];
+   h1 = st->h[1];
+   h2 = st->h[2];
+
+                c = (h1 >> 44); h1 &= M44;
+   h2 +=     c; c = (h2 >> 42); h2 &= M42;
+   h0 += c * 5; c = (h0 >> 44); h0 &= M44;
+   h1 +=     c; c = (h1 >> 44); h1 &= M44;
+   h2 +=     c; c = (h2 >> 42); h2 &= M42;
+   h0 += c * 5; c = (h0 >> 44); h0 &= M44;
+   h1 +=     c;
+
+   /* compute h + -p */
+   g0 = h0 + 5; c = (g0 >> 44); g0 &= M44;
+   g1 = h1 + c; c = (g1 >> 44); g1 &= M44;
+   g2 = h2 + c - (CONST64(1) << 42);
+
+   /* select h if h < p, or h + -p if h >= p */
+   c = (g2 >> 63) - 1;
+   g0 &= c;
+   g1 &= c;
+   g2 &= c;
+   c = ~c;
+   h0 = (h0 & c) | g0;
+   h1 = (h1 & c) | g1;
+   h2 = (h2 & c) | g2;
+
+   /* h = (h + pad) */
+   t0 = ((ulong64)st->pad[1] << 32) | st->pad[0];
+   t1 = ((ulong64)st->pad[3] << 32) | st->pad[2];
+
+   h0 += (( t0                    ) & M44)    ; c = (h0 >> 44); h0 &= M44;
+   h1 += (((t0 >> 44) | (t1 << 20)) & M44) + c; c = (h1 >> 44); h1 &= M44;
+   h2 += (((t1 >> 24)             ) & M42) + c;                 h2 &= M42;
+
+   /* mac = h % (2^128) */
+   h0 = ((h0      ) | (h1 << 44));
+   h1 = ((h1 >> 20) | (h2 << 24));
+
+   STORE64L(h0, mac + 0);
+   STORE64L(h1, mac + 8);
+
+#else
    /* fully carry h */
    h0 = st->h[0];
    h1 = st->h[1];
@@ -241,17 +479,14 @@ int poly1305_done(poly1305_state *st, unsigned char *mac, unsigned long *maclen)
    STORE32L(h2, mac +  8);
    STORE32L(h3, mac + 12);
 
+#endif
+
    /* zero out the state */
-   st->h[0] = 0;
-   st->h[1] = 0;
-   st->h[2] = 0;
-   st->h[3] = 0;
-   st->h[4] = 0;
-   st->r[0] = 0;
-   st->r[1] = 0;
-   st->r[2] = 0;
-   st->r[3] = 0;
-   st->r[4] = 0;
+   zeromem(st->h, sizeof(st->h));
+   zeromem(st->r, sizeof(st->r));
+#ifdef LTC_AVX2
+   zeromem(st->rp, sizeof(st->rp));
+#endif
    st->pad[0] = 0;
    st->pad[1] = 0;
    st->pad[2] = 0;
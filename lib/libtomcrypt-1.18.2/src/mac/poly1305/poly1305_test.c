@@ -25,8 +25,11 @@ int poly1305_test(void)
    unsigned char k[]   = { 0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8, 0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b };
    unsigned char tag[] = { 0xA8, 0x06, 0x1D, 0xC1, 0x30, 0x51, 0x36, 0xC6, 0xC2, 0x2B, 0x8B, 0xAF, 0x0C, 0x01, 0x27, 0xA9 };
    char m[] = "Cryptographic Forum Research Group";
-   unsigned long len = 16, mlen = strlen(m);
-   unsigned char out[1000];
+   /* 1000 bytes, long enough for the 4 blocks at a time code */
+   unsigned char tag3[] = { 0x1A, 0x04, 0x26, 0xCE, 0x6E, 0xC6, 0xE1, 0x32, 0x3F, 0xFC, 0xCA, 0x66, 0x04, 0x4D, 0x68, 0x15 };
+   unsigned char tag4[] = { 0xDE, 0x94, 0x06, 0xB1, 0x0E, 0x70, 0x23, 0xBC, 0xD6, 0x92, 0xFF, 0x68, 0x7F, 0x4C, 0xBC, 0x7F };
+   unsigned long len = 16, mlen = strlen(m), i;
+   unsigned char out[1000], m2[1000], k2[32];
    poly1305_state st;
    int err;
 
@@ -45,6 +48,25 @@ int poly1305_test(void)
    if ((err = poly1305_process(&st, (unsigned char*)m, mlen)) != CRYPT_OK)           return err;
    if ((err = poly1305_done(&st, out, &len)) != CRYPT_OK)                            return err;
    if (compare_testvector(out, len, tag, sizeof(tag), "POLY1305-TV2", 1) != 0)       return CRYPT_FAIL_TESTVECTOR;
+   /* long message, in one go and in odd pieces */
+   for (i = 0; i < sizeof(m2); i++) m2[i] = (unsigned char)(i * 7 + 3);
+   if ((err = poly1305_init(&st, k, 32)) != CRYPT_OK)                                return err;
+   if ((err = poly1305_process(&st, m2, sizeof(m2))) != CRYPT_OK)                    return err;
+   if ((err = poly1305_done(&st, out, &len)) != CRYPT_OK)                            return err;
+   if (compare_testvector(out, len, tag3, sizeof(tag3), "POLY1305-TV3", 1) != 0)     return CRYPT_FAIL_TESTVECTOR;
+   if ((err = poly1305_init(&st, k, 32)) != CRYPT_OK)                                return err;
+   for (i = 0; i < sizeof(m2); i += 333) {
+      if ((err = poly1305_process(&st, m2 + i, MIN(333, sizeof(m2) - i))) != CRYPT_OK) return err;
+   }
+   if ((err = poly1305_done(&st, out, &len)) != CRYPT_OK)                            return err;
+   if (compare_testvector(out, len, tag3, sizeof(tag3), "POLY1305-TV3", 2) != 0)     return CRYPT_FAIL_TESTVECTOR;
+   /* all ones key and message, the limbs at their largest */
+   XMEMSET(k2, 0xff, sizeof(k2));
+   XMEMSET(m2, 0xff, sizeof(m2));
+   if ((err = poly1305_init(&st, k2, 32)) != CRYPT_OK)                               return err;
+   if ((err = poly1305_process(&st, m2, sizeof(m2))) != CRYPT_OK)                    return err;
+   if ((err = poly1305_done(&st, out, &len)) != CRYPT_OK)                            return err;
+   if (compare_testvector(out, len, tag4, sizeof(tag4), "POLY1305-TV4", 1) != 0)     return CRYPT_FAIL_TESTVECTOR;
    return CRYPT_OK;
 #endif
 }
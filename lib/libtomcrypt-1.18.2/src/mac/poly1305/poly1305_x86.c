@@ -0,0 +1,154 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file poly1305_x86.c
+  Poly1305 on 4 blocks at once with AVX2. Block 4i+j goes to lane j,
+  each lane is multiplied by r^4 per step and the lanes by r^4, r^3,
+  r^2 and r at the end, so the sum is that of the block at a time
+  Horner evaluation. Limbs are 26 bits in 64-bit lanes, as
+  _mm256_mul_epu32() gives 32x32->64 bit products.
+*/
+
+#if defined(LTC_POLY1305) && defined(LTC_AVX2)
+
+#include "tomcrypt_x86.h"
+
+/* d = a * (r, s = 5r), partially reduced back into a */
+#define MUL5(a, r, s)                                                                                     \
+   do {                                                                                                   \
+      d0 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[0]), _mm256_mul_epu32(a[1], s[4])),  \
+           _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[2], s[3]), _mm256_mul_epu32(a[3], s[2])),  \
+                            _mm256_mul_epu32(a[4], s[1])));                                                \
+      d1 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[1]), _mm256_mul_epu32(a[1], r[0])),  \
+           _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[2], s[4]), _mm256_mul_epu32(a[3], s[3])),  \
+                            _mm256_mul_epu32(a[4], s[2])));                                                \
+      d2 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[2]), _mm256_mul_epu32(a[1], r[1])),  \
+           _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[2], r[0]), _mm256_mul_epu32(a[3], s[4])),  \
+                            _mm256_mul_epu32(a[4], s[3])));                                                \
+      d3 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[3]), _mm256_mul_epu32(a[1], r[2])),  \
+           _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[2], r[1]), _mm256_mul_epu32(a[3], r[0])),  \
+                            _mm256_mul_epu32(a[4], s[4])));                                                \
+      d4 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[0], r[4]), _mm256_mul_epu32(a[1], r[3])),  \
+           _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a[2], r[2]), _mm256_mul_epu32(a[3], r[1])),  \
+                            _mm256_mul_epu32(a[4], r[0])));                                                \
+   } while (0)
+
+/* 4 blocks, lane j holding block j, as 26-bit limbs with the 2^128 bit set */
+__attribute__((target("avx2")))
+static LTC_INLINE void _load4(const unsigned char *in, __m256i *m)
+{
+   const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+   __m256i a, b, t0, t1;
+
+   a = _mm256_loadu_si256((const __m256i *)(const void *)(in +  0));
+   b = _mm256_loadu_si256((const __m256i *)(const void *)(in + 32));
+   t0 = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+   t1 = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xD8);
+
+   m[0] = _mm256_and_si256(t0, mask);
+   m[1] = _mm256_and_si256(_mm256_srli_epi64(t0, 26), mask);
+   m[2] = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(t0, 52), _mm256_slli_epi64(t1, 12)), mask);
+   m[3] = _mm256_and_si256(_mm256_srli_epi64(t1, 14), mask);
+   m[4] = _mm256_or_si256(_mm256_srli_epi64(t1, 40), _mm256_set1_epi64x(1 << 24));
+}
+
+/**
+  Absorb full (not final) blocks into h with AVX2, the CPU must support
+  it (crypt_cpu_has(LTC_CPU_AVX2))
+  @param h       The accumulator as 5 limbs of 26 bits, updated
+  @param rp      r, r^2, r^3 and r^4 as 5 limbs of 26 bits each
+  @param in      The blocks
+  @param blocks  The number of 16 byte blocks, a non-zero multiple of 4
+*/
+__attribute__((target("avx2")))
+void poly1305_avx2_blocks(ulong32 h[5], const ulong32 rp[4][5], const unsigned char *in, unsigned long blocks)
+{
+   const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+   const __m256i five = _mm256_set1_epi64x(5);
+   __m256i a[5], m[5], r[5], s[5], d0, d1, d2, d3, d4, c;
+   ulong64 t[5][4], e[5], f;
+   int i;
+
+   /* lane 0 starts with h, every lane with its first block */
+   _load4(in, a);
+   for (i = 0; i < 5; i++) {
+      a[i] = _mm256_add_epi64(a[i], _mm256_setr_epi64x((long long)h[i], 0, 0, 0));
+   }
+   in += 64;
+   blocks -= 4;
+
+   for (i = 0; i < 5; i++) {
+      r[i] = _mm256_set1_epi64x((long long)rp[3][i]);
+      s[i] = _mm256_mul_epu32(r[i], five);
+   }
+
+   /* a = a * r^4 + next 4 blocks */
+   while (blocks >= 4) {
+      MUL5(a, r, s);
+      _load4(in, m);
+
+      c = _mm256_srli_epi64(d0, 26); a[0] = _mm256_and_si256(d0, mask); d1 = _mm256_add_epi64(d1, c);
+      c = _mm256_srli_epi64(d1, 26); a[1] = _mm256_and_si256(d1, mask); d2 = _mm256_add_epi64(d2, c);
+      c = _mm256_srli_epi64(d2, 26); a[2] = _mm256_and_si256(d2, mask); d3 = _mm256_add_epi64(d3, c);
+      c = _mm256_srli_epi64(d3, 26); a[3] = _mm256_and_si256(d3, mask); d4 = _mm256_add_epi64(d4, c);
+      c = _mm256_srli_epi64(d4, 26); a[4] = _mm256_and_si256(d4, mask);
+      a[0] = _mm256_add_epi64(a[0], _mm256_mul_epu32(c, five));
+      c = _mm256_srli_epi64(a[0], 26); a[0] = _mm256_and_si256(a[0], mask);
+      a[1] = _mm256_add_epi64(a[1], c);
+
+      for (i = 0; i < 5; i++) {
+         a[i] = _mm256_add_epi64(a[i], m[i]);
+      }
+      in += 64;
+      blocks -= 4;
+   }
+
+   /* lanes times r^4, r^3, r^2 and r, then summed */
+   for (i = 0; i < 5; i++) {
+      r[i] = _mm256_setr_epi64x((long long)rp[3][i], (long long)rp[2][i], (long long)rp[1][i], (long long)rp[0][i]);
+      s[i] = _mm256_mul_epu32(r[i], five);
+   }
+   MUL5(a, r, s);
+   _mm256_storeu_si256((__m256i *)(void *)t[0], d0);
+   _mm256_storeu_si256((__m256i *)(void *)t[1], d1);
+   _mm256_storeu_si256((__m256i *)(void *)t[2], d2);
+   _mm256_storeu_si256((__m256i *)(void *)t[3], d3);
+   _mm256_storeu_si256((__m256i *)(void *)t[4], d4);
+   for (i = 0; i < 5; i++) {
+      e[i] = t[i][0] + t[i][1] + t[i][2] + t[i][3];
+   }
+
+   /* (partial) h %= p */
+               f = e[0] >> 26; e[0] &= 0x3ffffff;
+   e[1] +=     f; f = e[1] >> 26; e[1] &= 0x3ffffff;
+   e[2] +=     f; f = e[2] >> 26; e[2] &= 0x3ffffff;
+   e[3] +=     f; f = e[3] >> 26; e[3] &= 0x3ffffff;
+   e[4] +=     f; f = e[4] >> 26; e[4] &= 0x3ffffff;
+   e[0] += f * 5; f = e[0] >> 26; e[0] &= 0x3ffffff;
+   e[1] +=     f;
+
+   for (i = 0; i < 5; i++) {
+      h[i] = (ulong32)e[i];
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(t, sizeof(t));
+   zeromem(e, sizeof(e));
+#endif
+}
+
+#undef MUL5
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -191,6 +191,9 @@ const char *crypt_build_settings =
 #if defined(LTC_BLAKE2B)
    "   BLAKE2B\n"
 #endif
+#if defined(LTC_BLAKE3)
+   "   BLAKE3\n"
+#endif
 #if defined(LTC_CHC_HASH)
    "   CHC_HASH\n"
 #endif
@@ -274,6 +277,9 @@ const char *crypt_build_settings =
 #endif
 #if defined(LTC_GCM_TABLES_SSE2)
     " (SSE2) "
+#endif
+#if defined(LTC_GCM_CLMUL)
+    " (CLMUL) "
 #endif
    "\n"
 #endif
@@ -294,6 +300,9 @@ const char *crypt_build_settings =
 #if defined(LTC_CHACHA20_PRNG)
     "   ChaCha20\n"
 #endif
+#if defined(LTC_FKE_PRNG)
+    "   FKE (" NAME_VALUE(LTC_FKE_BUFSIZE) ")\n"
+#endif
 #if defined(LTC_FORTUNA)
     "   Fortuna (" NAME_VALUE(LTC_FORTUNA_POOLS) ", " NAME_VALUE(LTC_FORTUNA_WD) ")\n"
 #endif
@@ -0,0 +1,86 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file crypt_cpu_features.c
+  Runtime detection of the x86 instruction set extensions
+*/
+
+#ifdef LTC_X86_SIMD
+
+#include <cpuid.h>
+
+/* read XCR0, to check the OS saves the YMM/ZMM registers */
+static ulong64 _xgetbv(void)
+{
+   ulong32 lo, hi;
+   __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+   return ((ulong64)hi << 32) | lo;
+}
+
+static ulong32 _cpu_features(void)
+{
+   unsigned int a, b, c, d, max;
+   ulong32 f = 0;
+
+   max = __get_cpuid_max(0, NULL);
+   if (max < 1) {
+      return 0;
+   }
+   __cpuid(1, a, b, c, d);
+   if (c & (1u <<  9)) f |= LTC_CPU_SSSE3;
+   if (c & (1u << 19)) f |= LTC_CPU_SSE41;
+   if (c & (1u << 25)) f |= LTC_CPU_AESNI;
+   if (c & (1u <<  1)) f |= LTC_CPU_PCLMUL;
+
+   /* AVX needs the OS to save the upper halves of the registers */
+   if ((c & (1u << 27)) && (c & (1u << 28)) && (_xgetbv() & 6) == 6) {
+      f |= LTC_CPU_AVX;
+   }
+
+   if (max >= 7) {
+      __cpuid_count(7, 0, a, b, c, d);
+      if (b & (1u << 29)) f |= LTC_CPU_SHA;
+      if (b & (1u <<  8)) f |= LTC_CPU_BMI2;
+      if ((f & LTC_CPU_AVX) && (b & (1u << 5))) f |= LTC_CPU_AVX2;
+      if ((f & LTC_CPU_AVX) && (b & (1u << 16)) && (_xgetbv() & 0xe6) == 0xe6) {
+         f |= LTC_CPU_AVX512F;
+      }
+   }
+   return f;
+}
+
+#endif /* LTC_X86_SIMD */
+
+/**
+  Query the instruction set extensions of the CPU (cached after the first call)
+  @param features  The LTC_CPU_* flags wanted
+  @return Non-zero if all of them are available
+*/
+int crypt_cpu_has(ulong32 features)
+{
+#ifdef LTC_X86_SIMD
+   static volatile ulong32 cached = 0;
+   ulong32 f = cached;
+
+   if (f == 0) {
+      /* bit 31 marks the cache as filled, racing threads store the same value */
+      cached = f = _cpu_features() | 0x80000000UL;
+   }
+   return (f & features) == features;
+#else
+   LTC_UNUSED_PARAM(features);
+   return 0;
+#endif
+}
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
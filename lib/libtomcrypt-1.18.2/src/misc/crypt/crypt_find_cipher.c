@@ -22,15 +22,14 @@ int find_cipher(const char *name)
 {
    int x;
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (cipher_descriptor[x].name != NULL && !XSTRCMP(cipher_descriptor[x].name, name)) {
-          LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-          return x;
-       }
+   /* no lock unless the table changed since the index was built */
+   if (crypt_name_index_lookup(&ltc_cipher_index, name, &x) == CRYPT_OK) {
+      return x;
    }
+   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
+   x = crypt_name_index_find(&ltc_cipher_index, cipher_descriptor, sizeof(cipher_descriptor[0]), name);
    LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-   return -1;
+   return x;
 }
 
 
@@ -22,15 +22,14 @@ int find_hash(const char *name)
 {
    int x;
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (hash_descriptor[x].name != NULL && XSTRCMP(hash_descriptor[x].name, name) == 0) {
-          LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-          return x;
-       }
+   /* no lock unless the table changed since the index was built */
+   if (crypt_name_index_lookup(&ltc_hash_index, name, &x) == CRYPT_OK) {
+      return x;
    }
+   LTC_MUTEX_LOCK(&ltc_hash_mutex);
+   x = crypt_name_index_find(&ltc_hash_index, hash_descriptor, sizeof(hash_descriptor[0]), name);
    LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-   return -1;
+   return x;
 }
 
 /* ref:         tag: v1.18.2, master */
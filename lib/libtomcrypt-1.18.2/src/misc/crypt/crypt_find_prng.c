@@ -22,15 +22,14 @@ int find_prng(const char *name)
 {
    int x;
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_prng_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if ((prng_descriptor[x].name != NULL) && XSTRCMP(prng_descriptor[x].name, name) == 0) {
-          LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
-          return x;
-       }
+   /* no lock unless the table changed since the index was built */
+   if (crypt_name_index_lookup(&ltc_prng_index, name, &x) == CRYPT_OK) {
+      return x;
    }
+   LTC_MUTEX_LOCK(&ltc_prng_mutex);
+   x = crypt_name_index_find(&ltc_prng_index, prng_descriptor, sizeof(prng_descriptor[0]), name);
    LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
-   return -1;
+   return x;
 }
 
 
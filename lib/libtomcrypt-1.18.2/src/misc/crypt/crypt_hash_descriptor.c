@@ -19,6 +19,8 @@ struct ltc_hash_descriptor hash_descriptor[TAB_SIZE] = {
 
 LTC_MUTEX_GLOBAL(ltc_hash_mutex)
 
+ltc_name_index ltc_hash_index = { 0 };
+
 
 /* ref:         tag: v1.18.2, master */
 /* git commit:  7e7eb695d581782f04b24dc444cbfde86af59853 */
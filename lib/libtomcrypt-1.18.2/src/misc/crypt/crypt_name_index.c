@@ -0,0 +1,207 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file crypt_name_index.c
+  Constant time lookup of the descriptor tables by name
+
+  Each table has an open addressed index of the names in it. The hash
+  is seeded, and the index is built with the first seed that puts
+  every name in a slot of its own, so a lookup is one hash and one
+  compare. Linear probing takes care of the clashes left when no such
+  seed is found.
+
+  Registering or unregistering marks the index stale, the next lookup
+  rebuilds it under the mutex of the table. In between, lookups read it
+  under a sequence count and take no lock: the count is odd while the
+  index is current, and a lookup that sees it change retries locked.
+*/
+
+#if (LTC_NAME_SLOTS & (LTC_NAME_SLOTS - 1)) != 0 || LTC_NAME_SLOTS < 2 * TAB_SIZE
+   #error LTC_NAME_SLOTS must be a power of two and at least twice TAB_SIZE
+#endif
+
+/* how many seeds are tried for an index free of clashes */
+#define LTC_NAME_SEEDS 64
+
+#if defined(LTC_PTHREAD) && defined(__GNUC__)
+   #define NI_LOAD(x)       __atomic_load_n(&(x), __ATOMIC_RELAXED)
+   #define NI_STORE(x, v)   __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+   #define NI_LOAD_SEQ(x)   __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+   #define NI_STORE_SEQ(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+   #define NI_FENCE_ACQ()   __atomic_thread_fence(__ATOMIC_ACQUIRE)
+   #define NI_FENCE_REL()   __atomic_thread_fence(__ATOMIC_RELEASE)
+#elif !defined(LTC_PTHREAD)
+   /* no threads to race with */
+   #define NI_LOAD(x)       (x)
+   #define NI_STORE(x, v)   (x) = (v)
+   #define NI_LOAD_SEQ(x)   (x)
+   #define NI_STORE_SEQ(x, v) (x) = (v)
+   #define NI_FENCE_ACQ()
+   #define NI_FENCE_REL()
+#else
+   /* no atomics known for this compiler, every lookup takes the lock */
+   #define LTC_NAME_LOCKED
+   #define NI_LOAD(x)       (x)
+   #define NI_STORE(x, v)   (x) = (v)
+   #define NI_STORE_SEQ(x, v) (x) = (v)
+   #define NI_FENCE_REL()
+#endif
+
+/* FNV-1a, with the seed folded into the offset basis */
+static ulong32 _name_hash(ulong32 seed, const char *name)
+{
+   ulong32 h = 2166136261UL ^ seed;
+
+   while (*name != '\0') {
+      h ^= (unsigned char)*name++;
+      h = (h * 16777619UL) & 0xFFFFFFFFUL;
+   }
+   return h ^ (h >> 16);
+}
+
+static int _name_probe(const ltc_name_index *ni, const char *name)
+{
+   ulong32 h = _name_hash(NI_LOAD(ni->seed), name);
+   unsigned long s = h & (LTC_NAME_SLOTS - 1), n;
+   const char *p;
+
+   for (n = 0; n < LTC_NAME_SLOTS; n++) {
+      p = NI_LOAD(ni->slot[s].name);
+      if (p == NULL) {
+         return -1;
+      }
+      if (NI_LOAD(ni->slot[s].hash) == h && XSTRCMP(p, name) == 0) {
+         return NI_LOAD(ni->slot[s].idx);
+      }
+      s = (s + 1) & (LTC_NAME_SLOTS - 1);
+   }
+   return -1;
+}
+
+static void _name_build(ltc_name_index *ni, const unsigned char *table, unsigned long stride)
+{
+   const char *names[TAB_SIZE];
+   unsigned char used[LTC_NAME_SLOTS];
+   ulong32 seed, best = 0, h;
+   unsigned long s;
+   int x, clash, least = TAB_SIZE + 1;
+
+   for (x = 0; x < TAB_SIZE; x++) {
+      XMEMCPY(&names[x], table + x * stride, sizeof(names[x]));
+   }
+
+   for (seed = 0; seed < LTC_NAME_SEEDS && least > 0; seed++) {
+      XMEMSET(used, 0, sizeof(used));
+      for (x = clash = 0; x < TAB_SIZE; x++) {
+         if (names[x] == NULL) continue;
+         s = _name_hash(seed, names[x]) & (LTC_NAME_SLOTS - 1);
+         clash += used[s];
+         used[s] = 1;
+      }
+      if (clash < least) {
+         least = clash;
+         best = seed;
+      }
+   }
+
+   for (s = 0; s < LTC_NAME_SLOTS; s++) {
+      NI_STORE(ni->slot[s].name, NULL);
+   }
+   NI_STORE(ni->seed, best);
+
+   /* in table order, so a name in the table twice finds the first */
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (names[x] == NULL) continue;
+      h = _name_hash(best, names[x]);
+      s = h & (LTC_NAME_SLOTS - 1);
+      while (ni->slot[s].name != NULL) {
+         s = (s + 1) & (LTC_NAME_SLOTS - 1);
+      }
+      NI_STORE(ni->slot[s].hash, h);
+      NI_STORE(ni->slot[s].idx, x);
+      NI_STORE(ni->slot[s].name, names[x]);
+   }
+}
+
+/**
+  Mark an index stale, after its table changed [call with the table locked]
+  @param ni   The index
+*/
+void crypt_name_index_stale(ltc_name_index *ni)
+{
+   LTC_ARGCHKVD(ni != NULL);
+
+   if (ni->seq & 1) {
+      NI_STORE(ni->seq, ni->seq + 1);
+      NI_FENCE_REL();
+   }
+}
+
+/**
+  Look a name up without taking the lock of the table
+  @param ni     The index
+  @param name   The name to look for
+  @param idx    [out] Its index in the table, -1 if it is not there
+  @return CRYPT_OK if the index was current, CRYPT_ERROR if the lookup must be made locked
+*/
+int crypt_name_index_lookup(const ltc_name_index *ni, const char *name, int *idx)
+{
+#ifdef LTC_NAME_LOCKED
+   LTC_UNUSED_PARAM(ni);
+   LTC_UNUSED_PARAM(name);
+   LTC_UNUSED_PARAM(idx);
+   return CRYPT_ERROR;
+#else
+   ulong32 seq;
+   int x;
+
+   LTC_ARGCHK(ni   != NULL);
+   LTC_ARGCHK(name != NULL);
+   LTC_ARGCHK(idx  != NULL);
+
+   seq = NI_LOAD_SEQ(ni->seq);
+   if ((seq & 1) == 0) {
+      return CRYPT_ERROR;
+   }
+   x = _name_probe(ni, name);
+   NI_FENCE_ACQ();
+   if (NI_LOAD(ni->seq) != seq) {
+      return CRYPT_ERROR;
+   }
+   *idx = x;
+   return CRYPT_OK;
+#endif
+}
+
+/**
+  Look a name up, rebuilding the index first if it is stale [call with the table locked]
+  @param ni       The index
+  @param table    The descriptor table, whose entries start with their name
+  @param stride   The size of an entry of the table
+  @param name     The name to look for
+  @return Its index in the table, -1 if it is not there
+*/
+int crypt_name_index_find(ltc_name_index *ni, const void *table, unsigned long stride, const char *name)
+{
+   LTC_ARGCHK(ni    != NULL);
+   LTC_ARGCHK(table != NULL);
+   LTC_ARGCHK(name  != NULL);
+
+   if ((ni->seq & 1) == 0) {
+      _name_build(ni, table, stride);
+      NI_STORE_SEQ(ni->seq, ni->seq + 1);
+   }
+   return _name_probe(ni, name);
+}
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -18,6 +18,8 @@ struct ltc_prng_descriptor prng_descriptor[TAB_SIZE] = {
 
 LTC_MUTEX_GLOBAL(ltc_prng_mutex)
 
+ltc_name_index ltc_prng_index = { 0 };
+
 
 /* ref:         tag: v1.18.2, master */
 /* git commit:  7e7eb695d581782f04b24dc444cbfde86af59853 */
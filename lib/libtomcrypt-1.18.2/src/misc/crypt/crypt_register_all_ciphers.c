@@ -19,82 +19,116 @@
    LTC_ARGCHK(register_cipher(h) != -1); \
 } while(0)
 
-int register_all_ciphers(void)
-{
+/* what register_all_ciphers() registers, in that order, and what
+   find_cipher_builtin() registers on first use */
+static const struct ltc_cipher_descriptor *const _builtin_ciphers[] = {
 #ifdef LTC_RIJNDAEL
 #ifdef ENCRYPT_ONLY
    /* alternative would be
     * register_cipher(&rijndael_enc_desc);
     */
-   REGISTER_CIPHER(&aes_enc_desc);
+   &aes_enc_desc,
 #else
    /* alternative would be
     * register_cipher(&rijndael_desc);
     */
-   REGISTER_CIPHER(&aes_desc);
+   &aes_desc,
 #endif
 #endif
 #ifdef LTC_BLOWFISH
-   REGISTER_CIPHER(&blowfish_desc);
+   &blowfish_desc,
 #endif
 #ifdef LTC_XTEA
-   REGISTER_CIPHER(&xtea_desc);
+   &xtea_desc,
 #endif
 #ifdef LTC_RC5
-   REGISTER_CIPHER(&rc5_desc);
+   &rc5_desc,
 #endif
 #ifdef LTC_RC6
-   REGISTER_CIPHER(&rc6_desc);
+   &rc6_desc,
 #endif
 #ifdef LTC_SAFERP
-   REGISTER_CIPHER(&saferp_desc);
+   &saferp_desc,
 #endif
 #ifdef LTC_TWOFISH
-   REGISTER_CIPHER(&twofish_desc);
+   &twofish_desc,
 #endif
 #ifdef LTC_SAFER
-   REGISTER_CIPHER(&safer_k64_desc);
-   REGISTER_CIPHER(&safer_sk64_desc);
-   REGISTER_CIPHER(&safer_k128_desc);
-   REGISTER_CIPHER(&safer_sk128_desc);
+   &safer_k64_desc,
+   &safer_sk64_desc,
+   &safer_k128_desc,
+   &safer_sk128_desc,
 #endif
 #ifdef LTC_RC2
-   REGISTER_CIPHER(&rc2_desc);
+   &rc2_desc,
 #endif
 #ifdef LTC_DES
-   REGISTER_CIPHER(&des_desc);
-   REGISTER_CIPHER(&des3_desc);
+   &des_desc,
+   &des3_desc,
 #endif
 #ifdef LTC_CAST5
-   REGISTER_CIPHER(&cast5_desc);
+   &cast5_desc,
 #endif
 #ifdef LTC_NOEKEON
-   REGISTER_CIPHER(&noekeon_desc);
+   &noekeon_desc,
 #endif
 #ifdef LTC_SKIPJACK
-   REGISTER_CIPHER(&skipjack_desc);
+   &skipjack_desc,
 #endif
 #ifdef LTC_ANUBIS
-   REGISTER_CIPHER(&anubis_desc);
+   &anubis_desc,
 #endif
 #ifdef LTC_KHAZAD
-   REGISTER_CIPHER(&khazad_desc);
+   &khazad_desc,
 #endif
 #ifdef LTC_KSEED
-   REGISTER_CIPHER(&kseed_desc);
+   &kseed_desc,
 #endif
 #ifdef LTC_KASUMI
-   REGISTER_CIPHER(&kasumi_desc);
+   &kasumi_desc,
 #endif
 #ifdef LTC_MULTI2
-   REGISTER_CIPHER(&multi2_desc);
+   &multi2_desc,
 #endif
 #ifdef LTC_CAMELLIA
-   REGISTER_CIPHER(&camellia_desc);
+   &camellia_desc,
 #endif
+   NULL
+};
+
+int register_all_ciphers(void)
+{
+   int x;
+
+   for (x = 0; _builtin_ciphers[x] != NULL; x++) {
+      REGISTER_CIPHER(_builtin_ciphers[x]);
+   }
    return CRYPT_OK;
 }
 
+/**
+   Find a cipher by name, registering the built-in cipher of that name on first use
+   @param name   The name of the cipher to look for
+   @return >= 0 if found, -1 if there is no such cipher or the table is full
+*/
+int find_cipher_builtin(const char *name)
+{
+   int x, y;
+
+   LTC_ARGCHK(name != NULL);
+
+   if ((y = find_cipher(name)) != -1) {
+      return y;
+   }
+   for (x = 0; _builtin_ciphers[x] != NULL; x++) {
+      if (XSTRCMP(_builtin_ciphers[x]->name, name) == 0) {
+         y = register_cipher(_builtin_ciphers[x]);
+         return y;
+      }
+   }
+   return -1;
+}
+
 /* ref:         tag: v1.18.2, master */
 /* git commit:  7e7eb695d581782f04b24dc444cbfde86af59853 */
 /* commit time: 2018-07-01 22:49:01 +0200 */
@@ -19,81 +19,126 @@
    LTC_ARGCHK(register_hash(h) != -1); \
 } while(0)
 
-int register_all_hashes(void)
-{
+/* what register_all_hashes() registers, in that order, and what
+   find_hash_builtin() registers on first use */
+static const struct ltc_hash_descriptor *const _builtin_hashes[] = {
 #ifdef LTC_TIGER
-   REGISTER_HASH(&tiger_desc);
+   &tiger_desc,
 #endif
 #ifdef LTC_MD2
-   REGISTER_HASH(&md2_desc);
+   &md2_desc,
 #endif
 #ifdef LTC_MD4
-   REGISTER_HASH(&md4_desc);
+   &md4_desc,
 #endif
 #ifdef LTC_MD5
-   REGISTER_HASH(&md5_desc);
+   &md5_desc,
 #endif
 #ifdef LTC_SHA1
-   REGISTER_HASH(&sha1_desc);
+   &sha1_desc,
 #endif
 #ifdef LTC_SHA224
-   REGISTER_HASH(&sha224_desc);
+   &sha224_desc,
 #endif
 #ifdef LTC_SHA256
-   REGISTER_HASH(&sha256_desc);
+   &sha256_desc,
 #endif
 #ifdef LTC_SHA384
-   REGISTER_HASH(&sha384_desc);
+   &sha384_desc,
 #endif
 #ifdef LTC_SHA512
-   REGISTER_HASH(&sha512_desc);
+   &sha512_desc,
 #endif
 #ifdef LTC_SHA512_224
-   REGISTER_HASH(&sha512_224_desc);
+   &sha512_224_desc,
 #endif
 #ifdef LTC_SHA512_256
-   REGISTER_HASH(&sha512_256_desc);
+   &sha512_256_desc,
 #endif
 #ifdef LTC_SHA3
-   REGISTER_HASH(&sha3_224_desc);
-   REGISTER_HASH(&sha3_256_desc);
-   REGISTER_HASH(&sha3_384_desc);
-   REGISTER_HASH(&sha3_512_desc);
+   &sha3_224_desc,
+   &sha3_256_desc,
+   &sha3_384_desc,
+   &sha3_512_desc,
 #endif
 #ifdef LTC_RIPEMD128
-   REGISTER_HASH(&rmd128_desc);
+   &rmd128_desc,
 #endif
 #ifdef LTC_RIPEMD160
-   REGISTER_HASH(&rmd160_desc);
+   &rmd160_desc,
 #endif
 #ifdef LTC_RIPEMD256
-   REGISTER_HASH(&rmd256_desc);
+   &rmd256_desc,
 #endif
 #ifdef LTC_RIPEMD320
-   REGISTER_HASH(&rmd320_desc);
+   &rmd320_desc,
 #endif
 #ifdef LTC_WHIRLPOOL
-   REGISTER_HASH(&whirlpool_desc);
+   &whirlpool_desc,
 #endif
 #ifdef LTC_BLAKE2S
-   REGISTER_HASH(&blake2s_128_desc);
-   REGISTER_HASH(&blake2s_160_desc);
-   REGISTER_HASH(&blake2s_224_desc);
-   REGISTER_HASH(&blake2s_256_desc);
+   &blake2s_128_desc,
+   &blake2s_160_desc,
+   &blake2s_224_desc,
+   &blake2s_256_desc,
 #endif
 #ifdef LTC_BLAKE2S
-   REGISTER_HASH(&blake2b_160_desc);
-   REGISTER_HASH(&blake2b_256_desc);
-   REGISTER_HASH(&blake2b_384_desc);
-   REGISTER_HASH(&blake2b_512_desc);
+   &blake2b_160_desc,
+   &blake2b_256_desc,
+   &blake2b_384_desc,
+   &blake2b_512_desc,
+#endif
+#ifdef LTC_BLAKE3
+   &blake3_desc,
+#endif
+#ifdef LTC_CHC_HASH
+   &chc_desc,
 #endif
+   NULL
+};
+
+int register_all_hashes(void)
+{
+   int x;
+
+   for (x = 0; _builtin_hashes[x] != NULL; x++) {
+      REGISTER_HASH(_builtin_hashes[x]);
+   }
 #ifdef LTC_CHC_HASH
-   REGISTER_HASH(&chc_desc);
    LTC_ARGCHK(chc_register(find_cipher_any("aes", 8, 16)) == CRYPT_OK);
 #endif
    return CRYPT_OK;
 }
 
+/**
+   Find a hash by name, registering the built-in hash of that name on first use
+   @param name   The name of the hash to look for
+   @return >= 0 if found, -1 if there is no such hash or the table is full
+*/
+int find_hash_builtin(const char *name)
+{
+   int x, y;
+
+   LTC_ARGCHK(name != NULL);
+
+   if ((y = find_hash(name)) != -1) {
+      return y;
+   }
+   for (x = 0; _builtin_hashes[x] != NULL; x++) {
+      if (XSTRCMP(_builtin_hashes[x]->name, name) == 0) {
+         y = register_hash(_builtin_hashes[x]);
+#ifdef LTC_CHC_HASH
+         /* as register_all_hashes() does, with aes */
+         if (y != -1 && _builtin_hashes[x] == &chc_desc && chc_register(find_cipher_builtin("aes")) != CRYPT_OK) {
+            return -1;
+         }
+#endif
+         return y;
+      }
+   }
+   return -1;
+}
+
 /* ref:         tag: v1.18.2, master */
 /* git commit:  7e7eb695d581782f04b24dc444cbfde86af59853 */
 /* commit time: 2018-07-01 22:49:01 +0200 */
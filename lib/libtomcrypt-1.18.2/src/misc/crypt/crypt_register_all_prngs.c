@@ -19,30 +19,66 @@
    LTC_ARGCHK(register_prng(h) != -1); \
 } while(0)
 
-int register_all_prngs(void)
-{
+/* what register_all_prngs() registers, in that order, and what
+   find_prng_builtin() registers on first use */
+static const struct ltc_prng_descriptor *const _builtin_prngs[] = {
 #ifdef LTC_YARROW
-   REGISTER_PRNG(&yarrow_desc);
+   &yarrow_desc,
 #endif
 #ifdef LTC_FORTUNA
-   REGISTER_PRNG(&fortuna_desc);
+   &fortuna_desc,
 #endif
 #ifdef LTC_RC4
-   REGISTER_PRNG(&rc4_desc);
+   &rc4_desc,
 #endif
 #ifdef LTC_CHACHA20_PRNG
-   REGISTER_PRNG(&chacha20_prng_desc);
+   &chacha20_prng_desc,
+#endif
+#ifdef LTC_FKE_PRNG
+   &fke_desc,
 #endif
 #ifdef LTC_SOBER128
-   REGISTER_PRNG(&sober128_desc);
+   &sober128_desc,
 #endif
 #ifdef LTC_SPRNG
-   REGISTER_PRNG(&sprng_desc);
+   &sprng_desc,
 #endif
+   NULL
+};
 
+int register_all_prngs(void)
+{
+   int x;
+
+   for (x = 0; _builtin_prngs[x] != NULL; x++) {
+      REGISTER_PRNG(_builtin_prngs[x]);
+   }
    return CRYPT_OK;
 }
 
+/**
+   Find a PRNG by name, registering the built-in PRNG of that name on first use
+   @param name   The name of the PRNG to look for
+   @return >= 0 if found, -1 if there is no such PRNG or the table is full
+*/
+int find_prng_builtin(const char *name)
+{
+   int x, y;
+
+   LTC_ARGCHK(name != NULL);
+
+   if ((y = find_prng(name)) != -1) {
+      return y;
+   }
+   for (x = 0; _builtin_prngs[x] != NULL; x++) {
+      if (XSTRCMP(_builtin_prngs[x]->name, name) == 0) {
+         y = register_prng(_builtin_prngs[x]);
+         return y;
+      }
+   }
+   return -1;
+}
+
 /* ref:         tag: v1.18.2, master */
 /* git commit:  7e7eb695d581782f04b24dc444cbfde86af59853 */
 /* commit time: 2018-07-01 22:49:01 +0200 */
@@ -36,6 +36,7 @@ int register_cipher(const struct ltc_cipher_descriptor *cipher)
    /* find a blank spot */
    for (x = 0; x < TAB_SIZE; x++) {
        if (cipher_descriptor[x].name == NULL) {
+          crypt_name_index_stale(&ltc_cipher_index);
           XMEMCPY(&cipher_descriptor[x], cipher, sizeof(struct ltc_cipher_descriptor));
           LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
           return x;
@@ -36,6 +36,7 @@ int register_hash(const struct ltc_hash_descriptor *hash)
    /* find a blank spot */
    for (x = 0; x < TAB_SIZE; x++) {
        if (hash_descriptor[x].name == NULL) {
+          crypt_name_index_stale(&ltc_hash_index);
           XMEMCPY(&hash_descriptor[x], hash, sizeof(struct ltc_hash_descriptor));
           LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
           return x;
@@ -36,6 +36,7 @@ int register_prng(const struct ltc_prng_descriptor *prng)
    /* find a blank spot */
    for (x = 0; x < TAB_SIZE; x++) {
        if (prng_descriptor[x].name == NULL) {
+          crypt_name_index_stale(&ltc_prng_index);
           XMEMCPY(&prng_descriptor[x], prng, sizeof(struct ltc_prng_descriptor));
           LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
           return x;
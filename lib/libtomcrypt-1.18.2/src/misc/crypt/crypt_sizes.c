@@ -78,6 +78,9 @@ static const crypt_size _crypt_sizes[] = {
 #ifdef LTC_BLAKE2B
     _SZ_STRINGIFY_S(blake2b_state),
 #endif
+#ifdef LTC_BLAKE3
+    _SZ_STRINGIFY_S(blake3_state),
+#endif
 
     /* block cipher key sizes */
     _SZ_STRINGIFY_S(ltc_cipher_descriptor),
@@ -254,6 +257,9 @@ static const crypt_size _crypt_sizes[] = {
 #ifdef LTC_CHACHA20_PRNG
     _SZ_STRINGIFY_S(chacha20_prng),
 #endif
+#ifdef LTC_FKE_PRNG
+    _SZ_STRINGIFY_S(fke_prng),
+#endif
 #ifdef LTC_RC4
     _SZ_STRINGIFY_S(rc4_prng),
 #endif
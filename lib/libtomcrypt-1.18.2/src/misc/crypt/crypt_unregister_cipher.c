@@ -28,6 +28,7 @@ int unregister_cipher(const struct ltc_cipher_descriptor *cipher)
    LTC_MUTEX_LOCK(&ltc_cipher_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&cipher_descriptor[x], cipher, sizeof(struct ltc_cipher_descriptor)) == 0) {
+          crypt_name_index_stale(&ltc_cipher_index);
           cipher_descriptor[x].name = NULL;
           cipher_descriptor[x].ID   = 255;
           LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
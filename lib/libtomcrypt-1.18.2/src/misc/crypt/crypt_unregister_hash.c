@@ -28,6 +28,7 @@ int unregister_hash(const struct ltc_hash_descriptor *hash)
    LTC_MUTEX_LOCK(&ltc_hash_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&hash_descriptor[x], hash, sizeof(struct ltc_hash_descriptor)) == 0) {
+          crypt_name_index_stale(&ltc_hash_index);
           hash_descriptor[x].name = NULL;
           LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
           return CRYPT_OK;
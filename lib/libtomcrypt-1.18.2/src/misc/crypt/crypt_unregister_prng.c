@@ -28,6 +28,7 @@ int unregister_prng(const struct ltc_prng_descriptor *prng)
    LTC_MUTEX_LOCK(&ltc_prng_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&prng_descriptor[x], prng, sizeof(struct ltc_prng_descriptor)) == 0) {
+          crypt_name_index_stale(&ltc_prng_index);
           prng_descriptor[x].name = NULL;
           LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
           return CRYPT_OK;
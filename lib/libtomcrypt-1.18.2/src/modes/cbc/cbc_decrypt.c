@@ -16,6 +16,55 @@
 
 #ifdef LTC_CBC_MODE
 
+/* blocks handed to the accel_ecb_decrypt hook at once */
+#define CBC_BATCH 8
+
+/* Each plaintext block only needs its own and the previous ciphertext
+ * block, so CBC_BATCH blocks are decrypted in one go. They are XORed
+ * from the last one back, which reads every ciphertext block before
+ * the plaintext can overwrite it when pt == ct. */
+static int _cbc_decrypt_blocks(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_CBC *cbc)
+{
+   unsigned char buf[CBC_BATCH * 16], next[16];
+   unsigned long bl = (unsigned long)cbc->blocklen, n, x;
+   int err;
+
+   while (blocks > 0) {
+      n = (blocks < CBC_BATCH) ? blocks : CBC_BATCH;
+
+      if ((err = cipher_descriptor[cbc->cipher].accel_ecb_decrypt(ct, buf, n, &cbc->key)) != CRYPT_OK) {
+         return err;
+      }
+      XMEMCPY(next, ct + (n - 1) * bl, bl);
+
+#ifdef LTC_FAST
+      for (x = n * bl; x > bl; ) {
+         x -= sizeof(LTC_FAST_TYPE);
+         *(LTC_FAST_TYPE_PTR_CAST(pt + x)) = *(LTC_FAST_TYPE_PTR_CAST(buf + x)) ^ *(LTC_FAST_TYPE_PTR_CAST(ct + x - bl));
+      }
+      for (x = 0; x < bl; x += sizeof(LTC_FAST_TYPE)) {
+         *(LTC_FAST_TYPE_PTR_CAST(pt + x)) = *(LTC_FAST_TYPE_PTR_CAST(buf + x)) ^ *(LTC_FAST_TYPE_PTR_CAST(cbc->IV + x));
+      }
+#else
+      for (x = n * bl; x > bl; ) {
+         x--;
+         pt[x] = buf[x] ^ ct[x - bl];
+      }
+      for (x = 0; x < bl; x++) {
+         pt[x] = buf[x] ^ cbc->IV[x];
+      }
+#endif
+      XMEMCPY(cbc->IV, next, bl);
+
+      ct += n * bl;
+      pt += n * bl;
+      blocks -= n;
+   }
+
+   zeromem(buf, sizeof(buf));
+   return CRYPT_OK;
+}
+
 /**
   CBC decrypt
   @param ct     Ciphertext
@@ -58,6 +107,8 @@ int cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long len, s
 
    if (cipher_descriptor[cbc->cipher].accel_cbc_decrypt != NULL) {
       return cipher_descriptor[cbc->cipher].accel_cbc_decrypt(ct, pt, len / cbc->blocklen, cbc->IV, &cbc->key);
+   } else if (cipher_descriptor[cbc->cipher].accel_ecb_decrypt != NULL) {
+      return _cbc_decrypt_blocks(ct, pt, len / cbc->blocklen, cbc);
    } else {
       while (len) {
          /* decrypt */
@@ -107,8 +107,10 @@ int ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
    }
 #endif
 
-   /* handle acceleration only if pad is empty, accelerator is present and length is >= a block size */
-   if ((cipher_descriptor[ctr->cipher].accel_ctr_encrypt != NULL) && (len >= (unsigned long)ctr->blocklen)) {
+   /* handle acceleration only if pad is empty, accelerator is present and length is >= a block size;
+    * accelerators increment the whole block, so a narrower counter (e.g. RFC 3686) stays in software */
+   if ((cipher_descriptor[ctr->cipher].accel_ctr_encrypt != NULL) && (len >= (unsigned long)ctr->blocklen) &&
+       (ctr->ctrlen == ((ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) ? ctr->blocklen : 0))) {
      if (ctr->padlen < ctr->blocklen) {
        fr = ctr->blocklen - ctr->padlen;
        if ((err = _ctr_encrypt(pt, ct, fr, ctr)) != CRYPT_OK) {
@@ -48,6 +48,59 @@ static int _tweak_uncrypt(const unsigned char *C, unsigned char *P, unsigned cha
    return err;
 }
 
+/* blocks handed to the cipher at once by _tweak_uncrypt_blocks() */
+#define XTS_BATCH 8
+
+/* tweak decrypt blocks at a time: the tweaks do not depend on the data,
+ * so XTS_BATCH of them are worked out first and the blocks go through
+ * the accel_ecb_decrypt hook of the cipher together */
+static int _tweak_uncrypt_blocks(const unsigned char *C, unsigned char *P, unsigned long blocks, unsigned char *T, symmetric_xts *xts)
+{
+   unsigned char TT[XTS_BATCH * 16];
+   unsigned long x, i, n;
+   int err;
+
+   while (blocks > 0) {
+      n = (blocks < XTS_BATCH) ? blocks : XTS_BATCH;
+
+      for (i = 0; i < n; i++) {
+         XMEMCPY(TT + 16 * i, T, 16);
+         xts_mult_x(T);
+      }
+
+#ifdef LTC_FAST
+      for (x = 0; x < 16 * n; x += sizeof(LTC_FAST_TYPE)) {
+         *(LTC_FAST_TYPE_PTR_CAST(&P[x])) = *(LTC_FAST_TYPE_PTR_CAST(&C[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&TT[x]));
+      }
+#else
+      for (x = 0; x < 16 * n; x++) {
+         P[x] = C[x] ^ TT[x];
+      }
+#endif
+
+      if ((err = cipher_descriptor[xts->cipher].accel_ecb_decrypt(P, P, n, &xts->key1)) != CRYPT_OK) {
+         return err;
+      }
+
+#ifdef LTC_FAST
+      for (x = 0; x < 16 * n; x += sizeof(LTC_FAST_TYPE)) {
+         *(LTC_FAST_TYPE_PTR_CAST(&P[x])) ^= *(LTC_FAST_TYPE_PTR_CAST(&TT[x]));
+      }
+#else
+      for (x = 0; x < 16 * n; x++) {
+         P[x] = P[x] ^ TT[x];
+      }
+#endif
+
+      C += 16 * n;
+      P += 16 * n;
+      blocks -= n;
+   }
+
+   zeromem(TT, sizeof(TT));
+   return CRYPT_OK;
+}
+
 /** XTS Decryption
  @param ct     [in] Ciphertext
  @param ptlen  Length of plaintext (and ciphertext)
@@ -107,12 +160,20 @@ int xts_decrypt(const unsigned char *ct, unsigned long ptlen, unsigned char *pt,
          return err;
       }
 
-      for (i = 0; i < lim; i++) {
-         if ((err = _tweak_uncrypt(ct, pt, T, xts)) != CRYPT_OK) {
+      if (cipher_descriptor[xts->cipher].accel_ecb_decrypt && lim > 0) {
+         if ((err = _tweak_uncrypt_blocks(ct, pt, lim, T, xts)) != CRYPT_OK) {
             return err;
          }
-         ct += 16;
-         pt += 16;
+         ct += lim * 16;
+         pt += lim * 16;
+      } else {
+         for (i = 0; i < lim; i++) {
+            if ((err = _tweak_uncrypt(ct, pt, T, xts)) != CRYPT_OK) {
+               return err;
+            }
+            ct += 16;
+            pt += 16;
+         }
       }
    }
 
@@ -50,6 +50,59 @@ static int _tweak_crypt(const unsigned char *P, unsigned char *C, unsigned char
    return CRYPT_OK;
 }
 
+/* blocks handed to the cipher at once by _tweak_crypt_blocks() */
+#define XTS_BATCH 8
+
+/* tweak encrypt blocks at a time: the tweaks do not depend on the data,
+ * so XTS_BATCH of them are worked out first and the blocks go through
+ * the accel_ecb_encrypt hook of the cipher together */
+static int _tweak_crypt_blocks(const unsigned char *P, unsigned char *C, unsigned long blocks, unsigned char *T, symmetric_xts *xts)
+{
+   unsigned char TT[XTS_BATCH * 16];
+   unsigned long x, i, n;
+   int err;
+
+   while (blocks > 0) {
+      n = (blocks < XTS_BATCH) ? blocks : XTS_BATCH;
+
+      for (i = 0; i < n; i++) {
+         XMEMCPY(TT + 16 * i, T, 16);
+         xts_mult_x(T);
+      }
+
+#ifdef LTC_FAST
+      for (x = 0; x < 16 * n; x += sizeof(LTC_FAST_TYPE)) {
+         *(LTC_FAST_TYPE_PTR_CAST(&C[x])) = *(LTC_FAST_TYPE_PTR_CAST(&P[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&TT[x]));
+      }
+#else
+      for (x = 0; x < 16 * n; x++) {
+         C[x] = P[x] ^ TT[x];
+      }
+#endif
+
+      if ((err = cipher_descriptor[xts->cipher].accel_ecb_encrypt(C, C, n, &xts->key1)) != CRYPT_OK) {
+         return err;
+      }
+
+#ifdef LTC_FAST
+      for (x = 0; x < 16 * n; x += sizeof(LTC_FAST_TYPE)) {
+         *(LTC_FAST_TYPE_PTR_CAST(&C[x])) ^= *(LTC_FAST_TYPE_PTR_CAST(&TT[x]));
+      }
+#else
+      for (x = 0; x < 16 * n; x++) {
+         C[x] = C[x] ^ TT[x];
+      }
+#endif
+
+      P += 16 * n;
+      C += 16 * n;
+      blocks -= n;
+   }
+
+   zeromem(TT, sizeof(TT));
+   return CRYPT_OK;
+}
+
 /** XTS Encryption
  @param pt     [in]  Plaintext
  @param ptlen  Length of plaintext (and ciphertext)
@@ -110,12 +163,20 @@ int xts_encrypt(const unsigned char *pt, unsigned long ptlen, unsigned char *ct,
          return err;
       }
 
-      for (i = 0; i < lim; i++) {
-         if ((err = _tweak_crypt(pt, ct, T, xts)) != CRYPT_OK) {
+      if (cipher_descriptor[xts->cipher].accel_ecb_encrypt && lim > 0) {
+         if ((err = _tweak_crypt_blocks(pt, ct, lim, T, xts)) != CRYPT_OK) {
             return err;
          }
-         ct += 16;
-         pt += 16;
+         ct += lim * 16;
+         pt += lim * 16;
+      } else {
+         for (i = 0; i < lim; i++) {
+            if ((err = _tweak_crypt(pt, ct, T, xts)) != CRYPT_OK) {
+               return err;
+            }
+            ct += 16;
+            pt += 16;
+         }
       }
    }
 
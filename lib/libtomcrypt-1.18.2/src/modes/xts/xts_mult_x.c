@@ -19,17 +19,16 @@
 */
 void xts_mult_x(unsigned char *I)
 {
-   int x;
-   unsigned char t, tt;
+   ulong64 lo, hi, t;
 
-   for (x = t = 0; x < 16; x++) {
-      tt = I[x] >> 7;
-      I[x] = ((I[x] << 1) | t) & 0xFF;
-      t = tt;
-   }
-   if (tt) {
-      I[0] ^= 0x87;
-   }
+   /* I is a little endian 128-bit number, shifted without a branch */
+   LOAD64L(lo, I);
+   LOAD64L(hi, I + 8);
+   t = hi >> 63;
+   hi = (hi << 1) | (lo >> 63);
+   lo = (lo << 1) ^ (CONST64(0x87) & (0 - t));
+   STORE64L(lo, I);
+   STORE64L(hi, I + 8);
 }
 
 #endif
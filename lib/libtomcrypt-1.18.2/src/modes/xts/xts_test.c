@@ -201,8 +201,12 @@ int xts_test(void)
    unsigned char OUT[512], Torg[16], T[16];
    ulong64 seq;
    symmetric_xts xts;
-   int i, j, k, err, idx;
+   int i, j, k, e, err, idx;
    unsigned long len;
+   int (*ecb_enc)(const unsigned char *, unsigned char *, unsigned long, symmetric_key *);
+   int (*ecb_dec)(const unsigned char *, unsigned char *, unsigned long, symmetric_key *);
+   int (*xts_enc)(const unsigned char *, unsigned char *, unsigned long, unsigned char *, symmetric_key *, symmetric_key *);
+   int (*xts_dec)(const unsigned char *, unsigned char *, unsigned long, unsigned char *, symmetric_key *, symmetric_key *);
 
    /* AES can be under rijndael or aes... try to find it */
    if ((idx = find_cipher("aes")) == -1) {
@@ -210,91 +214,114 @@ int xts_test(void)
          return CRYPT_NOP;
       }
    }
-   for (k = 0; k < 4; ++k) {
-      cipher_descriptor[idx].accel_xts_encrypt = NULL;
-      cipher_descriptor[idx].accel_xts_decrypt = NULL;
-      if (k & 0x1) {
-         cipher_descriptor[idx].accel_xts_encrypt = _xts_test_accel_xts_encrypt;
-      }
-      if (k & 0x2) {
-         cipher_descriptor[idx].accel_xts_decrypt = _xts_test_accel_xts_decrypt;
-      }
-      for (j = 0; j < 2; j++) {
-         for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
-            /* skip the cases where
-             * the length is smaller than 2*blocklen
-             * or the length is not a multiple of 32
-             */
-            if ((j == 1) && ((tests[i].PTLEN < 32) || (tests[i].PTLEN % 32))) {
-               continue;
-            }
-            if ((k > 0) && (j == 1)) {
-               continue;
-            }
-            len = tests[i].PTLEN / 2;
+   ecb_enc = cipher_descriptor[idx].accel_ecb_encrypt;
+   ecb_dec = cipher_descriptor[idx].accel_ecb_decrypt;
+   xts_enc = cipher_descriptor[idx].accel_xts_encrypt;
+   xts_dec = cipher_descriptor[idx].accel_xts_decrypt;
 
-            err = xts_start(idx, tests[i].key1, tests[i].key2, tests[i].keylen / 2, 0, &xts);
-            if (err != CRYPT_OK) {
-               return err;
-            }
-
-            seq = tests[i].seqnum;
-            STORE64L(seq, Torg);
-            XMEMSET(Torg + 8, 0, 8);
-
-            XMEMCPY(T, Torg, sizeof(T));
-            if (j == 0) {
-               err = xts_encrypt(tests[i].PTX, tests[i].PTLEN, OUT, T, &xts);
-               if (err != CRYPT_OK) {
-                  xts_done(&xts);
-                  return err;
+   /* with the accel_ecb hooks the blocks are batched, without them
+    * they are done one at a time */
+   for (e = 0; e < 2; ++e) {
+      cipher_descriptor[idx].accel_ecb_encrypt = e ? NULL : ecb_enc;
+      cipher_descriptor[idx].accel_ecb_decrypt = e ? NULL : ecb_dec;
+      for (k = 0; k < 5; ++k) {
+         cipher_descriptor[idx].accel_xts_encrypt = NULL;
+         cipher_descriptor[idx].accel_xts_decrypt = NULL;
+         if (k & 0x1) {
+            cipher_descriptor[idx].accel_xts_encrypt = _xts_test_accel_xts_encrypt;
+         }
+         if (k & 0x2) {
+            cipher_descriptor[idx].accel_xts_decrypt = _xts_test_accel_xts_decrypt;
+         }
+         /* last the hooks of the cipher itself, if it has any */
+         if (k == 4) {
+            cipher_descriptor[idx].accel_xts_encrypt = xts_enc;
+            cipher_descriptor[idx].accel_xts_decrypt = xts_dec;
+         }
+         for (j = 0; j < 2; j++) {
+            for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+               /* skip the cases where
+                * the length is smaller than 2*blocklen
+                * or the length is not a multiple of 32
+                */
+               if ((j == 1) && ((tests[i].PTLEN < 32) || (tests[i].PTLEN % 32))) {
+                  continue;
                }
-            } else {
-               err = xts_encrypt(tests[i].PTX, len, OUT, T, &xts);
-               if (err != CRYPT_OK) {
-                  xts_done(&xts);
-                  return err;
+               /* the split calls are run with no hooks and with those of
+                * the cipher, whose tweak carries over from one call to
+                * the next */
+               if ((k > 0) && (k < 4) && (j == 1)) {
+                  continue;
                }
-               err = xts_encrypt(&tests[i].PTX[len], len, &OUT[len], T, &xts);
+               len = tests[i].PTLEN / 2;
+
+               err = xts_start(idx, tests[i].key1, tests[i].key2, tests[i].keylen / 2, 0, &xts);
                if (err != CRYPT_OK) {
-                  xts_done(&xts);
                   return err;
                }
-            }
 
-            if (compare_testvector(OUT, tests[i].PTLEN, tests[i].CTX, tests[i].PTLEN, "XTS encrypt", i)) {
-               xts_done(&xts);
-               return CRYPT_FAIL_TESTVECTOR;
-            }
+               seq = tests[i].seqnum;
+               STORE64L(seq, Torg);
+               XMEMSET(Torg + 8, 0, 8);
 
-            XMEMCPY(T, Torg, sizeof(T));
-            if (j == 0) {
-               err = xts_decrypt(tests[i].CTX, tests[i].PTLEN, OUT, T, &xts);
-               if (err != CRYPT_OK) {
-                  xts_done(&xts);
-                  return err;
+               XMEMCPY(T, Torg, sizeof(T));
+               if (j == 0) {
+                  err = xts_encrypt(tests[i].PTX, tests[i].PTLEN, OUT, T, &xts);
+                  if (err != CRYPT_OK) {
+                     xts_done(&xts);
+                     return err;
+                  }
+               } else {
+                  err = xts_encrypt(tests[i].PTX, len, OUT, T, &xts);
+                  if (err != CRYPT_OK) {
+                     xts_done(&xts);
+                     return err;
+                  }
+                  err = xts_encrypt(&tests[i].PTX[len], len, &OUT[len], T, &xts);
+                  if (err != CRYPT_OK) {
+                     xts_done(&xts);
+                     return err;
+                  }
                }
-            } else {
-               err = xts_decrypt(tests[i].CTX, len, OUT, T, &xts);
-               if (err != CRYPT_OK) {
+
+               if (compare_testvector(OUT, tests[i].PTLEN, tests[i].CTX, tests[i].PTLEN, "XTS encrypt", i)) {
                   xts_done(&xts);
-                  return err;
+                  return CRYPT_FAIL_TESTVECTOR;
                }
-               err = xts_decrypt(&tests[i].CTX[len], len, &OUT[len], T, &xts);
-               if (err != CRYPT_OK) {
-                  xts_done(&xts);
-                  return err;
+
+               XMEMCPY(T, Torg, sizeof(T));
+               if (j == 0) {
+                  err = xts_decrypt(tests[i].CTX, tests[i].PTLEN, OUT, T, &xts);
+                  if (err != CRYPT_OK) {
+                     xts_done(&xts);
+                     return err;
+                  }
+               } else {
+                  err = xts_decrypt(tests[i].CTX, len, OUT, T, &xts);
+                  if (err != CRYPT_OK) {
+                     xts_done(&xts);
+                     return err;
+                  }
+                  err = xts_decrypt(&tests[i].CTX[len], len, &OUT[len], T, &xts);
+                  if (err != CRYPT_OK) {
+                     xts_done(&xts);
+                     return err;
+                  }
                }
-            }
 
-            if (compare_testvector(OUT, tests[i].PTLEN, tests[i].PTX, tests[i].PTLEN, "XTS decrypt", i)) {
+               if (compare_testvector(OUT, tests[i].PTLEN, tests[i].PTX, tests[i].PTLEN, "XTS decrypt", i)) {
+                  xts_done(&xts);
+                  return CRYPT_FAIL_TESTVECTOR;
+               }
                xts_done(&xts);
-               return CRYPT_FAIL_TESTVECTOR;
             }
-            xts_done(&xts);
          }
       }
    }
+   cipher_descriptor[idx].accel_ecb_encrypt = ecb_enc;
+   cipher_descriptor[idx].accel_ecb_decrypt = ecb_dec;
+   cipher_descriptor[idx].accel_xts_encrypt = xts_enc;
+   cipher_descriptor[idx].accel_xts_decrypt = xts_dec;
    return CRYPT_OK;
 #endif
 }
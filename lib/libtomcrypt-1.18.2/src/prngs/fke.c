@@ -0,0 +1,343 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file fke.c
+  Fast key erasure PRNG, after
+  https://blog.cr.yp.to/20170723-random.html
+
+  The key is only ever used for one batch of ChaCha20 keystream: the
+  first 32 bytes of the batch replace it, the rest is handed out and
+  wiped as it goes. So whoever gets hold of the state learns nothing
+  of the bytes already read.
+
+  The state has no lock. A state shared by threads needs one around
+  it, fke_thread_read() instead gives every thread a state of its own.
+*/
+
+#ifdef LTC_FKE_PRNG
+
+#if !defined(LTC_NO_FILE) && defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/types.h>
+#include <unistd.h>
+#define LTC_FKE_THREAD
+#endif
+
+const struct ltc_prng_descriptor fke_desc =
+{
+   "fke",
+   32,
+   &fke_start,
+   &fke_add_entropy,
+   &fke_ready,
+   &fke_read,
+   &fke_done,
+   &fke_export,
+   &fke_import,
+   &fke_test
+};
+
+/* start the keystream of the key at the given nonce */
+static int _fke_stream(chacha_state *st, const unsigned char *key, unsigned char nonce)
+{
+   unsigned char iv[8] = { 0 };
+   int err;
+
+   iv[0] = nonce;
+   if ((err = chacha_setup(st, key, 32, 20)) != CRYPT_OK) return err;
+   return chacha_ivctr64(st, iv, sizeof(iv), 0);
+}
+
+/* a new batch: the head of it is the next key, the rest is output */
+static int _fke_refill(struct fke_prng *f)
+{
+   chacha_state st;
+   int err;
+
+   if ((err = _fke_stream(&st, f->key, 0)) == CRYPT_OK &&
+       (err = chacha_keystream(&st, f->buf, LTC_FKE_BUFSIZE)) == CRYPT_OK) {
+      XMEMCPY(f->key, f->buf, 32);
+      zeromem(f->buf, 32);
+      f->avail = LTC_FKE_BUFSIZE - 32;
+   }
+   chacha_done(&st);
+   return err;
+}
+
+static unsigned long _fke_read(unsigned char *out, unsigned long outlen, struct fke_prng *f)
+{
+   chacha_state st;
+   unsigned long n, len = outlen;
+   int err;
+
+   while (len > 0) {
+      if (f->avail == 0) {
+         /* a long read is one batch straight into out, on a nonce of its own */
+         if (len >= LTC_FKE_BUFSIZE) {
+            if ((err = _fke_stream(&st, f->key, 1)) == CRYPT_OK) {
+               err = chacha_keystream(&st, out, len);
+            }
+            chacha_done(&st);
+            if (err != CRYPT_OK || _fke_refill(f) != CRYPT_OK) return 0;
+            break;
+         }
+         if (_fke_refill(f) != CRYPT_OK) return 0;
+      }
+      n = MIN(len, f->avail);
+      XMEMCPY(out, f->buf + LTC_FKE_BUFSIZE - f->avail, n);
+      zeromem(f->buf + LTC_FKE_BUFSIZE - f->avail, n);
+      f->avail -= n;
+      out += n;
+      len -= n;
+   }
+   return outlen;
+}
+
+/**
+  Start the PRNG
+  @param prng     [out] The PRNG state to initialize
+  @return CRYPT_OK if successful
+*/
+int fke_start(prng_state *prng)
+{
+   LTC_ARGCHK(prng != NULL);
+   prng->ready = 0;
+   zeromem(&prng->fke, sizeof(prng->fke));
+   return CRYPT_OK;
+}
+
+/**
+  Add entropy to the PRNG state
+  @param in       The data to add
+  @param inlen    Length of the data to add
+  @param prng     PRNG state to update
+  @return CRYPT_OK if successful
+*/
+int fke_add_entropy(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   chacha_state st;
+   unsigned char buf[32];
+   unsigned long i;
+   int err;
+
+   LTC_ARGCHK(prng != NULL);
+   LTC_ARGCHK(in != NULL);
+   LTC_ARGCHK(inlen > 0);
+
+   if (prng->ready) {
+      /* rekey from a stream the output never comes from, and drop the batch */
+      if ((err = _fke_stream(&st, prng->fke.key, 2)) == CRYPT_OK) {
+         err = chacha_keystream(&st, buf, sizeof(buf));
+      }
+      chacha_done(&st);
+      if (err != CRYPT_OK) return err;
+      for (i = 0; i < inlen; i++) buf[i % sizeof(buf)] ^= in[i];
+      XMEMCPY(prng->fke.key, buf, sizeof(buf));
+      zeromem(buf, sizeof(buf));
+      zeromem(prng->fke.buf, sizeof(prng->fke.buf));
+      prng->fke.avail = 0;
+   }
+   else {
+      /* fke_ready() was not called yet, the entropy is the key */
+      while (inlen--) prng->fke.key[prng->fke.idx++ % sizeof(prng->fke.key)] ^= *in++;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Make the PRNG ready to read from
+  @param prng   The PRNG to make active
+  @return CRYPT_OK if successful
+*/
+int fke_ready(prng_state *prng)
+{
+   LTC_ARGCHK(prng != NULL);
+   prng->fke.avail = 0;
+   prng->fke.idx = 0;
+   prng->ready = 1;
+   return CRYPT_OK;
+}
+
+/**
+  Read from the PRNG
+  @param out      Destination
+  @param outlen   Length of output
+  @param prng     The active PRNG to read from
+  @return Number of octets read
+*/
+unsigned long fke_read(unsigned char *out, unsigned long outlen, prng_state *prng)
+{
+   if (outlen == 0 || prng == NULL || out == NULL || !prng->ready) return 0;
+   return _fke_read(out, outlen, &prng->fke);
+}
+
+/**
+  Terminate the PRNG
+  @param prng   The PRNG to terminate
+  @return CRYPT_OK if successful
+*/
+int fke_done(prng_state *prng)
+{
+   LTC_ARGCHK(prng != NULL);
+   prng->ready = 0;
+   zeromem(&prng->fke, sizeof(prng->fke));
+   return CRYPT_OK;
+}
+
+/**
+  Export the PRNG state
+  @param out       [out] Destination
+  @param outlen    [in/out] Max size and resulting size of the state
+  @param prng      The PRNG to export
+  @return CRYPT_OK if successful
+*/
+int fke_export(unsigned char *out, unsigned long *outlen, prng_state *prng)
+{
+   unsigned long len = fke_desc.export_size;
+
+   LTC_ARGCHK(prng   != NULL);
+   LTC_ARGCHK(out    != NULL);
+   LTC_ARGCHK(outlen != NULL);
+
+   if (*outlen < len) {
+      *outlen = len;
+      return CRYPT_BUFFER_OVERFLOW;
+   }
+
+   if (fke_read(out, len, prng) != len) {
+      return CRYPT_ERROR_READPRNG;
+   }
+
+   *outlen = len;
+   return CRYPT_OK;
+}
+
+/**
+  Import a PRNG state
+  @param in       The PRNG state
+  @param inlen    Size of the state
+  @param prng     The PRNG to import
+  @return CRYPT_OK if successful
+*/
+int fke_import(const unsigned char *in, unsigned long inlen, prng_state *prng)
+{
+   int err;
+
+   LTC_ARGCHK(prng != NULL);
+   LTC_ARGCHK(in   != NULL);
+   if (inlen < (unsigned long)fke_desc.export_size) return CRYPT_INVALID_ARG;
+
+   if ((err = fke_start(prng)) != CRYPT_OK)                  return err;
+   if ((err = fke_add_entropy(in, inlen, prng)) != CRYPT_OK) return err;
+   return CRYPT_OK;
+}
+
+#ifdef LTC_FKE_THREAD
+/* one generator per thread, so no lock */
+static __thread struct {
+   pid_t pid;
+   struct fke_prng f;
+} _fke_local;
+#endif
+
+/**
+  Read from the PRNG of the calling thread
+
+  Every thread has a state of its own, keyed from rng_get_bytes() on
+  its first read. A forked child keys its own as well, so it never
+  hands out the bytes of its parent. Where threads have no storage of
+  their own, this reads rng_get_bytes() instead.
+  @param out      Destination
+  @param outlen   Length of output
+  @return Number of octets read
+*/
+unsigned long fke_thread_read(unsigned char *out, unsigned long outlen)
+{
+#ifdef LTC_FKE_THREAD
+   pid_t pid;
+
+   if (outlen == 0 || out == NULL) return 0;
+
+   pid = getpid();
+   if (_fke_local.pid != pid) {
+      zeromem(&_fke_local.f, sizeof(_fke_local.f));
+      if (rng_get_bytes(_fke_local.f.key, sizeof(_fke_local.f.key), NULL) != sizeof(_fke_local.f.key)) {
+         return 0;
+      }
+      _fke_local.pid = pid;
+   }
+   return _fke_read(out, outlen, &_fke_local.f);
+#else
+   if (outlen == 0 || out == NULL) return 0;
+   return rng_get_bytes(out, outlen, NULL);
+#endif
+}
+
+/**
+  PRNG self-test
+  @return CRYPT_OK if successful, CRYPT_NOP if self-testing has been disabled
+*/
+int fke_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   prng_state st;
+   chacha_state cs;
+   unsigned char en[32], key[32], batch[LTC_FKE_BUFSIZE];
+   unsigned char out[2 * LTC_FKE_BUFSIZE], t[2 * LTC_FKE_BUFSIZE];
+   unsigned long x, n = LTC_FKE_BUFSIZE - 32;
+   int err;
+
+   for (x = 0; x < sizeof(en); x++) en[x] = (unsigned char)(x + 1);
+
+   /* the entropy is the first key, each batch starts with the next one */
+   XMEMCPY(key, en, sizeof(key));
+   for (x = 0; x < 3; x++) {
+      if ((err = _fke_stream(&cs, key, 0)) != CRYPT_OK)                    return err;
+      if ((err = chacha_keystream(&cs, batch, sizeof(batch))) != CRYPT_OK) return err;
+      if (x == 2) break;
+      XMEMCPY(key, batch, sizeof(key));
+      XMEMCPY(t + x * n, batch + 32, n);
+   }
+
+   if ((err = fke_start(&st)) != CRYPT_OK)                       return err;
+   if ((err = fke_add_entropy(en, sizeof(en), &st)) != CRYPT_OK) return err;
+   if ((err = fke_ready(&st)) != CRYPT_OK)                       return err;
+   if (fke_read(out, 10, &st) != 10)                             return CRYPT_ERROR_READPRNG;
+   if (fke_read(out + 10, n - 10, &st) != n - 10)                return CRYPT_ERROR_READPRNG;
+   if (fke_read(out + n, n, &st) != n)                           return CRYPT_ERROR_READPRNG;
+   if (compare_testvector(out, 2 * n, t, 2 * n, "FKE-PRNG", 1))  return CRYPT_FAIL_TESTVECTOR;
+   if (XMEMCMP(st.fke.key, key, sizeof(key)) != 0)               return CRYPT_FAIL_TESTVECTOR;
+
+   /* a long read comes from the stream of nonce 1, and moves on to the next key */
+   if ((err = _fke_stream(&cs, key, 1)) != CRYPT_OK)                       return err;
+   if ((err = chacha_keystream(&cs, t, LTC_FKE_BUFSIZE)) != CRYPT_OK)      return err;
+   chacha_done(&cs);
+   if (fke_read(out, LTC_FKE_BUFSIZE, &st) != LTC_FKE_BUFSIZE)   return CRYPT_ERROR_READPRNG;
+   if (compare_testvector(out, LTC_FKE_BUFSIZE, t, LTC_FKE_BUFSIZE, "FKE-PRNG", 2)) return CRYPT_FAIL_TESTVECTOR;
+   if (XMEMCMP(st.fke.key, batch, sizeof(key)) != 0)             return CRYPT_FAIL_TESTVECTOR;
+   if (fke_read(out, 10, &st) != 10)                             return CRYPT_ERROR_READPRNG;
+   if (compare_testvector(out, 10, batch + 32, 10, "FKE-PRNG", 3)) return CRYPT_FAIL_TESTVECTOR;
+   if ((err = fke_done(&st)) != CRYPT_OK)                        return err;
+
+   /* the state of the calling thread */
+   if (fke_thread_read(out, 16) != 16 || fke_thread_read(out + 16, 16) != 16 ||
+       XMEMCMP(out, out + 16, 16) == 0)                          return CRYPT_ERROR_READPRNG;
+
+   return CRYPT_OK;
+#endif
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
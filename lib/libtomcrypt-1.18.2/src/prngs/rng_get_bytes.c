@@ -14,6 +14,83 @@
    portable way to get secure random bits to feed a PRNG (Tom St Denis)
 */
 
+#if defined(__linux__) && !defined(LTC_NO_FILE)
+#include <sys/types.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_getrandom) && !defined(LTC_NO_FILE)
+#define LTC_GETRANDOM
+
+/* small reads are served from a buffer refilled LTC_RNG_POOL bytes at a time */
+#define LTC_RNG_POOL 256
+
+/* fill the whole buffer from getrandom(2), or return 0 */
+static unsigned long _getrandom(unsigned char *buf, unsigned long len)
+{
+   unsigned long x = 0;
+   long r;
+
+   while (x < len) {
+      r = syscall(SYS_getrandom, buf + x, len - x, 0);
+      if (r < 0) {
+         if (errno == EINTR) continue;
+         return 0;
+      }
+      x += (unsigned long)r;
+   }
+   return len;
+}
+
+#ifdef __GNUC__
+/* one pool per thread, so no lock; bytes handed out are wiped from it */
+static __thread struct {
+   pid_t pid;
+   unsigned long avail;
+   unsigned char buf[LTC_RNG_POOL];
+} _pool;
+#endif
+
+/* on Linux, ask the kernel directly: no file to open, and no /dev needed */
+static unsigned long _rng_getrandom(unsigned char *buf, unsigned long len,
+                                    void (*callback)(void))
+{
+#ifdef __GNUC__
+   unsigned long n;
+   pid_t pid;
+#endif
+   LTC_UNUSED_PARAM(callback);
+
+#ifdef __GNUC__
+   if (len < LTC_RNG_POOL / 2) {
+      /* a forked child must not hand out the bytes its parent holds */
+      pid = getpid();
+      if (_pool.pid != pid) {
+         zeromem(_pool.buf, sizeof(_pool.buf));
+         _pool.avail = 0;
+         _pool.pid = pid;
+      }
+      if (_pool.avail < len) {
+         if (_getrandom(_pool.buf, LTC_RNG_POOL) == 0) {
+            _pool.avail = 0;
+            return 0;
+         }
+         _pool.avail = LTC_RNG_POOL;
+      }
+      n = LTC_RNG_POOL - _pool.avail;
+      XMEMCPY(buf, _pool.buf + n, len);
+      zeromem(_pool.buf + n, len);
+      _pool.avail -= len;
+      return len;
+   }
+#endif
+   return _getrandom(buf, len);
+}
+
+#endif /* LTC_GETRANDOM */
+
 #if defined(LTC_DEVRANDOM) && !defined(_WIN32)
 /* on *NIX read /dev/random */
 static unsigned long _rng_nix(unsigned char *buf, unsigned long len,
@@ -144,9 +221,14 @@ unsigned long rng_get_bytes(unsigned char *out, unsigned long outlen,
 
 #if defined(_WIN32) || defined(_WIN32_WCE)
    x = _rng_win32(out, outlen, callback); if (x != 0) { return x; }
-#elif defined(LTC_DEVRANDOM)
+#else
+#ifdef LTC_GETRANDOM
+   x = _rng_getrandom(out, outlen, callback); if (x != 0) { return x; }
+#endif
+#ifdef LTC_DEVRANDOM
    x = _rng_nix(out, outlen, callback);   if (x != 0) { return x; }
 #endif
+#endif
 #ifdef ANSI_RNG
    x = _rng_ansic(out, outlen, callback); if (x != 0) { return x; }
 #endif
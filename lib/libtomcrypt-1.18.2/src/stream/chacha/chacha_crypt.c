@@ -71,6 +71,32 @@ int chacha_crypt(chacha_state *st, const unsigned char *in, unsigned long inlen,
       out += j;
       in  += j;
    }
+#if defined(LTC_AVX2) || defined(LTC_SSSE3)
+   /* whole blocks several at a time, as long as the counter does not wrap */
+#ifdef LTC_AVX2
+   if (inlen >= 512 && crypt_cpu_has(LTC_CPU_AVX2)) {
+      while (inlen >= 512 && st->input[12] <= 0xFFFFFFFFUL - 8) {
+         chacha_avx2_x8(st->input, st->rounds, in, out);
+         st->input[12] += 8;
+         inlen -= 512;
+         out += 512;
+         in  += 512;
+      }
+   }
+#endif
+#ifdef LTC_SSSE3
+   if (inlen >= 256 && crypt_cpu_has(LTC_CPU_SSSE3)) {
+      while (inlen >= 256 && st->input[12] <= 0xFFFFFFFFUL - 4) {
+         chacha_ssse3_x4(st->input, st->rounds, in, out);
+         st->input[12] += 4;
+         inlen -= 256;
+         out += 256;
+         in  += 256;
+      }
+   }
+#endif
+   if (inlen == 0) return CRYPT_OK;
+#endif
    for (;;) {
      _chacha_block(buf, st->input, st->rounds);
      if (st->ivlen == 8) {
@@ -21,8 +21,8 @@ int chacha_test(void)
 #ifndef LTC_TEST
    return CRYPT_NOP;
 #else
-   unsigned long len;
-   unsigned char out[1000];
+   unsigned long len, i;
+   unsigned char out[1000], out2[1000];
    /* https://tools.ietf.org/html/rfc7539#section-2.4.2 */
    unsigned char k[]  = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
                           0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f };
@@ -59,6 +59,18 @@ int chacha_test(void)
    if ((err = chacha_ivctr64(&st, n + 4, sizeof(n) - 4, 1)) != CRYPT_OK)                   return err;
    if ((err = chacha_crypt(&st, (unsigned char*)pt, len, out)) != CRYPT_OK)                return err;
    if (compare_testvector(out, len, ct, sizeof(ct), "CHACHA-TV3", 1))                      return CRYPT_FAIL_TESTVECTOR;
+   /* long runs go several blocks at a time, they must match 63 bytes at a time;
+    * the 64-bit counter starts just short of carrying into the upper word */
+   for (i = 0; i < sizeof(out); ++i) out[i] = (unsigned char)i;
+   if ((err = chacha_setup(&st, k, sizeof(k), 20)) != CRYPT_OK)                            return err;
+   if ((err = chacha_ivctr64(&st, n + 4, sizeof(n) - 4, CONST64(0xFFFFFFF9))) != CRYPT_OK)  return err;
+   if ((err = chacha_crypt(&st, out, sizeof(out), out2)) != CRYPT_OK)                      return err;
+   if ((err = chacha_setup(&st, k, sizeof(k), 20)) != CRYPT_OK)                            return err;
+   if ((err = chacha_ivctr64(&st, n + 4, sizeof(n) - 4, CONST64(0xFFFFFFF9))) != CRYPT_OK)  return err;
+   for (i = 0; i < sizeof(out); i += 63) {
+      if ((err = chacha_crypt(&st, out + i, MIN(63, sizeof(out) - i), out + i)) != CRYPT_OK) return err;
+   }
+   if (compare_testvector(out2, sizeof(out2), out, sizeof(out), "CHACHA-TV4", 1))          return CRYPT_FAIL_TESTVECTOR;
 
    return CRYPT_OK;
 #endif
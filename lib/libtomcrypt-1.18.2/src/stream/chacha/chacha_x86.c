@@ -0,0 +1,203 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+  @file chacha_x86.c
+  ChaCha keystream for 4 (SSSE3) or 8 (AVX2) consecutive blocks at once.
+  Word i of the block states is kept in one register, lane j belonging
+  to block j, so the rounds run on whole registers; the blocks are
+  transposed back into byte order at the end.
+*/
+
+#ifdef LTC_CHACHA
+
+#if defined(LTC_SSSE3) || defined(LTC_AVX2)
+#include "tomcrypt_x86.h"
+#endif
+
+#ifdef LTC_SSSE3
+
+#define ROL4(x, n) _mm_or_si128(_mm_slli_epi32((x), (n)), _mm_srli_epi32((x), 32 - (n)))
+
+#define QR4(a, b, c, d)                                                        \
+   do {                                                                        \
+      a = _mm_add_epi32(a, b); d = _mm_shuffle_epi8(_mm_xor_si128(d, a), r16);  \
+      c = _mm_add_epi32(c, d); b = ROL4(_mm_xor_si128(b, c), 12);              \
+      a = _mm_add_epi32(a, b); d = _mm_shuffle_epi8(_mm_xor_si128(d, a), r8);   \
+      c = _mm_add_epi32(c, d); b = ROL4(_mm_xor_si128(b, c), 7);               \
+   } while (0)
+
+/**
+  XOR 4 blocks of keystream into in with SSSE3, the CPU must support it
+  (crypt_cpu_has(LTC_CPU_SSSE3)). The block counter input[12] must not
+  wrap within the 4 blocks, the caller advances it.
+  @param input   The ChaCha state (st->input)
+  @param rounds  The number of rounds
+  @param in      256 bytes of plaintext (or ciphertext)
+  @param out     [out] 256 bytes of ciphertext (or plaintext)
+*/
+__attribute__((target("ssse3")))
+void chacha_ssse3_x4(const ulong32 *input, int rounds, const unsigned char *in, unsigned char *out)
+{
+   const __m128i r16 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+   const __m128i r8 = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+   __m128i x[16], s[16], t0, t1, t2, t3;
+   int i, k;
+
+   for (i = 0; i < 16; i++) {
+      s[i] = _mm_set1_epi32((int)input[i]);
+   }
+   s[12] = _mm_add_epi32(s[12], _mm_setr_epi32(0, 1, 2, 3));
+   for (i = 0; i < 16; i++) {
+      x[i] = s[i];
+   }
+
+   for (i = rounds; i > 0; i -= 2) {
+      QR4(x[0], x[4], x[8], x[12]);
+      QR4(x[1], x[5], x[9], x[13]);
+      QR4(x[2], x[6], x[10], x[14]);
+      QR4(x[3], x[7], x[11], x[15]);
+      QR4(x[0], x[5], x[10], x[15]);
+      QR4(x[1], x[6], x[11], x[12]);
+      QR4(x[2], x[7], x[8], x[13]);
+      QR4(x[3], x[4], x[9], x[14]);
+   }
+
+   /* words 4k..4k+3 of the 4 blocks, transposed to 16 bytes of each block */
+   for (k = 0; k < 16; k += 4) {
+      for (i = k; i < k + 4; i++) {
+         x[i] = _mm_add_epi32(x[i], s[i]);
+      }
+      t0 = _mm_unpacklo_epi32(x[k + 0], x[k + 1]);
+      t1 = _mm_unpacklo_epi32(x[k + 2], x[k + 3]);
+      t2 = _mm_unpackhi_epi32(x[k + 0], x[k + 1]);
+      t3 = _mm_unpackhi_epi32(x[k + 2], x[k + 3]);
+      x[k + 0] = _mm_unpacklo_epi64(t0, t1);
+      x[k + 1] = _mm_unpackhi_epi64(t0, t1);
+      x[k + 2] = _mm_unpacklo_epi64(t2, t3);
+      x[k + 3] = _mm_unpackhi_epi64(t2, t3);
+      for (i = 0; i < 4; i++) {
+         t0 = _mm_loadu_si128((const __m128i *)(const void *)(in + 64 * i + 4 * k));
+         _mm_storeu_si128((__m128i *)(void *)(out + 64 * i + 4 * k), _mm_xor_si128(t0, x[k + i]));
+      }
+   }
+}
+
+#undef QR4
+#undef ROL4
+
+#endif /* LTC_SSSE3 */
+
+#ifdef LTC_AVX2
+
+#define ROL8(x, n) _mm256_or_si256(_mm256_slli_epi32((x), (n)), _mm256_srli_epi32((x), 32 - (n)))
+
+#define QR8(a, b, c, d)                                                              \
+   do {                                                                              \
+      a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), r16);  \
+      c = _mm256_add_epi32(c, d); b = ROL8(_mm256_xor_si256(b, c), 12);                 \
+      a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), r8);   \
+      c = _mm256_add_epi32(c, d); b = ROL8(_mm256_xor_si256(b, c), 7);                  \
+   } while (0)
+
+/* the 8x8 32-bit transpose, r[i] lane j <-> r[j] lane i */
+__attribute__((target("avx2")))
+static LTC_INLINE void _transpose8(__m256i *r)
+{
+   __m256i t0, t1, t2, t3, t4, t5, t6, t7, u0, u1, u2, u3, u4, u5, u6, u7;
+
+   t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+   t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+   t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+   t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+   t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+   t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+   t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+   t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+   u0 = _mm256_unpacklo_epi64(t0, t2);
+   u1 = _mm256_unpackhi_epi64(t0, t2);
+   u2 = _mm256_unpacklo_epi64(t1, t3);
+   u3 = _mm256_unpackhi_epi64(t1, t3);
+   u4 = _mm256_unpacklo_epi64(t4, t6);
+   u5 = _mm256_unpackhi_epi64(t4, t6);
+   u6 = _mm256_unpacklo_epi64(t5, t7);
+   u7 = _mm256_unpackhi_epi64(t5, t7);
+   r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+   r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+   r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+   r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+   r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+   r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+   r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+   r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/**
+  XOR 8 blocks of keystream into in with AVX2, the CPU must support it
+  (crypt_cpu_has(LTC_CPU_AVX2)). The block counter input[12] must not
+  wrap within the 8 blocks, the caller advances it.
+  @param input   The ChaCha state (st->input)
+  @param rounds  The number of rounds
+  @param in      512 bytes of plaintext (or ciphertext)
+  @param out     [out] 512 bytes of ciphertext (or plaintext)
+*/
+__attribute__((target("avx2")))
+void chacha_avx2_x8(const ulong32 *input, int rounds, const unsigned char *in, unsigned char *out)
+{
+   const __m256i r16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                        2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+   const __m256i r8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                       3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+   __m256i x[16], t;
+   int i;
+
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm256_set1_epi32((int)input[i]);
+   }
+   x[12] = _mm256_add_epi32(x[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+   for (i = rounds; i > 0; i -= 2) {
+      QR8(x[0], x[4], x[8], x[12]);
+      QR8(x[1], x[5], x[9], x[13]);
+      QR8(x[2], x[6], x[10], x[14]);
+      QR8(x[3], x[7], x[11], x[15]);
+      QR8(x[0], x[5], x[10], x[15]);
+      QR8(x[1], x[6], x[11], x[12]);
+      QR8(x[2], x[7], x[8], x[13]);
+      QR8(x[3], x[4], x[9], x[14]);
+   }
+
+   for (i = 0; i < 16; i++) {
+      t = _mm256_set1_epi32((int)input[i]);
+      if (i == 12) t = _mm256_add_epi32(t, _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      x[i] = _mm256_add_epi32(x[i], t);
+   }
+
+   /* words 0-7 and 8-15, transposed to the two halves of each block */
+   _transpose8(x);
+   _transpose8(x + 8);
+   for (i = 0; i < 8; i++) {
+      t = _mm256_loadu_si256((const __m256i *)(const void *)(in + 64 * i));
+      _mm256_storeu_si256((__m256i *)(void *)(out + 64 * i), _mm256_xor_si256(t, x[i]));
+      t = _mm256_loadu_si256((const __m256i *)(const void *)(in + 64 * i + 32));
+      _mm256_storeu_si256((__m256i *)(void *)(out + 64 * i + 32), _mm256_xor_si256(t, x[i + 8]));
+   }
+}
+
+#undef QR8
+#undef ROL8
+
+#endif /* LTC_AVX2 */
+
+#endif /* LTC_CHACHA */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
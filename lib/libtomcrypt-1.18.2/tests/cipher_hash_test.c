@@ -10,6 +10,70 @@
 
 #include <tomcrypt_test.h>
 
+/* the names in the tables are found where the linear search found them */
+static int _find_name_test(void)
+{
+   struct ltc_hash_descriptor desc;
+   int x, y;
+
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (cipher_descriptor[x].name != NULL) {
+         y = find_cipher(cipher_descriptor[x].name);
+         if (y < 0 || y > x || XSTRCMP(cipher_descriptor[y].name, cipher_descriptor[x].name) != 0) {
+            fprintf(stderr, "find_cipher(%s) = %d\n", cipher_descriptor[x].name, y);
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+      if (hash_descriptor[x].name != NULL) {
+         y = find_hash(hash_descriptor[x].name);
+         if (y < 0 || y > x || XSTRCMP(hash_descriptor[y].name, hash_descriptor[x].name) != 0) {
+            fprintf(stderr, "find_hash(%s) = %d\n", hash_descriptor[x].name, y);
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+      if (prng_descriptor[x].name != NULL) {
+         y = find_prng(prng_descriptor[x].name);
+         if (y < 0 || y > x || XSTRCMP(prng_descriptor[y].name, prng_descriptor[x].name) != 0) {
+            fprintf(stderr, "find_prng(%s) = %d\n", prng_descriptor[x].name, y);
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+   if (find_cipher("no such cipher") != -1 || find_hash("") != -1 || find_prng("fortuna ") != -1) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* and the index follows the table when it changes */
+   if (hash_descriptor[0].name == NULL) {
+      return CRYPT_OK;
+   }
+   desc = hash_descriptor[0];
+   DO(unregister_hash(&desc));
+   if (find_hash(desc.name) == 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   x = register_hash(&desc);
+   if (x != 0 || find_hash(desc.name) != 0) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* a built-in comes back by name */
+#ifdef LTC_SHA256
+   DO(unregister_hash(&sha256_desc));
+   if (find_hash("sha256") != -1) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   x = find_hash_builtin("sha256");
+   if (x < 0 || hash_descriptor[x].ID != sha256_desc.ID || find_hash("sha256") != x) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+#endif
+   if (find_cipher_builtin("no such cipher") != -1 || find_hash_builtin("") != -1 || find_prng_builtin("fortuna ") != -1) {
+      return CRYPT_FAIL_TESTVECTOR;
+   }
+   return CRYPT_OK;
+}
+
 int cipher_hash_test(void)
 {
    int           x;
@@ -38,6 +102,8 @@ int cipher_hash_test(void)
    /* SHAKE128 + SHAKE256 tests are a bit special */
    DOX(sha3_shake_test(), "sha3_shake");
 
+   DO(_find_name_test());
+
    return 0;
 }
 
@@ -14,6 +14,8 @@ int modes_test(void)
    int ret = CRYPT_NOP;
 #ifdef LTC_CBC_MODE
    symmetric_CBC cbc;
+   unsigned char cbcpt[208], cbcbuf[208];
+   int (*cbc_dec)(const unsigned char *, unsigned char *, unsigned long, unsigned char *, symmetric_key *);
 #endif
 #ifdef LTC_CFB_MODE
    symmetric_CFB cfb;
@@ -67,6 +69,26 @@ int modes_test(void)
       fprintf(stderr, "CBC failed");
       return 1;
    }
+
+   /* without accel_cbc_decrypt, blocks are decrypted in batches
+    * through accel_ecb_decrypt: in place, over more than a batch and
+    * split in two calls */
+   if (cipher_descriptor[cipher_idx].accel_ecb_decrypt != NULL) {
+      yarrow_read(cbcpt, sizeof(cbcpt), &yarrow_prng);
+      DO(ret = cbc_start(cipher_idx, iv, key, 16, 0, &cbc));
+      DO(ret = cbc_encrypt(cbcpt, cbcbuf, sizeof(cbcbuf), &cbc));
+      DO(ret = cbc_setiv(iv, 16, &cbc));
+      cbc_dec = cipher_descriptor[cipher_idx].accel_cbc_decrypt;
+      cipher_descriptor[cipher_idx].accel_cbc_decrypt = NULL;
+      ret = cbc_decrypt(cbcbuf, cbcbuf, 144, &cbc);
+      if (ret == CRYPT_OK) ret = cbc_decrypt(cbcbuf + 144, cbcbuf + 144, sizeof(cbcbuf) - 144, &cbc);
+      cipher_descriptor[cipher_idx].accel_cbc_decrypt = cbc_dec;
+      DO(ret);
+      if (memcmp(cbcbuf, cbcpt, sizeof(cbcpt)) != 0) {
+         fprintf(stderr, "CBC (batched) failed");
+         return 1;
+      }
+   }
 #endif
 
 #ifdef LTC_CFB_MODE
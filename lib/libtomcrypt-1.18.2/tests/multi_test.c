@@ -41,6 +41,36 @@ int multi_test(void)
       return CRYPT_FAIL_TESTVECTOR;
    }
 
+   /* batches of messages of assorted lengths, against one at a time */
+   {
+      const char *names[] = { "sha256", "sha1", "sha3-256", "sha3-224" };
+      unsigned char msg[1000], dig[20][MAXBLOCKSIZE], *out[20];
+      const unsigned char *in[20];
+      unsigned long inlen[20];
+      int h, i;
+
+      register_hash(&sha1_desc);
+      register_hash(&sha3_256_desc);
+      register_hash(&sha3_224_desc);
+      for (i = 0; i < (int)sizeof(msg); i++) msg[i] = (unsigned char)(i * 7 + 1);
+      for (h = 0; h < 4; h++) {
+         for (i = 0; i < 20; i++) {
+            in[i] = msg + i;
+            inlen[i] = (i * i * 13) % 900;
+            out[i] = dig[i];
+         }
+         DO(hash_memory_batch(find_hash(names[h]), in, inlen, out, 20));
+         for (i = 0; i < 20; i++) {
+            len = sizeof(buf[0]);
+            DO(hash_memory(find_hash(names[h]), in[i], inlen[i], buf[0], &len));
+            if (memcmp(buf[0], dig[i], len)) {
+               printf("Failed: %d %s message %d\n", __LINE__, names[h], i);
+               return CRYPT_FAIL_TESTVECTOR;
+            }
+         }
+      }
+   }
+
 #ifdef LTC_HMAC
    len = sizeof(buf[0]);
    hmac_memory(find_hash("sha256"), key, 16, (unsigned char*)"hello", 5, buf[0], &len);
@@ -55,6 +55,19 @@ int prng_test(void)
    ltc_rng = previous;
 #endif
 
+   /* the system RNG, read in pieces smaller and larger than its buffer */
+   for (n = 1; n <= 1000; n = n * 3 + 1) {
+      if (rng_get_bytes(buf, n, NULL) != n) {
+         fprintf(stderr, "rng_get_bytes(%lu) failed\n", n);
+         exit(EXIT_FAILURE);
+      }
+   }
+   if (rng_get_bytes(buf, 16, NULL) != 16 || rng_get_bytes(buf + 16, 16, NULL) != 16 ||
+       XMEMCMP(buf, buf + 16, 16) == 0) {
+      fprintf(stderr, "rng_get_bytes returned the same bytes twice\n");
+      exit(EXIT_FAILURE);
+   }
+
    /* test prngs (test, import/export) */
    for (x = 0; prng_descriptor[x].name != NULL; x++) {
       if(strstr(prng_descriptor[x].name, "no_prng") == prng_descriptor[x].name) continue;
@@ -244,6 +244,9 @@ static void _unregister_all(void)
   unregister_hash(&blake2b_384_desc);
   unregister_hash(&blake2b_512_desc);
 #endif
+#ifdef LTC_BLAKE3
+  unregister_hash(&blake3_desc);
+#endif
 #ifdef LTC_CHC_HASH
   unregister_hash(&chc_desc);
 #endif
@@ -258,6 +261,9 @@ static void _unregister_all(void)
 #ifdef LTC_CHACHA20_PRNG
   unregister_prng(&chacha20_prng_desc);
 #endif
+#ifdef LTC_FKE_PRNG
+  unregister_prng(&fke_desc);
+#endif
 #ifdef LTC_SOBER128
   unregister_prng(&sober128_desc);
 #endif
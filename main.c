@@ -25,6 +25,11 @@
 #include "include/base64.h"
 #include "include/b64.h"
 #include "include/cipher.h"
+#include "include/hbatch.h"
+#include "include/htree.h"
+#include "include/hcheck.h"
+#include "include/hpar.h"
+#include "include/rgen.h"
 
 
 /*
@@ -33,6 +38,10 @@
 char *msg=NULL, *cipher=NULL, *fname=NULL;
 char *algo=NULL, *key=NULL, *outfile=NULL;
 int len=0;
+char **files=NULL;
+int nfiles=0;
+int cpus=1;
+krypt_opts kopts = { 0, 1, KRYPT_AUTO, 0, -1 };
 
 
 int main(int argc, char *argv[]) 
@@ -58,13 +67,16 @@ int main(int argc, char *argv[])
 	} /* At this point, we assume the text to hash or encrypt is already valid */
 
 
-	/* File to hash or encrypt */
+	/* File to hash or encrypt, -tf takes the ones after it as well */
 	if (isOptionGiven(argv, argc, "-f")) {
 		int pos = getParamPos(argv, argc, "-f");
 		fname=getSubParam(argv, pos);
 		if (! fname ) die(104, NULL);
-		if (! file_exist(fname)) die(111, fname);
 		if (strcmp(left(fname,1),"-") == 0) die(105, fname);
+
+		files = &argv[pos + 1];
+		for (nfiles = 1; files[nfiles] && files[nfiles][0] != '-'; nfiles++) ;
+		if (nfiles == 1 && ! file_exist(fname)) die(111, fname);
 	}
 
 
@@ -74,7 +86,9 @@ int main(int argc, char *argv[])
 		algo=getSubParam(argv, pos);
 		if ( ! algo ) die(112, NULL);
 		if (strcmp(left(algo,1),"-") == 0) die(113, algo);
-		if ( !isHashAlgoValid(algo) ) die(108, algo);
+
+		/* -td takes several algorithms, checked by hash_algo_list() */
+		if ( !isHashAlgoValid(algo) && ! (strchr(algo, ',') && isOptionGiven(argv, argc, "-td")) ) die(108, algo);
 	}
 
 
@@ -96,6 +110,62 @@ int main(int argc, char *argv[])
 	}
 
 
+	/* -chunk option as required */
+	if (isOptionGiven(argv, argc, "-chunk")) {
+		int pos = getParamPos(argv, argc, "-chunk");
+		char *ls = getSubParam(argv, pos);
+		long long n = strtosize(ls);
+		if (n <= 0 || n > MAX_CHUNK) die(145, ls);
+		kopts.chunk = (size_t) n;
+	}
+
+
+	/* one thread per cpu, up to as many as -j takes, unless -j */
+	/* says otherwise. -j 0 means one thread per cpu as well    */
+	cpus = numcpus();
+	if (cpus > PCTR_MAX_THREADS) cpus = PCTR_MAX_THREADS;
+	if (isOptionGiven(argv, argc, "-j")) {
+		int pos = getParamPos(argv, argc, "-j");
+		char *ls = getSubParam(argv, pos);
+		if (! isnum(ls) || strlen(ls) > 9) die(146, ls);
+		kopts.threads = atoi(ls);
+		if (kopts.threads > PCTR_MAX_THREADS) die(146, ls);
+		if (kopts.threads == 0) kopts.threads = cpus;
+	}
+
+
+	/* -m option, the format -e* encrypts to */
+	if (isOptionGiven(argv, argc, "-m")) {
+		int pos = getParamPos(argv, argc, "-m");
+		char *ls = getSubParam(argv, pos);
+		if (strcmp(ls, "gcm") == 0) kopts.aead = KSEAL_GCM;
+		else if (strcmp(ls, "chacha20poly1305") == 0) kopts.aead = KSEAL_CHACHA20POLY1305;
+		else if (strcmp(ls, "ctr") == 0) kopts.aead = KRYPT_CTR;
+		else die(155, ls);
+	}
+
+
+	/* --offset and --length, the part of the plaintext -d* gives */
+	if (isOptionGiven(argv, argc, "--offset") || isOptionGiven(argv, argc, "--length")) {
+		if (! isOptionGiven(argv, argc, "-ds") && ! isOptionGiven(argv, argc, "-df")) die(158, NULL);
+		if (isOptionGiven(argv, argc, "--offset")) {
+			char *ls = getSubParam(argv, getParamPos(argv, argc, "--offset"));
+			if ((kopts.offset = strtosize(ls)) < 0) die(157, ls);
+		}
+		if (isOptionGiven(argv, argc, "--length")) {
+			char *ls = getSubParam(argv, getParamPos(argv, argc, "--length"));
+			if ((kopts.length = strtosize(ls)) < 0) die(157, ls);
+		}
+	}
+
+
+	/* -o and --seed, where -r* writes to and what it is made from */
+	if (isOptionGiven(argv, argc, "-o") || isOptionGiven(argv, argc, "--seed")) {
+		if (! isOptionGiven(argv, argc, "-r") && ! isOptionGiven(argv, argc, "-ru") &&
+			! isOptionGiven(argv, argc, "-rk")) die(162, NULL);
+	}
+
+
 	/* -ts option */
 	if (isOptionGiven(argv, argc, "-ts")) {
 		
@@ -139,9 +209,11 @@ int main(int argc, char *argv[])
 	/* -tf option */
 	if (isOptionGiven(argv, argc, "-tf")) {
 
+		bool batch = nfiles > 1 || isOptionGiven(argv, argc, "--files-from");
+
 		/* Ensure that file really exists and accessible */
-		if (! fname) die(110, NULL);
-		if (! file_exist(fname)) die(111, fname);
+		if (! fname && ! batch) die(110, NULL);
+		if (! batch && ! file_exist(fname)) die(111, fname);
 
 		int pos = getParamPos(argv, argc, "-tf");
 		algo=getSubParam(argv, pos);
@@ -156,7 +228,34 @@ int main(int argc, char *argv[])
 		*  At this point, we assume the file to hash already valid
 		*  we should now proceed to check if the given algorithm is valid
 		*/
-		if ( !isHashAlgoValid(algo) ) die(108, algo);
+		if ( !isHashAlgoValid(algo) && ! strchr(algo, ',') ) die(108, algo);
+
+		/*
+		*  Many files, or several algorithms: hashed on a pool of threads,
+		*  a sha256sum style line each (a tagged line per algorithm)
+		*/
+		if (batch || strchr(algo, ',')) {
+			hash_algo ha[HASH_MAX_ALGOS];
+			int nha;
+			char **paths = (char **) malloc((nfiles + 1) * sizeof(char *));
+			size_t n = nfiles;
+			int failed;
+
+			if (nfiles) memcpy(paths, files, nfiles * sizeof(char *));
+			if (isOptionGiven(argv, argc, "--files-from")) {
+				pos = getParamPos(argv, argc, "--files-from");
+				paths = hbatch_list(getSubParam(argv, pos), isOptionGiven(argv, argc, "-0"), paths, &n);
+			}
+
+			nha = hash_algo_list(ha, algo, key, len);
+			failed = hbatch_run(ha, nha, paths, n, isOptionGiven(argv, argc, "-j") ? kopts.threads : cpus, stdout);
+			if (failed) {
+				char ls[24];
+				sprintf(ls, "%d", failed);
+				die(148, ls);
+			}
+			exit(EXIT_SUCCESS);
+		}
 
 		/* is this a SHAKE algorithm? */
 		if (strcmp(left(algo,6), "shake3") == 0) {
@@ -173,11 +272,68 @@ int main(int argc, char *argv[])
 		if (strcmp(algo, "crc32") == 0) die(EXIT_SUCCESS, crc32(true, fname));
 		if (strcmp(algo, "adler32") == 0) die(EXIT_SUCCESS, adler32(true, fname));
 
+		/* blake3 splits a big file into subtrees hashed on several threads */
+		if (strcmp(algo, "blake3") == 0) {
+			unsigned char digest[HPAR_OUTLEN];
+			int err;
+
+			err = hpar_file(fname, isOptionGiven(argv, argc, "-j") ? kopts.threads : cpus, digest);
+			if (err != CRYPT_OK) die(109, (char *) error_to_string(err));
+			die(EXIT_SUCCESS, bytox(digest, HPAR_OUTLEN));
+		}
+
 		/* Perform the non-SHAKE hash and exit */
 		die(EXIT_SUCCESS, hash(fname, algo, true, key)); 
 	}
 
 
+	/* -td option */
+	if (isOptionGiven(argv, argc, "-td")) {
+		hash_algo ha[HASH_MAX_ALGOS];
+		struct stat st;
+		int pos = getParamPos(argv, argc, "-td");
+		char *dir = getSubParam(argv, pos);
+		int failed;
+
+		if (stat(dir, &st) != 0 || ! S_ISDIR(st.st_mode)) die(149, dir);
+
+		/* The algorithm is given through -a, if not, default to sha3-256 */
+		if ( ! algo ) algo = DEFAULT_HASH;
+
+		failed = htree_run(ha, hash_algo_list(ha, algo, key, len), dir, isOptionGiven(argv, argc, "-j") ? kopts.threads : cpus, stdout);
+		if (failed) {
+			char ls[24];
+			sprintf(ls, "%d", failed);
+			die(148, ls);
+		}
+		exit(EXIT_SUCCESS);
+	}
+
+
+	/* --check option */
+	if (isOptionGiven(argv, argc, "--check")) {
+		hash_algo ha;
+		char *cache = NULL;
+		int pos = getParamPos(argv, argc, "--check");
+		char *manifest = getSubParam(argv, pos);
+		int failed;
+
+		if (isOptionGiven(argv, argc, "--cache")) cache = getSubParam(argv, getParamPos(argv, argc, "--cache"));
+
+		/* The algorithm is given through -a, if not, default to sha3-256 */
+		if ( ! algo ) algo = DEFAULT_HASH;
+		hash_algo_init(&ha, algo, key, len);
+
+		failed = hcheck_run(&ha, manifest, cache, isOptionGiven(argv, argc, "-j") ? kopts.threads : cpus, stdout);
+		if (failed) {
+			char ls[24];
+			sprintf(ls, "%d", failed);
+			die(150, ls);
+		}
+		exit(EXIT_SUCCESS);
+	}
+
+
 	/* -u option */
 	if (isOptionGiven(argv, argc, "-u") ) {
 
@@ -193,6 +349,51 @@ int main(int argc, char *argv[])
 	}
 
 
+	/* -r | -ru | -rk option */
+	if (isOptionGiven(argv, argc, "-r") || isOptionGiven(argv, argc, "-ru") || isOptionGiven(argv, argc, "-rk")) {
+		rgen_state rg;
+		FILE *fo = stdout;
+		char *seed = NULL, *ls, *op = "-r";
+		int kind = RGEN_BYTES, err;
+		long long n;
+
+		if (isOptionGiven(argv, argc, "-ru")) {
+			kind = RGEN_UUID;
+			op = "-ru";
+		}
+		if (isOptionGiven(argv, argc, "-rk")) {
+			kind = RGEN_KEY;
+			op = "-rk";
+		}
+
+		ls = getSubParam(argv, getParamPos(argv, argc, op));
+		if ((n = strtosize(ls)) < 0) die(159, ls);
+
+		if (kind == RGEN_KEY && len > RGEN_MAX_KEYLEN) {
+			char kl[24];
+			sprintf(kl, "%d", RGEN_MAX_KEYLEN);
+			die(160, kl);
+		}
+
+		if (isOptionGiven(argv, argc, "--seed")) seed = getSubParam(argv, getParamPos(argv, argc, "--seed"));
+		if (isOptionGiven(argv, argc, "-o")) {
+			outfile = getSubParam(argv, getParamPos(argv, argc, "-o"));
+			if ((fo = fopen(outfile, "wb")) == NULL) die(116, outfile);
+		}
+
+		err = rgen_start(&rg, kind, len ? len : RGEN_KEYLEN, seed, isOptionGiven(argv, argc, "-j") ? kopts.threads : cpus);
+		if (err != CRYPT_OK) die(161, (char *) error_to_string(err));
+
+		err = rgen_write(&rg, (ulong64) n, fo);
+		rgen_done(&rg);
+		if (err == CRYPT_ERROR) die(142, outfile ? outfile : "stdout");
+		if (err != CRYPT_OK) die(161, (char *) error_to_string(err));
+
+		if (fo != stdout && fclose(fo) != 0) die(142, outfile);
+		exit(EXIT_SUCCESS);
+	}
+
+
 	/* -be option */
 	if (isOptionGiven(argv, argc, "-be") ) {
 		int pos = getParamPos(argv, argc, "-be");
@@ -282,11 +483,11 @@ int main(int argc, char *argv[])
 		/* printf("OS: %s\n", get_platform_name()); */
 		if (!key || strlen(key)==0) key = getkey();
 
-		if (fname && outfile) die(EXIT_SUCCESS, krypt(true, true, fname, outfile, cipher, key, algo));
-		else if (fname) die(EXIT_SUCCESS, krypt(true, true, fname, NULL, cipher, key, algo));
+		if (fname && outfile) die(EXIT_SUCCESS, krypt(true, true, fname, outfile, cipher, key, algo, &kopts));
+		else if (fname) die(EXIT_SUCCESS, krypt(true, true, fname, NULL, cipher, key, algo, &kopts));
 		
-		if (msg && outfile) die(EXIT_SUCCESS, krypt(false, true, msg, outfile, cipher, key, algo));
-		else if (msg) die(EXIT_SUCCESS, krypt(false, true, msg, NULL, cipher, key, algo));
+		if (msg && outfile) die(EXIT_SUCCESS, krypt(false, true, msg, outfile, cipher, key, algo, &kopts));
+		else if (msg) die(EXIT_SUCCESS, krypt(false, true, msg, NULL, cipher, key, algo, &kopts));
 
 		die(127, NULL);
 	}
@@ -325,11 +526,11 @@ int main(int argc, char *argv[])
 
 		if (!key || strlen(key)==0) key = getkey();
 
-		if (fname && outfile) die(EXIT_SUCCESS, krypt(true, false, fname, outfile, cipher, key, algo));
-		else if (fname) die(EXIT_SUCCESS, krypt(true, false, fname, NULL, cipher, key, algo));
+		if (fname && outfile) die(EXIT_SUCCESS, krypt(true, false, fname, outfile, cipher, key, algo, &kopts));
+		else if (fname) die(EXIT_SUCCESS, krypt(true, false, fname, NULL, cipher, key, algo, &kopts));
 
-		if (msg && outfile) die(EXIT_SUCCESS, krypt(false, false, msg, outfile, cipher, key, algo));
-		else if (msg) die(EXIT_SUCCESS, krypt(false, false, msg, NULL, cipher, key, algo));
+		if (msg && outfile) die(EXIT_SUCCESS, krypt(false, false, msg, outfile, cipher, key, algo, &kopts));
+		else if (msg) die(EXIT_SUCCESS, krypt(false, false, msg, NULL, cipher, key, algo, &kopts));
 
 		die(127, NULL);
 	}
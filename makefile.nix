@@ -3,14 +3,18 @@ CFLAGS=-Wall -pedantic -O2 -Wl,-Bstatic
 ODIR=obj
 LDIR=lib
 
-LIBS=-ltomcrypt
+LIBS=-ltomcrypt -lpthread
 
-_DEPS = main.c cip.c nutsbox.c hash.c csiphash.c uuid4.c b64.c base64.c cipher.c
+_DEPS = main.c cip.c nutsbox.c hash.c csiphash.c uuid4.c b64.c base64.c cipher.c finput.c kpipe.c tpool.c pctr.c hbatch.c htree.c hcache.c hcheck.c hmulti.c hpar.c kseal.c rgen.c
 DEPS = $(patsubst %,./%,$(_DEPS))
 
-_OBJ = main.o cip.o nutsbox.o hash.o csiphash.o uuid4.o b64.o base64.o cipher.o
+_OBJ = main.o cip.o nutsbox.o hash.o csiphash.o uuid4.o b64.o base64.o cipher.o finput.o kpipe.o tpool.o pctr.o hbatch.o htree.o hcache.o hcheck.o hmulti.o hpar.o kseal.o rgen.o
 OBJ = $(patsubst %,$(ODIR)/%,$(_OBJ))
 
+## the benchmark links everything but main.o
+_BOBJ = $(filter-out main.o,$(_OBJ)) bench.o
+BOBJ = $(patsubst %,$(ODIR)/%,$(_BOBJ))
+
 
 $(ODIR)/%.o: %.c $(DEPS)
 	gcc -c -o $@ $<
@@ -18,7 +22,18 @@ $(ODIR)/%.o: %.c $(DEPS)
 cip: $(OBJ)
 	gcc -o $@ $^ $(CFLAGS) $(LIBS) -Wl,-Bdynamic
 
-.PHONY: clean
+cipbench: $(BOBJ)
+	gcc -o $@ $^ $(CFLAGS) $(LIBS) -Wl,-Bdynamic
+
+## checks of the cip executable
+check: cip
+	sh tests/check.sh ./cip
+
+## JSON throughput figures, see cipbench -h for BENCHFLAGS
+bench: cipbench
+	./cipbench $(BENCHFLAGS) > bench.json
+
+.PHONY: clean bench check
 
 clean:
-	rm -f $(ODIR)/*.o *~ core
+	rm -f $(ODIR)/*.o *~ core cipbench
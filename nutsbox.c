@@ -93,6 +93,67 @@ bool isnum(char *snum)
 }
 
 
+/*----------------------------------------------------------
+*  Function:    long long strtosize(char *s)
+*
+*  Description: Converts a size such as "512", "64K", "4M" or
+*               "10G" (an optional trailing "B" is allowed) into
+*               its number of bytes. Suffixes are powers of 1024.
+*
+*  Returns:     the number of bytes, -1 if s is not a size or
+*               it does not fit in a long long
+*
+*---------------------------------------------------------*/
+long long strtosize(char *s)
+{
+    long long n = 0;
+    int i, shift;
+
+    if (!s || !isdigit((unsigned char) s[0])) return -1;
+
+    for (i=0; isdigit((unsigned char) s[i]); i++) {
+        if (n > (LLONG_MAX - (s[i] - '0')) / 10) return -1;
+        n = n * 10 + (s[i] - '0');
+    }
+
+    switch (toupper((unsigned char) s[i])) {
+        case '\0': return n;
+        case 'K':  shift = 10; break;
+        case 'M':  shift = 20; break;
+        case 'G':  shift = 30; break;
+        case 'T':  shift = 40; break;
+        default:   return -1;
+    }
+
+    if (n > (LLONG_MAX >> shift)) return -1;
+    n <<= shift;
+
+    i++;
+    if (toupper((unsigned char) s[i]) == 'B') i++;
+
+    return (s[i] == '\0') ? n : -1;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    int numcpus(void)
+*
+*  Description: Gets the number of online processors
+*
+*  Returns:     the number of processors, 1 if unknown
+*
+*---------------------------------------------------------*/
+int numcpus(void)
+{
+#if defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int) n : 1;
+#else
+    return 1;
+#endif
+}
+
+
 /*----------------------------------------------------------
 *  Function:    gettime_ns()
 *
@@ -0,0 +1,241 @@
+/*-------------------------------------------------------------------
+*  rgen.c:         random data generation implementation file
+*
+*  Description:    Makes random bytes, uuid4s or hex keys from the
+*                  ChaCha20 keystream of one key, drawn from the
+*                  system or derived from a seed. Workers make
+*                  disjoint parts of the stream at once, the
+*                  calling thread writes them out in order.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/rgen.h"
+#include "include/uuid4.h"
+
+
+/*----------------------------------------------------------
+*  Function:    rgen_make()
+*
+*  Description: Makes the records of a worker: their random
+*               bytes, then their lines over them
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+static int rgen_make(rgen_worker *w)
+{
+	rgen_state *rg = w->rg;
+	static const char *hex = "0123456789abcdef";
+	ulong64 pos = w->first * rg->reclen;
+	unsigned long n = w->count * rg->reclen, i, j;
+	unsigned char skip[64], rec[RGEN_MAX_KEYLEN];
+	unsigned char *in, *out;
+	char uuid[UUID4_LEN];
+	int err;
+
+	if (w->count == 0) return CRYPT_OK;
+
+	/* the random bytes go at the end of the buffer, as no line is shorter */
+	in = w->out + w->count * rg->linelen - n;
+
+	if ((err = chacha_setup(&w->cs, rg->key, RGEN_SEEDLEN, 20)) != CRYPT_OK) return err;
+	if ((err = chacha_ivctr64(&w->cs, (const unsigned char *) "cip -r\0\0", 8, pos / 64)) != CRYPT_OK) return err;
+	if ((err = chacha_keystream(&w->cs, skip, (unsigned long) (pos % 64))) != CRYPT_OK) return err;
+	if ((err = chacha_keystream(&w->cs, in, n)) != CRYPT_OK) return err;
+
+	if (rg->kind == RGEN_BYTES) return CRYPT_OK;
+
+	/* line i never reaches the bytes of record i + 1 */
+	for (i = 0, out = w->out; i < w->count; i++, in += rg->reclen) {
+		memcpy(rec, in, rg->reclen);
+		if (rg->kind == RGEN_UUID) {
+			uuid4_format(rec, uuid);
+			memcpy(out, uuid, UUID4_LEN - 1);
+			out += UUID4_LEN - 1;
+		}
+		else {
+			for (j = 0; j < rg->reclen; j++) {
+				*out++ = hex[rec[j] >> 4];
+				*out++ = hex[rec[j] & 15];
+			}
+		}
+		*out++ = '\n';
+	}
+	zeromem(rec, sizeof(rec));
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    rgen_part()
+*
+*  Description: Makes the records of worker i, as a part of a
+*               tpool job
+*
+*---------------------------------------------------------*/
+static void rgen_part(void *ctx, int i)
+{
+	rgen_state *rg = (rgen_state *) ctx;
+
+	rg->worker[i].err = rgen_make(&rg->worker[i]);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    rgen_start()
+*
+*  Description: Sets up the generator and starts its workers
+*
+*  On Entry:    rg = the state to set up
+*               kind = RGEN_BYTES, RGEN_UUID or RGEN_KEY
+*               keylen = random bytes of a key (RGEN_KEY)
+*               seed = string the key of the stream is derived
+*                      from, NULL for one from the system RNG
+*               threads = number of workers. The calling thread
+*                         writes, then makes what they have not
+*                         taken yet, all of it if no worker could
+*                         be started
+*
+*  Returns:     CRYPT_OK if successful
+*
+*---------------------------------------------------------*/
+int rgen_start(rgen_state *rg, int kind, unsigned long keylen, const char *seed, int threads)
+{
+	unsigned long outlen = RGEN_SEEDLEN;
+	int i, err;
+
+	if (threads < 1) threads = 1;
+	if (kind == RGEN_KEY && (keylen < 1 || keylen > RGEN_MAX_KEYLEN)) return CRYPT_INVALID_ARG;
+
+	memset(rg, 0, sizeof(rgen_state));
+	rg->kind = kind;
+	rg->threads = threads;
+
+	switch (kind) {
+		case RGEN_UUID: rg->reclen = 16;     rg->linelen = UUID4_LEN;       break;
+		case RGEN_KEY:  rg->reclen = keylen; rg->linelen = 2 * keylen + 1;  break;
+		default:        rg->reclen = 1;      rg->linelen = 1;
+	}
+	rg->perworker = RGEN_SEGMENT / rg->linelen;
+
+	/* a seed gives the same output every time */
+	if (seed) {
+		err = hash_memory(find_hash_builtin("sha256"), (const unsigned char *) seed, strlen(seed), rg->key, &outlen);
+		if (err != CRYPT_OK) return err;
+	}
+	else if (rng_get_bytes(rg->key, RGEN_SEEDLEN, NULL) != RGEN_SEEDLEN) return CRYPT_ERROR_READPRNG;
+
+	rg->buf[0] = (unsigned char *) malloc((size_t) threads * rg->perworker * rg->linelen);
+	rg->buf[1] = (unsigned char *) malloc((size_t) threads * rg->perworker * rg->linelen);
+	rg->worker = (rgen_worker *) calloc(threads, sizeof(rgen_worker));
+	if (rg->buf[0] == NULL || rg->buf[1] == NULL || rg->worker == NULL ||
+		tpool_start(&rg->pool, threads) != CRYPT_OK) {
+		free(rg->buf[0]);
+		free(rg->buf[1]);
+		free(rg->worker);
+		zeromem(rg->key, sizeof(rg->key));
+		return CRYPT_MEM;
+	}
+
+	for (i = 0; i < threads; i++) rg->worker[i].rg = rg;
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    rgen_wait()
+*
+*  Description: Waits for the job the workers are on
+*
+*  Returns:     CRYPT_OK, otherwise the first error of a worker
+*
+*---------------------------------------------------------*/
+static int rgen_wait(rgen_state *rg)
+{
+	int i;
+
+	tpool_wait(&rg->pool);
+
+	for (i = 0; i < rg->threads; i++) {
+		if (rg->worker[i].err != CRYPT_OK) return rg->worker[i].err;
+	}
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    rgen_write()
+*
+*  Description: Writes count records to fo
+*
+*  Returns:     CRYPT_OK if successful, CRYPT_ERROR if fo
+*               could not be written, otherwise the error
+*               from ChaCha20
+*
+*---------------------------------------------------------*/
+int rgen_write(rgen_state *rg, ulong64 count, FILE *fo)
+{
+	ulong64 next = 0;
+	size_t len = 0, wlen;
+	int i, cur = 0, err;
+
+	while (next < count || len > 0) {
+
+		/* the workers make the next job in one buffer ... */
+		wlen = 0;
+		if (next < count) {
+			for (i = 0; i < rg->threads; i++) {
+				rgen_worker *w = &rg->worker[i];
+
+				w->out = rg->buf[cur] + wlen;
+				w->first = next;
+				w->count = (count - next < rg->perworker) ? (unsigned long) (count - next) : rg->perworker;
+				w->err = CRYPT_OK;
+				next += w->count;
+				wlen += w->count * rg->linelen;
+			}
+
+			tpool_post(&rg->pool, rg->threads, rgen_part, rg);
+		}
+
+		/* ... while the previous one is written from the other */
+		if (len > 0 && fwrite(rg->buf[cur ^ 1], 1, len, fo) != len) {
+			if (wlen > 0) rgen_wait(rg);
+			return CRYPT_ERROR;
+		}
+
+		if (wlen > 0 && (err = rgen_wait(rg)) != CRYPT_OK) return err;
+		len = wlen;
+		cur ^= 1;
+	}
+
+	return (fflush(fo) == 0) ? CRYPT_OK : CRYPT_ERROR;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    rgen_done()
+*
+*  Description: Stops the workers and wipes the state
+*
+*---------------------------------------------------------*/
+void rgen_done(rgen_state *rg)
+{
+	int i;
+
+	tpool_done(&rg->pool);
+	for (i = 0; i < rg->threads; i++) zeromem(&rg->worker[i].cs, sizeof(chacha_state));
+
+	free(rg->buf[0]);
+	free(rg->buf[1]);
+	free(rg->worker);
+	zeromem(rg->key, sizeof(rg->key));
+}
@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+#  check.sh:  checks of the cip executable, run by "make check"
+#
+#  usage:     sh tests/check.sh [path to cip]
+#
+
+CIP=${1:-./cip}
+case "$CIP" in /*) ;; *) CIP="$(pwd)/$CIP" ;; esac
+DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+failed=0
+
+fail() {
+	echo "FAILED: $1"
+	failed=$((failed + 1))
+}
+
+echo a > a
+echo b > b
+
+# --check reads the tagged lines of -tf a,b, keeping those of -a
+"$CIP" -tf md5,sha256 -f a b > tagged.txt || fail "-tf md5,sha256"
+"$CIP" --check tagged.txt -a sha256 > out.txt || fail "--check of a tagged manifest"
+[ "$(cat out.txt)" = "$(printf 'a: OK\nb: OK')" ] || fail "--check of a tagged manifest: output"
+"$CIP" --check tagged.txt -a md5 > /dev/null || fail "--check -a md5 of a tagged manifest"
+
+# a file changed since reports FAILED
+echo c > b
+"$CIP" --check tagged.txt -a sha256 > out.txt 2> /dev/null && fail "--check of a changed file"
+grep -q '^b: FAILED$' out.txt || fail "--check of a changed file: output"
+
+[ $failed -eq 0 ] && echo "all checks passed"
+exit $failed
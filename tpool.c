@@ -0,0 +1,173 @@
+/*-------------------------------------------------------------------
+*  tpool.c:        worker threads implementation file
+*
+*  Description:    The threads the parallel parts of cip run on.
+*                  A job is cut into parts that the workers, and
+*                  the thread waiting for the job, take one by
+*                  one. Workers that could not be started are
+*                  left out, so a job never waits for them.
+*
+*  Date Created:   17 October 2026
+*
+*  History:        - 17 Oct 2026 (Initial version)
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <tomcrypt.h>
+
+#include "include/tpool.h"
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_take()
+*
+*  Description: Does parts of the job until none are left to
+*               take. Called and returns with the lock held.
+*
+*---------------------------------------------------------*/
+static void tpool_take(tpool *tp)
+{
+	int i;
+
+	while (tp->next < tp->parts) {
+		i = tp->next++;
+		pthread_mutex_unlock(&tp->lock);
+
+		tp->fn(tp->ctx, i);
+
+		pthread_mutex_lock(&tp->lock);
+		if (--tp->pending == 0) pthread_cond_broadcast(&tp->cond);
+	}
+}
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_thread()
+*
+*  Description: Worker loop: waits for a job and takes parts
+*               of it
+*
+*---------------------------------------------------------*/
+static void *tpool_thread(void *arg)
+{
+	tpool *tp = (tpool *) arg;
+
+	pthread_mutex_lock(&tp->lock);
+	for (;;) {
+		while (tp->next >= tp->parts && ! tp->quit) pthread_cond_wait(&tp->cond, &tp->lock);
+		if (tp->quit) break;
+		tpool_take(tp);
+	}
+	pthread_mutex_unlock(&tp->lock);
+
+	return NULL;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_start()
+*
+*  Description: Starts up to threads workers. tp->threads is
+*               set to the number that could be started, which
+*               may be less (even 0) if the system runs out of
+*               threads.
+*
+*  Returns:     CRYPT_OK if successful, CRYPT_MEM if out of
+*               memory
+*
+*---------------------------------------------------------*/
+int tpool_start(tpool *tp, int threads)
+{
+	int i;
+
+	memset(tp, 0, sizeof(tpool));
+	if (threads < 0) threads = 0;
+
+	if (threads > 0 && (tp->tid = (pthread_t *) calloc(threads, sizeof(pthread_t))) == NULL) return CRYPT_MEM;
+
+	pthread_mutex_init(&tp->lock, NULL);
+	pthread_cond_init(&tp->cond, NULL);
+
+	for (i = 0; i < threads; i++) {
+		if (pthread_create(&tp->tid[i], NULL, tpool_thread, tp) != 0) break;
+	}
+	tp->threads = i;
+
+	return CRYPT_OK;
+}
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_post()
+*
+*  Description: Hands out a job of parts parts, fn being called
+*               once for each, and returns at once. A job must
+*               be waited for before the next is posted.
+*
+*---------------------------------------------------------*/
+void tpool_post(tpool *tp, int parts, tpool_fn fn, void *ctx)
+{
+	pthread_mutex_lock(&tp->lock);
+	tp->fn = fn;
+	tp->ctx = ctx;
+	tp->parts = parts;
+	tp->next = 0;
+	tp->pending = parts;
+	pthread_cond_broadcast(&tp->cond);
+	pthread_mutex_unlock(&tp->lock);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_wait()
+*
+*  Description: Takes the parts of the posted job no worker
+*               has taken yet, then waits for the rest
+*
+*---------------------------------------------------------*/
+void tpool_wait(tpool *tp)
+{
+	pthread_mutex_lock(&tp->lock);
+	tpool_take(tp);
+	while (tp->pending > 0) pthread_cond_wait(&tp->cond, &tp->lock);
+	pthread_mutex_unlock(&tp->lock);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_run()
+*
+*  Description: Does a job on the workers and the calling
+*               thread, returning once every part is done
+*
+*---------------------------------------------------------*/
+void tpool_run(tpool *tp, int parts, tpool_fn fn, void *ctx)
+{
+	tpool_post(tp, parts, fn, ctx);
+	tpool_wait(tp);
+}
+
+
+/*----------------------------------------------------------
+*  Function:    tpool_done()
+*
+*  Description: Stops the workers
+*
+*---------------------------------------------------------*/
+void tpool_done(tpool *tp)
+{
+	int i;
+
+	pthread_mutex_lock(&tp->lock);
+	tp->quit = true;
+	pthread_cond_broadcast(&tp->cond);
+	pthread_mutex_unlock(&tp->lock);
+
+	for (i = 0; i < tp->threads; i++) pthread_join(tp->tid[i], NULL);
+
+	free(tp->tid);
+	tp->tid = NULL;
+	pthread_cond_destroy(&tp->cond);
+	pthread_mutex_destroy(&tp->lock);
+}
@@ -9,11 +9,6 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#if defined(_WIN32)
-#include <windows.h>
-#include <wincrypt.h>
-#endif
-
 #include "include/uuid4.h"
 #include "include/hash.h"
 
@@ -33,54 +28,37 @@ static uint64_t xorshift128plus(uint64_t *s) {
 
 
 int uuid4_init(void) {
-#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-  int res;
-  FILE *fp = fopen("/dev/urandom", "rb");
-  if (!fp) {
-    return UUID4_EFAILURE;
-  }
-  res = fread(seed, 1, sizeof(seed), fp);
-  fclose(fp);
-  if ( res != sizeof(seed) ) {
-    return UUID4_EFAILURE;
-  }
-
-#elif defined(_WIN32)
-  int res;
-  HCRYPTPROV hCryptProv;
-  res = CryptAcquireContext(
-    &hCryptProv, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT);
-  if (!res) {
+  /* the system RNG of libtomcrypt: getrandom(2) where there is one,
+     else /dev/urandom or the Windows CSP */
+  if (rng_get_bytes((unsigned char *) seed, sizeof(seed), NULL) != sizeof(seed)) {
     return UUID4_EFAILURE;
   }
-  res = CryptGenRandom(hCryptProv, (DWORD) sizeof(seed), (PBYTE) seed);
-  CryptReleaseContext(hCryptProv, 0);
-  if (!res) {
-    return UUID4_EFAILURE;
-  }
-
-#else
-  #error "unsupported platform"
-#endif
   return UUID4_ESUCCESS;
 }
 
 
 void uuid4_generate(char *dst) {
-  static const char *template = "xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx";
-  static const char *chars = "0123456789abcdef";
   union { unsigned char b[16]; uint64_t word[2]; } s;
-  const char *p;
-  int i, n;
   /* get random */
   s.word[0] = xorshift128plus(seed);
   s.word[1] = xorshift128plus(seed);
 
+  uuid4_format(s.b, dst);
+}
+
+
+/* the version 4 uuid of 16 random bytes, as 36 characters and a NUL */
+void uuid4_format(const unsigned char *b, char *dst) {
+  static const char *template = "xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx";
+  static const char *chars = "0123456789abcdef";
+  const char *p;
+  int i, n;
+
   /* build string */
   p = template;
   i = 0;
   while (*p) {
-    n = s.b[i >> 1];
+    n = b[i >> 1];
     n = (i & 1) ? (n >> 4) : (n & 0xf);
     switch (*p) {
       case 'x'  : *dst = chars[n];              i++;  break;